@@ -5,6 +5,7 @@
 #include "utilities/csv.h"
 
 #include <map>
+#include <deque>
 #include <string>
 #include <vector>
 #include <utility>
@@ -20,13 +21,31 @@ class MarketDepth: public data::MarketDepth
         AP1, AP2, AP3, AP4, AP5,
         AV1, AV2, AV3, AV4, AV5,
         BP1, BP2, BP3, BP4, BP5,
-        BV1, BV2, BV3, BV4, BV5
+        BV1, BV2, BV3, BV4, BV5,
+        REPEATS     // Only in compacted files (see CompactCSV)
     };
 
     private:
         CSV csv_;
         vector<string> row_;
 
+        // The last snapshot read, so that rows repeating it need no parsing,
+        // and the times of the repeats merged into it by CompactCSV:
+        vector<string> last_row_;
+        MarketDepthRecord last_record_;
+        std::deque<long> repeats_;
+
+        bool _IsRepeat();
+        void _ParseRepeats();
+
+        string path_;
+
+        // Session files still to come; the next one is already open:
+        CSV next_csv_;
+        string next_path_;
+        std::deque<string> queue_;
+        bool switched_ = false;
+
         bool _LoadRow();
         bool _ParseRow();
 
@@ -42,8 +61,22 @@ class MarketDepth: public data::MarketDepth
 
         void Reset();
         void SkipN(long n = 1L);
+
+        bool Save(std::ostream& os);
+        void Load(std::istream& is);
+
+        void QueueFile(string path);
+        bool NextFile();
+
+        bool SeekTime(long time);
 };
 
+// Offline no-op compaction of a market depth file: each run of rows with the
+// same snapshot is written once, with the times of the rest in an extra
+// column (ns since the previous row, ';' separated). MarketDepth expands them
+// on load, so the replay is unchanged. Returns the number of rows written.
+long CompactCSV(const string& in_path, const string& out_path);
+
 class TimeAndSales: public data::TimeAndSales
 {
     enum Columns
@@ -55,6 +88,14 @@ class TimeAndSales: public data::TimeAndSales
         CSV csv_;
         vector<string> row_;
 
+        string path_;
+
+        // Session files still to come; the next one is already open:
+        CSV next_csv_;
+        string next_path_;
+        std::deque<string> queue_;
+        bool switched_ = false;
+
         bool _LoadRow();
         bool _ParseRow();
 
@@ -70,6 +111,14 @@ class TimeAndSales: public data::TimeAndSales
 
         void Reset();
         void SkipN(long n = 1L);
+
+        bool Save(std::ostream& os);
+        void Load(std::istream& is);
+
+        void QueueFile(string path);
+        bool NextFile();
+
+        bool SeekTime(long time);
 };
 
 }
@@ -0,0 +1,64 @@
+#ifndef DATA_DOWNSAMPLED_H
+#define DATA_DOWNSAMPLED_H
+
+#include "data/streamer.h"
+#include "data/records.h"
+
+#include <string>
+#include <ostream>
+#include <utility>
+#include <type_traits>
+
+namespace data
+{
+
+// Aggregation rules for the records of a time bucket:
+void merge(MarketDepthRecord& into, const MarketDepthRecord& rec);
+void merge(TimeAndSalesRecord& into, const TimeAndSalesRecord& rec);
+
+// Streamer adaptor replaying a source streamer S in fixed time buckets: one
+// record per bucket, stamped with the bucket's end time and holding the last
+// book snapshot (market depth) or the summed volume per price (time and
+// sales) seen within it. Anything that runs on S runs unchanged on the
+// coarser stream.
+template<class S>
+class Downsampled:
+    public std::conditional<std::is_base_of<data::MarketDepth, S>::value,
+                            data::MarketDepth, data::TimeAndSales>::type
+{
+    typedef typename std::conditional<
+        std::is_base_of<data::MarketDepth, S>::value,
+        data::MarketDepth, data::TimeAndSales>::type Interface;
+
+    private:
+        S source_;
+        long resolution_;
+
+        long _BucketEnd(long time);
+
+    protected:
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        Downsampled(long resolution = 1000);
+
+        void SetResolution(long ms);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        // Positions within a bucket are not tracked, so they can't be saved:
+        bool Save(std::ostream& os);
+
+        void QueueFile(std::string path);
+        bool NextFile();
+
+        bool SeekTime(long time);
+};
+
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef DATA_ITCH_H
+#define DATA_ITCH_H
+
+#include "data/streamer.h"
+#include "utilities/mapped_file.h"
+
+#include <map>
+#include <deque>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <functional>
+#include <unordered_map>
+
+namespace data {
+namespace itch {
+
+// Market-by-order binary feeds (ITCH 5.0 layout). Archived files hold one
+// message after another, each preceded by its length (2 bytes); all fields
+// are big-endian and prices are in units of 1e-4. Timestamps are ns since
+// midnight, and the date is taken from the file name (as in md_20170103.itch).
+#pragma pack(push, 1)
+struct Header
+{
+    char type;
+    uint16_t locate;
+    uint16_t tracking;
+    uint8_t timestamp[6];
+};
+
+struct StockDirectory       // 'R' (only the fields we use)
+{
+    Header header;
+    char stock[8];
+};
+
+struct AddOrder             // 'A', and 'F' with a trailing attribution
+{
+    Header header;
+    uint64_t ref;
+    char side;
+    uint32_t shares;
+    char stock[8];
+    uint32_t price;
+};
+
+struct OrderExecuted        // 'E'
+{
+    Header header;
+    uint64_t ref;
+    uint32_t shares;
+    uint64_t match;
+};
+
+struct OrderExecutedWithPrice   // 'C'
+{
+    OrderExecuted executed;
+    char printable;
+    uint32_t price;
+};
+
+struct OrderCancel          // 'X'
+{
+    Header header;
+    uint64_t ref;
+    uint32_t shares;
+};
+
+struct OrderDelete          // 'D'
+{
+    Header header;
+    uint64_t ref;
+};
+
+struct OrderReplace         // 'U'
+{
+    Header header;
+    uint64_t ref;
+    uint64_t new_ref;
+    uint32_t shares;
+    uint32_t price;
+};
+
+struct Trade                // 'P', executions against hidden orders
+{
+    Header header;
+    uint64_t ref;
+    char side;
+    uint32_t shares;
+    char stock[8];
+    uint32_t price;
+    uint64_t match;
+};
+#pragma pack(pop)
+
+// A decoded message of the symbol we follow:
+struct OrderEvent
+{
+    enum Type: char
+    {
+        ADD = 'A',
+        EXECUTE = 'E',      // price is only set if it isn't the order's
+        CANCEL = 'X',
+        DELETE = 'D',
+        REPLACE = 'U',
+        TRADE = 'P'
+    };
+
+    char type;
+    long time;          // ns since midnight
+
+    uint64_t ref;
+    uint64_t new_ref;
+
+    char side;
+    long shares;
+    uint32_t price;
+
+    bool printable;
+};
+
+inline double to_price(uint32_t price)
+{
+    // Float precision, as the basic streamers read prices:
+    return (float) (price / 10000.0);
+}
+
+// Scans the messages of a memory mapped file in place, through packed views
+// of the wire format; messages of other symbols are skipped by their locate
+// code without being decoded:
+class Reader
+{
+    private:
+        MappedFile file_;
+        size_t pos_ = 0;
+
+        char stock_[8];
+        int locate_ = -1;
+
+    public:
+        // The symbol is matched against the stock field of the file, up to
+        // any venue suffix (HSBA.L => "HSBA    "):
+        void Open(const std::string& path, const std::string& symbol);
+        void Close();
+
+        bool IsOpen() const;
+
+        // The next message of the symbol; false at the end of the file:
+        bool Next(OrderEvent& ev);
+
+        size_t Tell() const;
+        void Seek(size_t pos);
+
+        bool Save(std::ostream& os) const;
+        void Load(std::istream& is);
+};
+
+// Volume traded by an event (0 if none) and its price:
+struct Fill
+{
+    uint32_t price;
+    long shares;
+};
+
+// The orders resting on each side, and the volume at each price:
+class OrderBook
+{
+    public:
+        struct Order
+        {
+            char side;
+            uint32_t price;
+            long shares;
+        };
+
+        static const int DEPTH = 5;
+
+    private:
+        std::unordered_map<uint64_t, Order> orders_;
+
+        std::map<uint32_t, long, std::greater<uint32_t>> bids_;
+        std::map<uint32_t, long> asks_;
+
+        void _Add(uint64_t ref, const Order& o);
+        void _Reduce(std::unordered_map<uint64_t, Order>::iterator it,
+                     long shares);
+
+        bool _IsVisible(char side, uint32_t price) const;
+
+    public:
+        // Applies an event to the book; true if the top DEPTH levels may
+        // have changed:
+        bool Apply(const OrderEvent& ev, Fill& fill);
+
+        // The top DEPTH levels; false unless both sides have all of them:
+        bool Snapshot(MarketDepthRecord& rec) const;
+
+        void Clear();
+
+        void Save(std::ostream& os) const;
+        void Load(std::istream& is);
+};
+
+// The price and remaining shares of each resting order, which is all it
+// takes to price executions (no price levels are kept):
+class OrderPrices
+{
+    public:
+        struct Order
+        {
+            uint32_t price;
+            long shares;
+        };
+
+    private:
+        std::unordered_map<uint64_t, Order> orders_;
+
+    public:
+        // Applies an event, filling in the volume it traded:
+        void Apply(const OrderEvent& ev, Fill& fill);
+
+        void Clear();
+
+        void Save(std::ostream& os) const;
+        void Load(std::istream& is);
+};
+
+class MarketDepth: public data::MarketDepth
+{
+    private:
+        Reader reader_;
+        OrderBook orders_;
+
+        // The first event not yet applied:
+        OrderEvent next_;
+        bool has_next_ = false;
+
+        // The book after all events applied so far, and whether it is yet to
+        // be streamed:
+        MarketDepthRecord book_;
+        bool pending_ = false;
+
+        std::deque<std::string> queue_;
+        bool switched_ = false;
+
+        int date_ = 0;
+
+        void _Open(const std::string& path);
+        bool _Peek();
+
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        MarketDepth();
+        MarketDepth(std::string file_path);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        bool Save(std::ostream& os);
+        void Load(std::istream& is);
+
+        void QueueFile(std::string path);
+        bool NextFile();
+};
+
+class TimeAndSales: public data::TimeAndSales
+{
+    private:
+        Reader reader_;
+        OrderPrices orders_;
+
+        // The next fill, if it has been read but not yet streamed:
+        Fill fill_;
+        long time_ = 0;
+        bool pending_ = false;
+
+        std::deque<std::string> queue_;
+        bool switched_ = false;
+
+        int date_ = 0;
+
+        void _Open(const std::string& path);
+        bool _Peek();
+
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        TimeAndSales();
+        TimeAndSales(std::string file_path);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        bool Save(std::ostream& os);
+        void Load(std::istream& is);
+
+        void QueueFile(std::string path);
+        bool NextFile();
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef DATA_LIVE_H
+#define DATA_LIVE_H
+
+#include "data/streamer.h"
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <ostream>
+#include <vector>
+#include <cstdint>
+
+namespace data {
+namespace live {
+
+// Framed records on a local stream (a UNIX domain socket or a FIFO), in host
+// byte order: the length of the rest of the frame (4 bytes), then the header
+// below and its body. Depth frames carry the five levels of each side (ask
+// prices, ask volumes, bid prices, bid volumes), trade frames one (price,
+// size) pair per price traded at that time.
+//
+// Publishers send the trades of a time before its depth update, so a depth
+// frame implies that every earlier trade has been received.
+#pragma pack(push, 1)
+struct FrameHeader
+{
+    char type;          // 'D'epth, 'T'rades or 'E'nd of stream
+    int32_t date;
+    int64_t time;
+};
+#pragma pack(pop)
+
+// The connection to a feed, shared by the streamers reading from it:
+class Feed
+{
+    public:
+        template<typename R>
+        struct Arrival
+        {
+            R record;
+            long arrival;   // steady clock, ns
+        };
+
+    private:
+        int fd_ = -1;
+        bool ended_ = false;
+
+        std::vector<char> buffer_;
+
+        std::deque<Arrival<MarketDepthRecord>> depth_;
+        std::deque<Arrival<TimeAndSalesRecord>> trades_;
+
+        // The latest frame received, and the latest handed to a streamer:
+        int last_date_ = 0;
+        long last_time_ = 0;
+        long last_arrival_ = 0;
+
+        long max_lag_ = 0;
+
+        long n_frames_ = 0;
+        long n_conflated_ = 0;
+
+        static std::mutex registry_mutex_;
+        static std::map<std::string, std::weak_ptr<Feed>> registry_;
+
+        void _Parse(long now);
+
+    public:
+        Feed(const std::string& path);
+        ~Feed();
+
+        Feed(const Feed&) = delete;
+        Feed& operator=(const Feed&) = delete;
+
+        // The open feed at a path, connecting to it if needed:
+        static std::shared_ptr<Feed> Get(const std::string& path);
+
+        // Reads what has arrived, first waiting for at least one frame if
+        // block is set; false once the stream has ended:
+        bool Poll(bool block);
+
+        std::deque<Arrival<MarketDepthRecord>>& Depth();
+        std::deque<Arrival<TimeAndSalesRecord>>& Trades();
+
+        // Depth updates that have waited longer than this are conflated
+        // into the latest one (0: never):
+        void SetMaxLag(long ms);
+        void Conflate();
+
+        // Drops the queued records of days before the date:
+        void DiscardBefore(int date);
+
+        void MarkDelivered(long arrival);
+
+        int LastDate() const;
+        long LastTime() const;
+        long LastArrival() const;
+
+        long Frames() const;
+        long Conflated() const;
+};
+
+// Replays records to a feed; creates and listens on a UNIX domain socket at
+// the path unless it is a FIFO, and waits for the reader to connect:
+class Publisher
+{
+    private:
+        int fd_ = -1;
+        bool socket_ = false;
+
+        std::string path_;
+
+        void _Write(const std::vector<char>& frame);
+
+    public:
+        Publisher(const std::string& path);
+        ~Publisher();
+
+        Publisher(const Publisher&) = delete;
+        Publisher& operator=(const Publisher&) = delete;
+
+        void Send(const MarketDepthRecord& rec);
+        void Send(const TimeAndSalesRecord& rec);
+        void End();
+};
+
+long steady_ns();
+
+// Streamers over a feed. Like a file, each streams a single day: the first
+// record of another day ends the stream, and the next episode on the feed
+// starts from the latest day received. The record each of them has looked
+// ahead to stays at the front of the feed's queue until it is consumed:
+class MarketDepth: public data::MarketDepth
+{
+    private:
+        std::shared_ptr<Feed> feed_;
+        bool held_ = false;
+
+        int date_ = 0;
+
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        MarketDepth();
+        MarketDepth(std::string path);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        // A live feed cannot be rewound to a saved position:
+        bool Save(std::ostream& os);
+};
+
+class TimeAndSales: public data::TimeAndSales
+{
+    private:
+        std::shared_ptr<Feed> feed_;
+        bool held_ = false;
+
+        int date_ = 0;
+
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        TimeAndSales();
+        TimeAndSales(std::string path);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        // A live feed cannot be rewound to a saved position:
+        bool Save(std::ostream& os);
+};
+
+}
+}
+
+#endif
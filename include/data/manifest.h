@@ -0,0 +1,79 @@
+#ifndef DATA_MANIFEST_H
+#define DATA_MANIFEST_H
+
+#include <tuple>
+#include <string>
+#include <vector>
+
+namespace data
+{
+
+// One day of one symbol. Row counts exclude headers (ITCH files count
+// messages); the open and close offsets are those of the first market depth
+// row at or after the market's opening and closing times, and are only known
+// for basic csv files (-1 otherwise):
+struct ManifestEntry
+{
+    std::string symbol;
+    int date;
+
+    std::string md_path;
+    std::string tas_path;
+
+    long md_bytes, tas_bytes;
+    long md_mtime, tas_mtime;
+
+    long md_rows, tas_rows;
+
+    long open_offset, close_offset;
+};
+
+// Persistent index of the data files of a universe of symbols, so that a run
+// can pick its samples without listing and reading every directory. Entries
+// are kept sorted by (symbol, date), which is also the order of the samples
+// found by get_file_sample.
+class Manifest
+{
+    private:
+        std::vector<ManifestEntry> entries_;
+
+        static ManifestEntry _Scan(ManifestEntry e, const std::string& format);
+
+    public:
+        // False (and empty) if there is no manifest at the path or it was
+        // written by another version:
+        bool Load(const std::string& path);
+        void Save(const std::string& path) const;
+
+        // Adds the days of the symbols found in the data directories and
+        // drops those that have gone. Only new or modified (by size or mtime)
+        // files are scanned, by up to n_threads threads; returns how many
+        // days were scanned:
+        long Update(const std::string& md_dir, const std::string& tas_dir,
+                    const std::vector<std::string>& symbols,
+                    const std::string& format, int n_threads = 1);
+
+        bool Contains(const std::string& symbol) const;
+
+        // The days of the symbols (in the order given) with market depth
+        // rows:
+        std::vector<ManifestEntry> Select(
+            const std::vector<std::string>& symbols) const;
+
+        const std::vector<ManifestEntry>& Entries() const;
+};
+
+// Holds out n days for testing, latest first, each time from the symbol with
+// the fewest rows held out so far; the rest are for training. Both keep the
+// order of the entries:
+void split_balanced(const std::vector<ManifestEntry>& entries, size_t n,
+                    std::vector<ManifestEntry>& train,
+                    std::vector<ManifestEntry>& test);
+
+// As get_file_sample, from manifest entries:
+std::vector<std::tuple<std::string, std::string, std::string>> to_samples(
+    const std::vector<ManifestEntry>& entries);
+
+}
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <map>
 #include <array>
+#include <istream>
+#include <ostream>
 
 #include "utilities/comparison.h"
 
@@ -11,10 +13,13 @@ namespace data
 
 struct Record
 {
-    int date;
-    long time;
+    int date;       // yyyymmdd
+    long time;      // ns since midnight (see utilities/time.h)
 
     void clear();
+
+    void save(std::ostream& os) const;
+    void load(std::istream& is);
 };
 
 struct MarketDepthRecord: Record
@@ -26,6 +31,9 @@ struct MarketDepthRecord: Record
     std::array<long, 5> bid_volumes;
 
     void clear();
+
+    void save(std::ostream& os) const;
+    void load(std::istream& is);
 };
 
 struct TimeAndSalesRecord: Record
@@ -35,6 +43,9 @@ struct TimeAndSalesRecord: Record
     double mean_price() const;
 
     void clear();
+
+    void save(std::ostream& os) const;
+    void load(std::istream& is);
 };
 
 }
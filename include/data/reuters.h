@@ -1,98 +1,169 @@
-// #ifndef DATA_REUTERS_H
-// #define DATA_REUTERS_H
-
-// #include "data/streamer.h"
-// #include "utilities/csv.h"
-
-// #include <map>
-// #include <string>
-// #include <vector>
-// #include <utility>
-
-// namespace data {
-// namespace reuters {
-
-// class MarketDepth: public data::MarketDepth
-// {
-    // enum Columns
-    // {
-        // RIC = 0,
-        // DATE = 1,
-        // TIME = 2,
-        // GMT_OFFSET = 3,
-        // TYPE = 4,
-        // FID_ID = 5,
-        // MSG_TYPE = 6,
-        // FID_NAME = 7,
-        // FID_VAL = 8,
-        // FID_ENUM = 9,
-        // PE_CODE = 10,
-        // TEMPLATE_ID = 11,
-        // RTL = 12,
-        // SEQUENCE_ID = 13,
-        // RIC_SRC = 14,
-        // N_FIDS = 15
-    // };
-
-    // private:
-        // CSV csv;
-
-        // void parseFids(int n_fids);
-
-    // public:
-        // MarketDepth();
-        // MarketDepth(string file_path);
-
-        // void load(string path);
-
-        // bool next();
-
-        // long peekTime();
-        // string peekDate();
-// };
-
-// class TimeAndSales: public data::TimeAndSales
-// {
-    // enum Columns
-    // {
-        // RIC = 0,
-        // DATE = 1,
-        // TIME = 2,
-        // GMT_OFFSET = 3,
-        // TYPE = 4,
-        // FID_ID = 5,
-        // MSG_TYPE = 6,
-        // FID_NAME = 7,
-        // FID_VAL = 8,
-        // FID_ENUM = 9,
-        // PE_CODE = 10,
-        // TEMPLATE_ID = 11,
-        // RTL = 12,
-        // SEQUENCE_ID = 13,
-        // RIC_SRC = 14,
-        // N_FIDS = 15
-    // };
-
-    // private:
-        // CSV csv;
-
-        // void parseFids(int n_fids);
-
-    // public:
-        // TimeAndSales();
-        // TimeAndSales(string file_path);
-
-        // void load(string path);
-
-        // bool next();
-        // bool next(string to_date, long to_time);
-        // bool skip(string to_date, long to_time);
-
-        // long peekTime();
-        // string peekDate();
-// };
-
-// }
-// }
-
-// #endif
+#ifndef DATA_REUTERS_H
+#define DATA_REUTERS_H
+
+#include "data/streamer.h"
+#include "utilities/mapped_file.h"
+
+#include <array>
+#include <deque>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace data {
+namespace reuters {
+
+// Reuters tick history raw exports: each message is a header row (TYPE "Raw")
+// with its local date/time and number of FIDs, followed by one row per FID
+// (TYPE "FID") with its name and value. Updates only carry the FIDs that
+// changed.
+enum Columns
+{
+    RIC = 0,
+    DATE = 1,
+    TIME = 2,
+    GMT_OFFSET = 3,
+    TYPE = 4,
+    FID_ID = 5,
+    MSG_TYPE = 6,
+    FID_NAME = 7,
+    FID_VAL = 8,
+    FID_ENUM = 9,
+    PE_CODE = 10,
+    TEMPLATE_ID = 11,
+    RTL = 12,
+    SEQUENCE_ID = 13,
+    RIC_SRC = 14,
+    N_FIDS = 15,
+
+    N_COLUMNS = 16
+};
+
+// The FIDs we track, as offsets into Message::values (levels are
+// consecutive, e.g. BEST_ASK3 is ASK_PRICE + 2):
+enum Fid
+{
+    ASK_PRICE = 0,      // BEST_ASK1..5
+    ASK_SIZE = 5,       // BEST_ASIZ1..5
+    BID_PRICE = 10,     // BEST_BID1..5
+    BID_SIZE = 15,      // BEST_BSIZ1..5
+    TRADE_PRICE = 20,   // TRDPRC_1
+    TRADE_VOLUME = 21,  // TRDVOL_1
+
+    N_TRACKED = 22
+};
+
+// Offset of a FID name, or -1 if it isn't tracked. The table is resolved at
+// compile time (a switch over name hashes):
+int fid_index(const char* name, size_t len);
+
+struct Message
+{
+    int date;
+    long time;
+
+    uint32_t present;   // Bit i is set iff values[i] was in the message
+    std::array<double, N_TRACKED> values;
+
+    bool has(int fid) const { return (present >> fid) & 1u; }
+};
+
+// Scans the messages of a memory mapped export in place; no row is copied or
+// split into strings:
+class Reader
+{
+    private:
+        MappedFile file_;
+        size_t pos_ = 0;
+
+        size_t _Split(size_t pos, const char* fields[], size_t lens[]) const;
+
+    public:
+        void Open(const std::string& path);
+        void Close();
+
+        bool IsOpen() const;
+
+        // The next message; false at the end of the file:
+        bool Next(Message& msg);
+
+        size_t Tell() const;
+        void Seek(size_t pos);
+
+        void Swap(Reader& other);
+};
+
+class MarketDepth: public data::MarketDepth
+{
+    private:
+        Reader reader_;
+        Message msg_;
+
+        // The book after all messages read so far, and whether the last of
+        // them is yet to be streamed:
+        MarketDepthRecord book_;
+        bool pending_ = false;
+
+        std::deque<std::string> queue_;
+        bool switched_ = false;
+
+        bool _Peek();
+
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        MarketDepth();
+        MarketDepth(std::string file_path);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        bool Save(std::ostream& os);
+        void Load(std::istream& is);
+
+        void QueueFile(std::string path);
+        bool NextFile();
+};
+
+class TimeAndSales: public data::TimeAndSales
+{
+    private:
+        Reader reader_;
+
+        // The next trade, if it has been read but not yet streamed:
+        Message msg_;
+        bool pending_ = false;
+
+        std::deque<std::string> queue_;
+        bool switched_ = false;
+
+        bool _Peek();
+
+        bool _LoadNext();
+        long _TimeLookAhead();
+
+    public:
+        TimeAndSales();
+        TimeAndSales(std::string file_path);
+
+        void LoadCSV(std::string path);
+
+        void Reset();
+        void SkipN(long n = 1L);
+
+        bool Save(std::ostream& os);
+        void Load(std::istream& is);
+
+        void QueueFile(std::string path);
+        bool NextFile();
+};
+
+}
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <istream>
+#include <ostream>
 
 #include "data/records.h"
 #include "utilities/csv.h"
@@ -46,6 +48,22 @@ class Streamer
         virtual void Reset();
         virtual void SkipN(long n = 1L) = 0;
 
+        // Save/restore the read position (incl. buffered records):
+        virtual bool Save(std::ostream& os);
+        virtual void Load(std::istream& is);
+
+        // Multi-day sessions: files queued behind the current one are opened
+        // ahead of time and entered with NextFile():
+        virtual void QueueFile(string path);
+        virtual bool NextFile();
+
+        // Position the stream so that the next record is the first after the
+        // given time of the current day:
+        virtual bool SeekTime(long time);
+
+        // Replay in buckets of the given width (see data::Downsampled):
+        virtual void SetResolution(long ms);
+
         bool HasTimeChanged();
         bool WillTimeChange();
 
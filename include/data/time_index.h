@@ -0,0 +1,44 @@
+#ifndef DATA_TIME_INDEX_H
+#define DATA_TIME_INDEX_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace data
+{
+
+// Byte offsets of the first row of every second in a csv file of
+// (date, time, ...) rows, so that a streamer can seek straight to any time of
+// the day instead of replaying it from the start.
+class TimeIndex
+{
+    private:
+        int date_;
+
+        std::vector<long> times_;
+        std::vector<long> offsets_;
+
+        static std::mutex cache_mutex_;
+        static std::map<std::string, std::shared_ptr<const TimeIndex>> cache_;
+
+    public:
+        TimeIndex(const std::string& path);
+
+        int date() const;
+
+        long first_time() const;
+        long last_time() const;
+
+        // Offset of the latest indexed row at or before the given time:
+        long Find(long time) const;
+
+        // Indices are built once per file and shared between threads:
+        static std::shared_ptr<const TimeIndex> Get(const std::string& path);
+};
+
+}
+
+#endif
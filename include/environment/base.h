@@ -7,6 +7,8 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <istream>
+#include <ostream>
 #include <utility>
 #include <spdlog/spdlog.h>
 
@@ -15,6 +17,7 @@
 #include "market/latency.h"
 #include "market/target_price.h"
 #include "utilities/config.h"
+#include "utilities/binlog.h"
 #include "utilities/accumulators.h"
 #include "environment/statistics.h"
 #include "environment/risk_manager.h"
@@ -56,6 +59,7 @@ class Base
 
         double pnl_step = 0.0;
         double momentum_pnl_step = 0.0;
+        double captured_step = 0.0;
 
         const int ORDER_SIZE;
 
@@ -64,6 +68,7 @@ class Base
 
         // Rewards
         RewardMeasure reward;
+        double (Base::*reward_fn_)();
         const float r_pos_weight;
         const float r_trd_weight;
         const float r_pnl_weight;
@@ -86,17 +91,32 @@ class Base
         // Inspection
         const bool INSPECT_BOOKS;
 
-        // Statistics
-        ExperimentStatistics episode_stats;
+        // Warm-start snapshots (keyed by this tag + the data source)
+        string snapshot_tag_;
 
-        ExperimentStatistics experiment_stats;
+        // Statistics (per episode); episode_stats.pnl is realised, while the
+        // experiment's pnl sums the marked-to-market step pnl:
+        ExperimentStatistics episode_stats;
+        double marked_pnl = 0.0;
         TradeStatistics trade_stats;
+
+        // Fills counted by the books before they were last reset overnight,
+        // so that the transactions of a session span all of its days:
+        int session_ask_transactions = 0,
+            session_bid_transactions = 0;
         TickStatistics tick_stats;
+        StepStatistics step_stats;
+
+        // Statistics (all episodes run by this environment):
+        Statistics experiment_stats;
 
         // Logging
         shared_ptr<spdlog::logger> profit_logger = nullptr;
         shared_ptr<spdlog::logger> trade_logger = nullptr;
 
+        shared_ptr<binlog::Log> profit_binlog = nullptr;
+        shared_ptr<binlog::Log> trade_binlog = nullptr;
+
     protected:
         // Interaction functions:
         virtual void DoAction(int action) = 0;
@@ -110,6 +130,27 @@ class Base
 
         void ClearWindows();
 
+        virtual void SaveSnapshot(std::ostream& os);
+        virtual void LoadSnapshot(std::istream& is);
+
+        // Event-time stepping: replay the transition to the next decision
+        // point without stepping through the data (if possible), and mark
+        // the decision points reached by stepping through it:
+        virtual bool FastForward(double& agg_r, double& agg_pnl,
+                                 double& agg_mpm);
+        virtual void MarkDecisionPoint();
+
+        // Reward measures (one is selected at construction):
+        double _reward_none();
+        double _reward_pnl();
+        double _reward_pnl_damped();
+        double _reward_spread();
+        double _reward_normed();
+        double _reward_lovol();
+        double _reward_mm_linear();
+        double _reward_mm_exp();
+        double _reward_mm_div();
+
         virtual void LogProfit(int action, double pnl, double bandh) = 0;
         virtual void LogTrade(char side, char type, double price,
                               long size, double pnl) = 0;
@@ -122,7 +163,10 @@ class Base
         virtual bool Initialise();
 
         // Learning
-        virtual void getState(vector<float>& out) = 0;
+        virtual size_t getStateSize() = 0;
+        virtual void getState(float* out) = 0;
+        void getState(vector<float>& out);
+
         double getReward();
         double getPotential();
 
@@ -147,7 +191,10 @@ class Base
         virtual void printInfo(const int action = -1);
 
         void resetStats();
+        void commitStats();
         void writeStats(string path);
+
+        const Statistics& getStats() const;
 };
 
 }
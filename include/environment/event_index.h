@@ -0,0 +1,85 @@
+#ifndef ENVIRONMENT_EVENT_INDEX_H
+#define ENVIRONMENT_EVENT_INDEX_H
+
+#include "market/target_price.h"
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace environment {
+
+// Everything a single book event contributes to the environment's windows
+// and reward, recorded during a full replay of the day.
+struct IndexedEvent
+{
+    long mid_ticks;
+    double mpm;
+    double spread;
+
+    long ask_volume;
+    long bid_volume;
+
+    market::tp::Observation obs;
+};
+
+// One agent decision interval: the events [start, end) between two decision
+// points, the most extreme prices any order could have been touched at
+// within them, and the serialised replay cursor at the end of the interval.
+// The streamer positions are kept apart since restoring them is only needed
+// once we stop jumping.
+struct DecisionInterval
+{
+    size_t start;
+    size_t end;
+
+    double ask_extent;
+    double bid_extent;
+
+    std::string cursor;
+    std::string streams;
+};
+
+// Per-day index of book events and the decision points between which the
+// mid-price does not move. Decision points depend only on the data, so the
+// k'th interval of any episode over the same day is intervals[k].
+struct EventIndex
+{
+    std::vector<IndexedEvent> events;
+    std::vector<DecisionInterval> intervals;
+};
+
+// Process-wide store of completed event indices. Once stored, an index is
+// immutable and may be shared freely between threads.
+class EventIndexCache
+{
+    private:
+        std::mutex mutex_;
+
+        size_t capacity_;
+
+        std::list<std::string> order_;
+        std::map<std::string, std::shared_ptr<const EventIndex>> indices_;
+
+    public:
+        EventIndexCache();
+
+        static EventIndexCache& Global();
+
+        // Maximum number of days held in memory (0 => unbounded):
+        void SetCapacity(size_t n);
+
+        std::shared_ptr<const EventIndex> Fetch(const std::string& key);
+        void Store(const std::string& key,
+                   std::shared_ptr<const EventIndex> index);
+
+        void Clear();
+};
+
+}
+
+#endif
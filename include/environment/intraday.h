@@ -4,11 +4,15 @@
 #include "data/basic.h"
 #include "market/market.h"
 #include "environment/base.h"
+#include "environment/event_index.h"
 #include "utilities/comparison.h"
 
 #include <map>
 #include <tuple>
+#include <memory>
+#include <random>
 #include <vector>
+#include <sstream>
 #include <functional>
 
 
@@ -34,15 +38,104 @@ class Intraday: public Base
         // Real market parameters
         market::Market* market = nullptr;
 
-        list<Variable> state_vars;
+        // Per-step state pipeline, built once from the config:
+        typedef double (Intraday::*VariableKernel)();
+
+        vector<Variable> state_vars;
+        vector<VariableKernel> state_kernels;
         const static map<string, Variable> v_to_i;
 
+        static VariableKernel kernel(Variable v);
+
+        double _pos();
+        double _spd();
+        double _mpm();
+        double _imb();
+        double _svl();
+        double _vol();
+        double _rsi();
+        double _vwap();
+        double _a_dist();
+        double _a_queue();
+        double _b_dist();
+        double _b_queue();
+        double _last_action();
+
 
         int last_date = 0;
         int init_date = 0;      // Used for logging...
 
         long ref_time;
 
+        // Sub-day episodes: a random slice of the day, reached by seeking
+        // through the data's time index rather than replaying up to it:
+        const long SLICE_LENGTH;    // ms (0 => until the close)
+        const long SLICE_STEPS;     // decision steps (0 => unlimited)
+
+        std::mt19937_64 slice_gen_;
+
+        long slice_start_ = 0;
+        long slice_end_ = 0;
+        long n_steps_ = 0;
+
+        bool _IsSliced();
+        bool _SeekSlice();
+
+        // Warm-start snapshots:
+        const bool WARM_START;
+        string md_path_, tas_path_;
+
+        string _SnapshotKey();
+        bool RestoreSnapshot();
+        void StoreSnapshot();
+
+        void SaveSnapshot(std::ostream& os);
+        void LoadSnapshot(std::istream& is);
+
+        // Event-time stepping (see environment/event_index.h):
+        const bool EVENT_INDEX;
+
+        size_t event_ = 0;
+        size_t interval_ = 0;
+        size_t interval_start_ = 0;
+        double ask_extent_, bid_extent_;
+
+        shared_ptr<const EventIndex> index_;
+        shared_ptr<EventIndex> recording_;
+
+        istringstream cursor_is_;
+        ostringstream cursor_os_;
+        const string* pending_streams_ = nullptr;
+
+        void BeginEventIndex();
+        void PublishEventIndex();
+
+        void _SaveCursor(std::ostream& os);
+        void _LoadCursor(const string& cursor);
+        void _SyncStreams();
+
+        void _ReplayEvent(const IndexedEvent& e);
+        void _ResetExtents();
+        bool _QuotesAtRisk(const DecisionInterval& di);
+
+        bool FastForward(double& agg_r, double& agg_pnl, double& agg_mpm);
+        void MarkDecisionPoint();
+
+        // Multi-day sessions: days queued behind the current one, entered
+        // overnight without re-initialising the episode:
+        int days_left_ = 0;
+
+        bool _WarmUp();
+        bool _DayIsOver();
+        bool _Overnight();
+
+        // No-op compaction: a depth row repeating the books' last snapshot
+        // re-uses the stashed levels rather than rebuilding them:
+        const bool COMPACT;
+
+        void _ApplyDepth(const data::MarketDepthRecord& rec,
+                         const std::map<double, long, FloatComparator<>>& transactions);
+
         int ask_level = 0;
         int bid_level = 0;
 
@@ -65,9 +158,16 @@ class Intraday: public Base
 
         bool Initialise();
         void LoadData(string symbol, string md_path, string tas_path);
+        void QueueData(string md_path, string tas_path);
+
+        // Replay the data in buckets of the given width (if supported):
+        void SetResolution(long ms);
 
         double getVariable(Variable v);
-        void getState(vector<float>& out);
+
+        using Base::getState;
+        size_t getStateSize();
+        void getState(float* out);
 
         bool isTerminal();
         string getEpisodeId();
@@ -0,0 +1,36 @@
+#ifndef ENVIRONMENT_SNAPSHOT_H
+#define ENVIRONMENT_SNAPSHOT_H
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace environment {
+
+// Process-wide store of warmed-up environment states, keyed by the data files
+// and window configuration that produced them. Entries live in memory and,
+// if a directory is set, are mirrored to disk so later runs can reuse them.
+class SnapshotCache
+{
+    private:
+        std::mutex mutex_;
+
+        std::string directory_;
+        std::map<std::string, std::string> blobs_;
+
+        std::string _FilePath(const std::string& key);
+
+    public:
+        static SnapshotCache& Global();
+
+        void SetDirectory(std::string dir);
+
+        bool Fetch(const std::string& key, std::string& blob);
+        void Store(const std::string& key, const std::string& blob);
+
+        void Clear();
+};
+
+}
+
+#endif
@@ -2,9 +2,104 @@
 #define ENVIRONMENT_STATISTICS_H
 
 #include <string>
+#include <vector>
+#include <ostream>
 
 namespace environment {
 
+// Streaming count, mean, variance and range (Welford). Two instances merge
+// exactly, so per-thread moments can be combined at the end of a run.
+struct Moments
+{
+    long n = 0;
+
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    double min = 0.0;
+    double max = 0.0;
+
+    inline void push(double x)
+    {
+        if (n == 0) min = max = x;
+        else if (x < min) min = x;
+        else if (x > max) max = x;
+
+        double delta = x - mean;
+
+        n++;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+    }
+
+    void merge(const Moments& other);
+
+    double sum() const;
+    double variance() const;
+    double stddev() const;
+
+    void reset();
+};
+
+// Mergeable streaming quantile sketch with bounded relative error.
+//
+// Values are counted in log-linear buckets: each power of two is split into
+// SUB_BUCKETS linear sub-buckets, so a bucket is found with a frexp instead
+// of a log and every estimate is within 1/(2*SUB_BUCKETS) of the true value.
+// Buckets of two sketches line up, so merging is exact.
+class QuantileSketch
+{
+    public:
+        static const int SUB_BUCKETS = 64;
+
+    private:
+        long count_;
+        long zero_count_;
+
+        // Bucket counts for positive and negative values, stored from the
+        // smallest key seen onwards:
+        int pos_offset_;
+        std::vector<long> pos_;
+
+        int neg_offset_;
+        std::vector<long> neg_;
+
+        static int _key(double magnitude);
+        static double _value(int key);
+
+        static void _add(std::vector<long>& buckets, int& offset,
+                         int key, long n);
+
+    public:
+        QuantileSketch();
+
+        void push(double x);
+        void merge(const QuantileSketch& other);
+
+        long count() const;
+        double quantile(double q) const;
+
+        void reset();
+};
+
+// Moments and quantiles of a per-step quantity.
+struct Distribution
+{
+    Moments moments;
+    QuantileSketch sketch;
+
+    inline void push(double x)
+    {
+        moments.push(x);
+        sketch.push(x);
+    }
+
+    void merge(const Distribution& other);
+    void write(std::ostream& os, const std::string& section) const;
+
+    void reset();
+};
+
 struct ExperimentStatistics
 {
     double reward = 0.0f;
@@ -12,7 +107,9 @@ struct ExperimentStatistics
     double pnl = 0.0f;
     double bandh = 0.0f;
 
-    void write(std::string path);
+    void merge(const ExperimentStatistics& other);
+    void write(std::ostream& os) const;
+
     void reset();
 };
 
@@ -27,7 +124,9 @@ struct TradeStatistics
     int market_buys = 0;
     int market_sells = 0;
 
-    void write(std::string path);
+    void merge(const TradeStatistics& other);
+    void write(std::ostream& os) const;
+
     void reset();
 };
 
@@ -45,7 +144,42 @@ struct TickStatistics
     int ticks_long = 0;
     int total_ticks = 0;
 
-    void write(std::string path);
+    void merge(const TickStatistics& other);
+    void write(std::ostream& os) const;
+
+    void reset();
+};
+
+// Distributions of per-step quantities, sampled once per decision step.
+struct StepStatistics
+{
+    Distribution pnl;
+    Distribution inventory;
+    Distribution spread_captured;
+
+    void merge(const StepStatistics& other);
+    void write(std::ostream& os) const;
+
+    void reset();
+};
+
+// Everything recorded over a number of episodes. Each environment (and hence
+// each thread) owns its own instance and updates it without synchronisation;
+// instances are merged once an episode or experiment is over.
+struct Statistics
+{
+    long episodes = 0;
+
+    ExperimentStatistics totals;
+    TradeStatistics trades;
+    TickStatistics ticks;
+    StepStatistics steps;
+
+    void merge(const Statistics& other);
+
+    // Writes all sections to a single csv of (section, statistic, value):
+    void write(std::string path) const;
+
     void reset();
 };
 
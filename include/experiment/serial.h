@@ -3,6 +3,9 @@
 
 #include <string>
 #include <atomic>
+#include <memory>
+#include <functional>
+#include <spdlog/spdlog.h>
 
 #include "rl/agent.h"
 #include "rl/state.h"
@@ -40,21 +43,35 @@ class Learner: public Runner
         unsigned long _step_counter = 0;
         static std::atomic_int _episode_counter;
 
+        std::shared_ptr<spdlog::logger> training_logger = nullptr;
+
+        std::function<void()> on_step_;
+
         bool _step(rl::Agent *m);
 
     public:
         Learner(Config& c, environment::Base& env);
 
         bool RunEpisode(rl::Agent *m);
+
+        // Called after each learning step (e.g. to let the other training
+        // threads take theirs):
+        void OnStep(std::function<void()> hook);
 };
 
 class Backtester: public Runner
 {
     private:
+        std::function<void()> on_decision_;
+
         bool _step(rl::Agent *m);
 
     public:
         Backtester(Config& c, environment::Base& env);
+
+        // Called as soon as each action has been chosen (e.g. to time the
+        // decisions made on a live feed):
+        void OnDecision(std::function<void()> hook);
 };
 
 }
@@ -5,6 +5,8 @@
 #include <cmath>
 #include <array>
 #include <tuple>
+#include <istream>
+#include <ostream>
 #include <utility>
 
 #include "market/order.h"
@@ -63,8 +65,19 @@ class Book
             const std::array<long, DEPTH>& new_volumes,
             const std::map<double, long, FloatComparator<>>& transactions={});
 
+        // Same as ApplyChanges for a snapshot identical to the stashed one,
+        // but re-uses the stashed levels; false (a no-op) if it differs:
+        bool HoldState(
+            const std::array<double, DEPTH>& new_prices,
+            const std::array<long, DEPTH>& new_volumes);
+
         void Reset();
 
+        // Snapshots of the book profile; open orders and the fill count
+        // are left untouched:
+        void SaveState(std::ostream& os);
+        void LoadState(std::istream& is);
+
         // Price/volume getters
         int depth();
 
@@ -4,10 +4,26 @@
 #include "market/book.h"
 #include "utilities/accumulators.h"
 
+#include <istream>
+#include <ostream>
+
 
 namespace market {
 namespace tp {
 
+// Book-derived inputs to the target price estimators. Kept separate from the
+// books so that precomputed observations can be replayed without them.
+struct Observation
+{
+    double midprice;
+    double microprice;
+
+    double value;
+    long volume;
+
+    static Observation from(market::AskBook<>& ab, market::BidBook<>& bb);
+};
+
 class TargetPrice
 {
     protected:
@@ -20,8 +36,12 @@ class TargetPrice
         double get();
 
         virtual bool ready();
-        virtual void update(market::AskBook<>& ab, market::BidBook<>& bb);
+        void update(market::AskBook<>& ab, market::BidBook<>& bb);
+        virtual void update(const Observation& obs);
         virtual void clear();
+
+        virtual void save(std::ostream& os);
+        virtual void load(std::istream& is);
 };
 
 class MidPrice: public TargetPrice
@@ -33,8 +53,11 @@ class MidPrice: public TargetPrice
         MidPrice(int lookback);
 
         bool ready();
-        void update(market::AskBook<>& ab, market::BidBook<>& bb);
+        void update(const Observation& obs);
         void clear();
+
+        void save(std::ostream& os);
+        void load(std::istream& is);
 };
 
 class MicroPrice: public TargetPrice
@@ -46,8 +69,11 @@ class MicroPrice: public TargetPrice
         MicroPrice(int lookback);
 
         bool ready();
-        void update(market::AskBook<>& ab, market::BidBook<>& bb);
+        void update(const Observation& obs);
         void clear();
+
+        void save(std::ostream& os);
+        void load(std::istream& is);
 };
 
 class VWAP: public TargetPrice
@@ -60,8 +86,11 @@ class VWAP: public TargetPrice
         VWAP(int lookback);
 
         bool ready();
-        void update(market::AskBook<>& ab, market::BidBook<>& bb);
+        void update(const Observation& obs);
         void clear();
+
+        void save(std::ostream& os);
+        void load(std::istream& is);
 };
 
 }
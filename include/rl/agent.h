@@ -5,10 +5,13 @@
 #include <memory>
 #include <random>
 #include <fstream>
+#include <spdlog/spdlog.h>
 
 #include "rl/state.h"
 #include "rl/policy.h"
 #include "rl/traces.h"
+#include "rl/weights.h"
+#include "utilities/binlog.h"
 
 namespace rl {
 
@@ -19,7 +22,9 @@ class Agent
         const int N_TILINGS;
         const int N_ACTIONS;
 
-        double* theta;
+        // Set 0 is theta; double learners keep theta_b in set 1. Shared by
+        // the forks of an agent:
+        std::shared_ptr<Weights> weights;
         std::tuple<double, double, double> group_weights;
 
         Traces traces;
@@ -40,13 +45,39 @@ class Agent
         double _agg_delta = 0.0;
         int _update_counter = 0;
 
+        std::shared_ptr<spdlog::logger> model_logger = nullptr;
+        std::shared_ptr<binlog::Log> model_binlog = nullptr;
+
+        // The Q of every action handed to the policy, written in place
+        // rather than allocated per call:
+        std::vector<double> qs;
+
+        // Changed whenever the weights are, so that the Q memoised by states under
+        // older weights is recomputed:
+        unsigned long version;
+
+        // Moves on the version of every set, after they have been replaced:
+        virtual void invalidateQ();
+
         virtual void UpdateTraces(State& from_state, int action);
 
         int epsilonGreedy(State& state);
 
+        // The Q of every action, memoised by the state:
+        const double* allQ(State& state);
+
+        // Samples the action to bootstrap from in an on-policy update, which
+        // is then the one taken in that state:
+        unsigned int bootstrapAction(State& s);
+
+        // The same learner, with the same weights and fresh traces (and no
+        // policy), for Fork:
+        Agent(const Agent& other);
+        virtual Agent* Clone() const = 0;
+
     public:
-        Agent(std::unique_ptr<Policy> policy, Config &c);
-        virtual ~Agent();
+        Agent(std::unique_ptr<Policy> policy, Config &c, int n_sets = 1);
+        virtual ~Agent() = default;
 
         std::unique_ptr<Policy> policy;
 
@@ -56,6 +87,13 @@ class Agent
         void GoGreedy();
         void SetPolicy(std::unique_ptr<Policy> policy);
 
+        // A learner for another thread: it updates these weights (without
+        // locks, see Weights) with traces, a policy and random numbers of its
+        // own. The forks of an agent learn its rate and any other statistics
+        // apart, starting from its own:
+        std::unique_ptr<Agent> Fork(std::unique_ptr<Policy> policy,
+                                    unsigned seed) const;
+
         // Updating weights:
         void HandleTransition(State& from_state, int action, double reward,
                               State& to_state);
@@ -73,22 +111,39 @@ class Agent
         int argmaxQ(State& state);
         double maxQ(State& state);
 
-        // IO
+        // IO: theta is written to the file given, and theta_b of a double
+        // learner to the same name with ".b" appended. A double learner
+        // reading weights saved without theta_b starts both sets from theta:
         void write_theta(string filename);
+        void read_theta(string filename);
+
+        // Copies the weights of every action in a state from an agent with
+        // another weight layout, given the same state in its layout (theta_b
+        // from theta if that agent has none):
+        void ImportWeights(State& state, const Agent& from, State& from_state);
 };
 
 class DoubleAgent: public Agent {
     private:
-        double* theta_b;
+        unsigned long version_b;
+
+    protected:
+        void invalidateQ();
 
     public:
         DoubleAgent(std::unique_ptr<Policy> policy, Config& c);
-        ~DoubleAgent();
+        DoubleAgent(const DoubleAgent& other);
 
         unsigned int action(State& s);
 
         void updateQb(double update);
 
+        const double* allQb(State& state);
+
+        // The Q of every action under both sets of weights, in one pass
+        // unless either is memoised:
+        void allQab(State& state, const double*& qa, const double*& qb);
+
         double getQb(State& state, int action);
         int argmaxQb(State& state);
 };
@@ -97,6 +152,7 @@ class DoubleAgent: public Agent {
 class QLearn: public Agent {
     private:
         void UpdateTraces(State& from_state, int action);
+        Agent* Clone() const;
 
     public:
         QLearn(std::unique_ptr<Policy> policy, Config& c);
@@ -106,6 +162,9 @@ class QLearn: public Agent {
 };
 
 class SARSA: public Agent {
+    private:
+        Agent* Clone() const;
+
     public:
         SARSA(std::unique_ptr<Policy> policy, Config& c);
 
@@ -117,6 +176,7 @@ class DoubleQLearn: public DoubleAgent {
     // H. V Hasselt, “Double Q-learning,”
     private:
         void UpdateTraces(State& from_state, int action);
+        Agent* Clone() const;
 
     public:
         DoubleQLearn(std::unique_ptr<Policy> policy, Config& c);
@@ -131,6 +191,7 @@ class RLearn: public Agent {
         double rho = 0;
 
         void UpdateTraces(State& from_state, int action);
+        Agent* Clone() const;
 
     public:
         RLearn(std::unique_ptr<Policy> policy, Config& c);
@@ -144,6 +205,8 @@ class OnlineRLearn: public Agent {
         double beta;
         double rho = 0;
 
+        Agent* Clone() const;
+
     public:
         OnlineRLearn(std::unique_ptr<Policy> policy, Config& c);
 
@@ -157,6 +220,7 @@ class DoubleRLearn: public DoubleAgent {
         double rho = 0;
 
         void UpdateTraces(State& from_state, int action);
+        Agent* Clone() const;
 
     public:
         DoubleRLearn(std::unique_ptr<Policy> policy, Config& c);
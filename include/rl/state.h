@@ -14,15 +14,42 @@ class State
         long MEMORY_SIZE;
         int N_TILINGS;
         int N_ACTIONS;
+        bool FAST_HASHING;
+        bool ACTION_MAJOR;
         // ---
 
         std::vector<float> state_vars;
-        std::vector<std::vector<int>> features;
+
+        // The 3*N_TILINGS features of each action, one action after another:
+        std::vector<int> features;
+
+        // Scratch space for populateFeatures; the quantised variables and the
+        // hashed tilings of the three feature groups:
+        std::vector<int> qstate;
+        std::vector<long> sums;
 
         double potential;
 
+        // Q of every action under up to two sets of weights, each valid
+        // while its weights have the version it was computed with (versions
+        // are never 0), and an action already chosen in this state:
+        std::vector<double> q_memo[2];
+        unsigned long q_version[2];
+
+        int chosen_action;
+
+        void forget();
+
     public:
-        State(long n_states, int n_actions, int n_tilings);
+        // With action_major, each tile is hashed once for all actions, and
+        // its weights are those of the actions side by side:
+        //
+        //     feature = tile * n_actions + action
+        //
+        // so that the actions of a state share cache lines; otherwise each
+        // action hashes its tiles apart:
+        State(long n_states, int n_actions, int n_tilings,
+              bool fast_hashing = false, bool action_major = false);
         State(Config &c);
 
         void initialise();
@@ -31,7 +58,20 @@ class State
         void newState(std::vector<float>& vars, double potential = 0.0);
 
         void populateFeatures();
-        std::vector<int>& getFeatures(int action = 0);
+        const int* getFeatures(int action = 0) const;
+        int nFeatures() const;
+
+        // The memoised Q of every action under the given weights, or null:
+        const double* memoQ(int weights, unsigned long version) const;
+
+        // Space for the Q of every action under the given weights, memoised
+        // as soon as it is written:
+        double* memoiseQ(int weights, unsigned long version);
+
+        // The action to take in this state if one was already chosen (for
+        // instance to bootstrap from), or -1; cleared once taken:
+        void chooseAction(int action);
+        int takeChosenAction();
 
         double getPotential();
 
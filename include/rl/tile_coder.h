@@ -0,0 +1,65 @@
+#ifndef RL_TILE_CODER_H
+#define RL_TILE_CODER_H
+
+#include <cstdint>
+
+namespace rl {
+namespace tile_coder {
+
+const int MAX_NUM_TILINGS = 256;
+
+enum class ISA { SCALAR, AVX2, AVX512 };
+
+// The widest instruction set supported by both this build and this CPU; it is
+// looked up once:
+ISA best();
+bool supported(ISA isa);
+
+const char* name(ISA isa);
+
+// As ::tiles() with a memory size and a set of ints, giving the same indices.
+// Tilings are computed 16 (AVX-512) or 8 (AVX2) at a time; numbers of tilings
+// that are not a power of two (and any less than a vector) are computed one at
+// a time. Unlike ::tiles(), this is safe to call from several threads:
+void tiles(int the_tiles[], int num_tilings, int memory_size,
+           const float floats[], int num_floats,
+           const int ints[], int num_ints);
+
+// As above on the given instruction set, which must be supported:
+void tiles(ISA isa, int the_tiles[], int num_tilings, int memory_size,
+           const float floats[], int num_floats,
+           const int ints[], int num_ints);
+
+// The steps of tiles(), for callers that code the same variables with many
+// sets of ints. The hash of a tile in ::tiles() is a sum over its coordinates,
+// so the part due to the floats (and the tiling) is computed once per tiling
+// and that of the ints is added to it:
+//
+//     tile j = (sums[j] + hash_ints(ints, num_ints, num_floats)) % memory_size
+//
+// Variables are quantised independently, so those of a subset of the floats
+// are a slice of qstate:
+void quantise(int qstate[], const float floats[], int num_floats,
+              int num_tilings);
+
+void hash_tilings(long the_sums[], int num_tilings,
+                  const int qstate[], int num_floats);
+void hash_tilings(ISA isa, long the_sums[], int num_tilings,
+                  const int qstate[], int num_floats);
+
+long hash_ints(const int ints[], int num_ints, int num_floats);
+
+// A faster (but different) reduction than the modulo above, without a
+// division: the sum is mixed by a multiplicative hash and scaled to the memory
+// size:
+inline int reduce_fast(long sum, int memory_size)
+{
+    uint32_t h = (uint32_t) (((uint64_t) sum * 0x9E3779B97F4A7C15ULL) >> 32);
+
+    return (int) (((uint64_t) h * (uint32_t) memory_size) >> 32);
+}
+
+}
+}
+
+#endif
@@ -47,6 +47,7 @@ void tiles(
     int num_ints);             // number of integer variables
 
 int hash_UNH(int *ints, int num_ints, long m, int increment);
+const unsigned int* hash_UNH_table();
 int hash(int *ints, int num_ints, collision_table *ctable);
 
 // no ints
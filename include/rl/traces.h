@@ -3,46 +3,58 @@
 
 #include "rl/state.h"
 
-#include <iterator>
+#include <vector>
 
 namespace rl {
 
-#define MAX_NONZERO_TRACES 100000
-
+// Replacing eligibility traces of the features visited. A trace is kept as
+// its value over a scale, the product of every decay since the traces were
+// last renormalised, so that decaying them all is one product. Traces that
+// have decayed below a tolerance are dropped when they are next swept:
 class Traces
 {
     private:
-        const long MEMORY_SIZE;
         const int N_TILINGS;
         const int N_ACTIONS;
 
-        float tolerance;
+        const double tolerance;
 
-        int* nonzero_traces_inverse;
+        double scale;
 
-    public:
-        float* eligibility;
+        // The live traces, as features and unscaled values side by side:
+        std::vector<int> features;
+        std::vector<double> values;
+
+        // The position of each live feature, by open addressing (-1 for an
+        // empty slot):
+        std::vector<int> slots;
+        int shift;
 
-        int n_nonzero_traces;
-        int nonzero_traces[MAX_NONZERO_TRACES];
+        int home(int feature) const;
+        int find(int feature) const;
+
+        void grow();
+        void remove(int slot);
 
     public:
-        Traces(long memory_size, int n_tilings, int n_actions);
-        ~Traces();
+        Traces(int n_tilings, int n_actions);
 
         void decay(float rate);
         void update(State& state, int action);
 
-        int* begin();
-        int* end();
+        // Drops the traces that have decayed below tolerance. Those left are
+        // getValues()[k] * getScale() for feature getFeatures()[k], k < size():
+        void prune();
+
+        int size() const;
+        const int* getFeatures() const;
+        const double* getValues() const;
+        double getScale() const;
 
-        float get(int feature);
+        float get(int feature) const;
         void set(int feature, float value);
 
         void clear(int feature);
-        void clearExisting(int feature, int loc);
-
-        void increaseTolerance();
 };
 
 }
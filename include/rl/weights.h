@@ -0,0 +1,217 @@
+#ifndef RL_WEIGHTS_H
+#define RL_WEIGHTS_H
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace rl {
+
+// bfloat16: the upper half of a float, rounded to the nearest (even) value. It
+// has a float's range with 8 bits of precision:
+struct bf16
+{
+    uint16_t bits;
+
+    bf16() = default;
+    bf16(float f)
+    {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof u);
+
+        bits = (uint16_t) ((u + 0x7FFF + ((u >> 16) & 1)) >> 16);
+    }
+
+    operator float() const
+    {
+        uint32_t u = (uint32_t) bits << 16;
+
+        float f;
+        std::memcpy(&f, &u, sizeof f);
+
+        return f;
+    }
+};
+
+// Dense weights may be read and updated by several threads at once, without
+// locks (as in Hogwild!). Each weight is loaded and stored whole with relaxed
+// ordering, so concurrent updates of one weight can be lost but never torn;
+// on x86 these are plain moves:
+template<class T>
+inline T load_relaxed(const T* p)
+{
+    T v;
+    __atomic_load(p, &v, __ATOMIC_RELAXED);
+
+    return v;
+}
+
+template<class T>
+inline void store_relaxed(T* p, T v)
+{
+    __atomic_store(p, &v, __ATOMIC_RELAXED);
+}
+
+// The weights of the tiles that have been updated, in a table keyed by tile
+// (open addressing with linear probing), so that memory grows with the tiles
+// visited rather than the size of the hash space. The weights of a tile in
+// every set share its slot. A weight that was never updated is 0 or, once its
+// set is randomised, uniform in [-1, 1) by a hash of its key. Keys are the
+// indices of tiles, below the size of the weights (at most INT_MAX), so never
+// EMPTY. Unlike dense weights, they cannot be shared between threads:
+class SparseWeights
+{
+    private:
+        // A slot is its key followed by its weight in each set:
+        union Word { long key; double w; };
+
+        static const long EMPTY = -1;
+
+        const int n_sets_;
+        const int width_;
+        std::vector<uint64_t> seeds_;
+
+        int shift_;
+        long mask_;
+        long count_;
+        std::vector<Word> slots_;
+
+        inline long home(long key) const
+        {
+            return (long) (((uint64_t) key * 0x9E3779B97F4A7C15ULL) >> shift_);
+        }
+
+        // The slot holding a key, or -1:
+        inline long find(long key) const
+        {
+            for (long s = home(key); ; s = (s + 1) & mask_) {
+                long k = slots_[s * width_].key;
+
+                if (k == key) return s;
+                if (k == EMPTY) return -1;
+            }
+        }
+
+        double* insert(long key);
+        void grow();
+
+    public:
+        SparseWeights(int n_sets = 1);
+
+        void randomise(int set, uint64_t seed);
+        double initial(int set, long key) const;
+
+        // The number of tiles held:
+        long size() const { return count_; }
+
+        inline double get(int set, long key) const
+        {
+            long s = find(key);
+
+            return (s < 0) ? initial(set, key) : slots_[s*width_ + 1 + set].w;
+        }
+
+        void set(int set, long key, double w) { insert(key)[set] = w; }
+        void add(int set, long key, double dw) { insert(key)[set] += dw; }
+
+        void prefetch(long key) const
+        {
+            __builtin_prefetch(&slots_[home(key) * width_]);
+        }
+
+        // Calls f(key, weights) for every tile held, in no given order:
+        template<class F>
+        void for_each(F f) const
+        {
+            for (long s = 0; s <= mask_; s++)
+                if (slots_[s * width_].key != EMPTY)
+                    f(slots_[s * width_].key, &slots_[s*width_ + 1].w);
+        }
+};
+
+// One or more sets of weights of the same size, stored as doubles, floats or
+// bf16 and always read and written as doubles. Sets are either one after
+// another or interleaved, so that the weights of a feature in every set share
+// a cache line; the weight i of a set is data<T>(set)[stride()*i].
+//
+// With compensation, the rounding error of every update is kept in a second
+// block of the same type and carried into the next update of that weight, so
+// that updates much smaller than a weight are not lost. This doubles the
+// memory of the weights, so it is off unless asked for.
+//
+// Sparse weights are doubles in a SparseWeights table instead:
+class Weights
+{
+    public:
+        enum class Type { DOUBLE, FLOAT, BF16 };
+
+        // "double", "float" or "bf16":
+        static Type parse(const std::string& name);
+
+    private:
+        const Type type_;
+        const long size_;
+        const int n_sets_;
+        const bool interleaved_;
+
+        std::unique_ptr<char[]> data_;
+        std::unique_ptr<char[]> residuals_;
+
+        std::unique_ptr<SparseWeights> sparse_;
+
+        size_t offset(int set) const;
+
+    public:
+        Weights(Type type, long size, int n_sets = 1, bool interleave = false,
+                bool compensated = false, bool sparse = false);
+
+        Type type() const { return type_; }
+        long size() const { return size_; }
+        int n_sets() const { return n_sets_; }
+        int stride() const { return interleaved_ ? n_sets_ : 1; }
+
+        // Null unless the weights are sparse:
+        const SparseWeights* sparse() const { return sparse_.get(); }
+        SparseWeights* sparse() { return sparse_.get(); }
+
+        template<class T>
+        T* data(int set) { return (T*) (data_.get() + offset(set)); }
+
+        template<class T>
+        const T* data(int set) const
+        {
+            return (const T*) (data_.get() + offset(set));
+        }
+
+        // Null without compensation:
+        template<class T>
+        T* residuals(int set)
+        {
+            return residuals_ ? (T*) (residuals_.get() + offset(set))
+                              : nullptr;
+        }
+
+        double get(int set, long i) const;
+        void set(int set, long i, double w);
+
+        // Every weight of a set is 0 or, with random, uniform in [-1, 1).
+        // Dense weights are drawn from gen in order; sparse weights are
+        // hashed from a seed drawn from it:
+        void initialise(int set, bool random, std::mt19937_64& gen);
+
+        // A set as raw doubles (size() of them) or, when sparse, as the
+        // weights of the tiles held; either can be loaded by any weights of
+        // the same size. Weights that a sparse file lacks are left as they
+        // are. False if the stream is of another size:
+        void save(int set, std::ostream& os) const;
+        bool load(int set, std::istream& is);
+};
+
+}
+
+#endif
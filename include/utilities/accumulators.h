@@ -1,9 +1,12 @@
 #ifndef ACCUMULATORS_H
 #define ACCUMULATORS_H
 
-#include <set>
 #include <deque>
 #include <cstddef>
+#include <istream>
+#include <ostream>
+
+#include "utilities/skiplist.h"
 
 template <typename T>
 class Accumulator
@@ -26,10 +29,13 @@ class Accumulator
         T front();
         T back();
 
-        void clear();
+        virtual void clear();
 
         bool full();
         size_t size();
+
+        virtual void save(std::ostream& os);
+        virtual void load(std::istream& is);
 };
 
 template <typename T>
@@ -43,6 +49,7 @@ class RollingMean: public Accumulator<T>
         RollingMean(size_t window_size);
 
         void push(T val);
+        void clear();
 
         T mean();
         T var();
@@ -50,6 +57,9 @@ class RollingMean: public Accumulator<T>
 
         T zscore(T val);
         T last_zscore();
+
+        void save(std::ostream& os);
+        void load(std::istream& is);
 };
 
 template <typename T>
@@ -63,24 +73,29 @@ class EWMA: public Accumulator<T>
         EWMA(size_t window_size);
 
         void push(T val);
+        void clear();
 
         T mean();
+
+        void save(std::ostream& os);
+        void load(std::istream& is);
 };
 
 template <typename T>
 class RollingMedian: public Accumulator<T>
 {
     private:
-        std::multiset<T> min_heap;
-        std::multiset<T> max_heap;
+        IndexableSkiplist<T> sorted_;
 
     public:
         RollingMedian(size_t window_size);
 
         void push(T val);
+        void clear();
 
         T median();
 
+        T quantile(double q);
         T quartile(double quartile);
         T iqr();
 
@@ -89,6 +104,8 @@ class RollingMedian: public Accumulator<T>
 
         T zscore(T val);
         T last_zscore();
+
+        void load(std::istream& is);
 };
 
 #endif
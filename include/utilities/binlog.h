@@ -0,0 +1,160 @@
+#ifndef UTILITIES_BINLOG_H
+#define UTILITIES_BINLOG_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+// Asynchronous binary logging of fixed-schema records.
+//
+// Every producing thread appends to its own lock-free single-producer ring,
+// so logging on the step path is a handful of stores. A background thread
+// drains the rings into a columnar file: a header with the schema followed
+// by blocks of rows, stored column by column. Use binlog::ExportCSV to turn
+// a file back into the equivalent csv log.
+namespace binlog {
+
+enum class Type: uint8_t { i32, i64, f64, chr };
+
+struct Column
+{
+    std::string name;
+    Type type;
+};
+
+// Fields travel through the rings in 8-byte slots but are stored on disk at
+// the width of their column type:
+typedef uint64_t Slot;
+
+size_t width(Type t);
+
+inline Slot pack(double v)
+{
+    Slot s;
+    std::memcpy(&s, &v, sizeof(s));
+
+    return s;
+}
+
+inline Slot pack(float v) { return pack((double) v); }
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value, Slot>::type
+pack(T v)
+{
+    return (Slot) (int64_t) v;
+}
+
+// Single-producer/single-consumer ring of fixed-width records.
+class Ring
+{
+    private:
+        const size_t width_;
+        const size_t capacity_;
+
+        std::vector<Slot> data_;
+
+        // Keep the producer and consumer indices on separate cache lines:
+        std::atomic<size_t> head_;
+        char pad_[64];
+        std::atomic<size_t> tail_;
+
+    public:
+        Ring(size_t width, size_t capacity);
+
+        bool push(const Slot* record);
+
+        // Moves all pending records into per-column buffers:
+        size_t drain(std::vector<std::vector<Slot>>& columns);
+};
+
+class Log
+{
+    private:
+        const uint64_t id_;
+        const std::vector<Column> columns_;
+        const size_t ring_capacity_;
+
+        std::ofstream file_;
+
+        std::mutex rings_mutex_;
+        std::vector<std::unique_ptr<Ring>> rings_;
+
+        std::vector<std::vector<Slot>> block_;
+        std::vector<char> scratch_;
+
+        std::atomic<bool> running_;
+        std::thread writer_;
+
+        Ring& _ring();
+
+        bool _drain();
+        void _flush();
+        void _run();
+
+        void _push(const Slot* record);
+
+        static std::mutex registry_mutex_;
+        static std::map<std::string, std::shared_ptr<Log>> registry_;
+
+    public:
+        Log(const std::string& path, std::vector<Column> columns,
+            size_t ring_capacity = 1 << 14);
+        ~Log();
+
+        const std::vector<Column>& columns() const;
+
+        template<typename... Args>
+        void append(Args... args)
+        {
+            const Slot record[] = { pack(args)... };
+
+            if (sizeof...(Args) != columns_.size())
+                throw std::invalid_argument(
+                    "[binlog] Record does not match the log schema.");
+
+            _push(record);
+        }
+
+        // Named logs, shared by the modules that produce them. Registering
+        // an existing name returns the existing log:
+        static std::shared_ptr<Log> Register(const std::string& name,
+                                             const std::string& path,
+                                             std::vector<Column> columns);
+        static std::shared_ptr<Log> Get(const std::string& name);
+
+        // Flushes and closes all registered logs:
+        static void DropAll();
+};
+
+class Reader
+{
+    private:
+        std::ifstream file_;
+        std::vector<Column> columns_;
+
+        std::vector<char> scratch_;
+
+    public:
+        Reader(const std::string& path);
+
+        const std::vector<Column>& columns() const;
+
+        // Reads the next block of rows into per-column buffers:
+        bool next(std::vector<std::vector<Slot>>& block);
+};
+
+void ExportCSV(const std::string& bin_path, const std::string& csv_path);
+
+}
+
+#endif
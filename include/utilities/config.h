@@ -9,6 +9,9 @@ class Config: public YAML::Node
     public:
         Config(std::string file_path):
             YAML::Node(YAML::LoadFile(file_path)) {}
+
+        explicit Config(const YAML::Node& node):
+            YAML::Node(node) {}
 };
 
 #endif // CONFIG_H
@@ -28,6 +28,9 @@ class CSV
         void next(vector<string>& columns);
         void peek(vector<string>& columns);
         void skip(int n_lines = 1);
+
+        long tell();
+        void seek(long pos);
 };
 
 #endif
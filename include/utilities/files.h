@@ -2,9 +2,13 @@
 #define FILES_H
 
 #include <glob.h>
+#include <map>
+#include <tuple>
 #include <string>
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#include <unistd.h>
 #include <sys/stat.h>
 
 using std::string;
@@ -36,10 +40,11 @@ inline bool check_exists(string path)
         return true;
 }
 
-vector<std::tuple<string, string, string>> get_file_sample(
+inline vector<std::tuple<string, string, string>> get_file_sample(
     string md_dir,
     string tas_dir,
-    vector<string> symbols) {
+    vector<string> symbols,
+    string extension = "csv") {
 
     vector<std::tuple<string, string, string>> all_files;
     for (auto s : symbols) {
@@ -54,7 +59,7 @@ vector<std::tuple<string, string, string>> get_file_sample(
             throw runtime_error("No such directory: " + tas_s_dir);
 
         // Find all file paths:
-        auto files = glob(md_s_dir + "/*.csv");
+        auto files = glob(md_s_dir + "/*." + extension);
 
         for (auto f : files) {
             string tf = f;
@@ -75,7 +80,7 @@ vector<std::tuple<string, string, string>> get_file_sample(
     return all_files;
 }
 
-vector<std::tuple<string, string, string>> get_sample_window(
+inline vector<std::tuple<string, string, string>> get_sample_window(
     string md_dir, string tas_dir, string symbol, vector<string> search_patterns) {
 
     vector<std::tuple<string, string, string>> samples;
@@ -103,4 +108,59 @@ vector<std::tuple<string, string, string>> get_sample_window(
     return samples;
 }
 
+// The days of each symbol in date order, sorted once so that a session of
+// consecutive days can be looked up for every episode:
+class Sessions
+{
+    private:
+        typedef std::tuple<string, string, string> sample_t;
+
+        std::map<string, vector<sample_t>> days_;
+
+        // The position of a sample among the days of its symbol:
+        std::pair<const vector<sample_t>*, size_t> find(const sample_t& s) const
+        {
+            auto it = days_.find(std::get<0>(s));
+            if (it != days_.end()) {
+                auto& days = it->second;
+                auto d = std::lower_bound(days.begin(), days.end(), s);
+
+                if (d != days.end() and *d == s)
+                    return std::make_pair(&days, d - days.begin());
+            }
+
+            throw runtime_error("Unknown sample: " + std::get<1>(s));
+        }
+
+    public:
+        Sessions() {}
+
+        Sessions(const vector<sample_t>& samples)
+        {
+            for (auto& s : samples)
+                days_[std::get<0>(s)].push_back(s);
+
+            for (auto& d : days_)
+                std::sort(d.second.begin(), d.second.end());
+        }
+
+        // The samples of up to n consecutive days of the same symbol,
+        // starting with (and including) the given sample:
+        vector<sample_t> get(const sample_t& start, size_t n) const
+        {
+            auto pos = find(start);
+            auto first = pos.first->begin() + pos.second;
+
+            return vector<sample_t>(
+                first, first + std::min(n, pos.first->size() - pos.second));
+        }
+
+        // Whether the sample opens one of the sessions of n days that cover
+        // the days of its symbol without overlapping:
+        bool opens(const sample_t& s, size_t n) const
+        {
+            return find(s).second % n == 0;
+        }
+};
+
 #endif
@@ -0,0 +1,36 @@
+#ifndef UTILITIES_MAPPED_FILE_H
+#define UTILITIES_MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+// Read-only memory map of a whole file, for parsers that scan their input in
+// place instead of copying it line by line (see data::reuters, data::itch).
+class MappedFile
+{
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+
+        bool open_ = false;
+
+    public:
+        MappedFile() = default;
+        MappedFile(const std::string& file_path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        void openFile(const std::string& file_path);
+        void closeFile();
+
+        bool isOpen() const;
+
+        const char* data() const;
+        size_t size() const;
+
+        void swap(MappedFile& other);
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef UTILITIES_SERIALISE_H
+#define UTILITIES_SERIALISE_H
+
+#include <map>
+#include <array>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+// Minimal native-endian binary (de)serialisation helpers. These are only
+// intended for short-lived caches written and read by the same build.
+namespace serialise {
+
+template<typename T>
+inline void write(std::ostream& os, const T& val)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "serialise::write requires a trivially copyable type.");
+
+    os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template<typename T>
+inline void read(std::istream& is, T& val)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "serialise::read requires a trivially copyable type.");
+
+    if (not is.read(reinterpret_cast<char*>(&val), sizeof(T)))
+        throw std::runtime_error("[serialise] Unexpected end of stream.");
+}
+
+inline void write(std::ostream& os, const std::string& val)
+{
+    write(os, (uint64_t) val.size());
+    os.write(val.data(), val.size());
+}
+
+inline void read(std::istream& is, std::string& val)
+{
+    uint64_t n;
+    read(is, n);
+
+    val.resize(n);
+    if (n > 0 and not is.read(&val[0], n))
+        throw std::runtime_error("[serialise] Unexpected end of stream.");
+}
+
+template<typename T, size_t N>
+inline void write(std::ostream& os, const std::array<T, N>& val)
+{
+    for (auto& v : val) write(os, v);
+}
+
+template<typename T, size_t N>
+inline void read(std::istream& is, std::array<T, N>& val)
+{
+    for (auto& v : val) read(is, v);
+}
+
+template<typename T>
+inline void write(std::ostream& os, const std::vector<T>& val)
+{
+    write(os, (uint64_t) val.size());
+    for (auto& v : val) write(os, v);
+}
+
+template<typename T>
+inline void read(std::istream& is, std::vector<T>& val)
+{
+    uint64_t n;
+    read(is, n);
+
+    val.resize(n);
+    for (auto& v : val) read(is, v);
+}
+
+template<typename T>
+inline void write(std::ostream& os, const std::deque<T>& val)
+{
+    write(os, (uint64_t) val.size());
+    for (auto& v : val) write(os, v);
+}
+
+template<typename T>
+inline void read(std::istream& is, std::deque<T>& val)
+{
+    uint64_t n;
+    read(is, n);
+
+    val.resize(n);
+    for (auto& v : val) read(is, v);
+}
+
+template<typename K, typename V, typename C>
+inline void write(std::ostream& os, const std::map<K, V, C>& val)
+{
+    write(os, (uint64_t) val.size());
+    for (auto& kv : val) {
+        write(os, kv.first);
+        write(os, kv.second);
+    }
+}
+
+template<typename K, typename V, typename C>
+inline void read(std::istream& is, std::map<K, V, C>& val)
+{
+    uint64_t n;
+    read(is, n);
+
+    val.clear();
+    for (uint64_t i = 0; i < n; i++) {
+        K k; V v;
+        read(is, k);
+        read(is, v);
+
+        val.emplace_hint(val.end(), k, v);
+    }
+}
+
+}
+
+#endif
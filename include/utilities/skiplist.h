@@ -0,0 +1,61 @@
+#ifndef UTILITIES_SKIPLIST_H
+#define UTILITIES_SKIPLIST_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Indexable skiplist (order-statistics container) with O(log n) insert,
+// remove and rank queries. All nodes live in a pool sized at construction so
+// that no allocation takes place once the container is in use.
+//
+// See: R. Hettinger, "Efficient Running Median using an Indexable Skiplist",
+//      ActiveState recipe 576930.
+template <typename T>
+class IndexableSkiplist
+{
+    private:
+        static const int NIL = -1;
+        static const int HEAD = 0;
+
+        const size_t capacity_;
+        const int max_levels_;
+
+        size_t size_;
+
+        std::vector<T> values_;
+        std::vector<int> levels_;
+        std::vector<int> next_;
+        std::vector<size_t> width_;
+
+        std::vector<int> free_;
+
+        std::vector<int> chain_;
+        std::vector<size_t> steps_;
+
+        uint64_t rng_state_;
+
+        int random_level();
+
+        inline int& next(int node, int level);
+        inline size_t& width(int node, int level);
+
+    public:
+        IndexableSkiplist(size_t capacity);
+
+        void insert(T val);
+        bool remove(T val);
+
+        // Returns the i'th smallest element (zero-indexed):
+        T at(size_t i);
+
+        // Linearly interpolated quantile, q in [0, 1]:
+        T quantile(double q);
+
+        void clear();
+
+        bool empty();
+        size_t size();
+};
+
+#endif
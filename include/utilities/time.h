@@ -1,47 +1,74 @@
 #ifndef TIME_H
 #define TIME_H
 
+#include <cmath>
+#include <cctype>
 #include <string>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 
-static long add_hours(long update, long time)
+// Times of day are in ns since midnight, so that feeds stamped to the µs or
+// ns keep their order; dates are kept alongside as yyyymmdd:
+static const long NS_PER_MS = 1000000L;
+static const long NS_PER_S = 1000L * NS_PER_MS;
+static const long NS_PER_MIN = 60L * NS_PER_S;
+static const long NS_PER_HOUR = 60L * NS_PER_MIN;
+
+inline long add_hours(long update, long time)
 {
-    return time + update*3600000;
+    return time + update*NS_PER_HOUR;
 }
 
-static long add_minutes(long update, long time)
+inline long add_minutes(long update, long time)
 {
-    return time + update*60000;
+    return time + update*NS_PER_MIN;
 }
 
-static long add_seconds(long update, long time)
+inline long add_seconds(long update, long time)
 {
-    return time + update*1000;
+    return time + update*NS_PER_S;
 }
 
-static long add_millis(long update, long time)
+inline long add_millis(long update, long time)
 {
-    return time + update;
+    return time + update*NS_PER_MS;
 }
 
-static long string_to_time(std::string s)
+// Durations configured in (fractional) ms:
+inline long millis_to_time(double ms)
 {
-    int hour = stoi(s.substr(0, 2)),
-        min = stoi(s.substr(3, 2)),
-        sec = stoi(s.substr(6, 2)),
-        mil = stoi(s.substr(9, 3));
-
-    return add_hours(hour,
-                     add_minutes(min,
-                                 add_seconds(sec,
-                                             add_millis(mil, 0))));
+    return (long) std::llround(ms * NS_PER_MS);
 }
 
-static std::string time_to_string(long t)
+// HH:MM:SS with an optional fraction of up to 9 digits (ms, µs or ns):
+inline long parse_time(const char* p, size_t n)
+{
+    if (n < 8 or p[2] != ':' or p[5] != ':')
+        throw std::runtime_error("Invalid time: " + std::string(p, n));
+
+    long t = add_hours(10 * (p[0] - '0') + (p[1] - '0'),
+                       add_minutes(10 * (p[3] - '0') + (p[4] - '0'),
+                                   add_seconds(10 * (p[6] - '0') + (p[7] - '0'), 0)));
+
+    long scale = NS_PER_S / 10;
+    for (size_t i = 9; i < n and scale > 0 and std::isdigit(p[i]); i++, scale /= 10)
+        t += scale * (p[i] - '0');
+
+    return t;
+}
+
+inline long string_to_time(const std::string& s)
+{
+    return parse_time(s.data(), s.size());
+}
+
+inline std::string time_to_string(long t)
 {
     int mil, sec, min;
 
+    t /= NS_PER_MS;
+
     mil = t % 1000;
     t /= 1000;
 
@@ -0,0 +1,64 @@
+#ifndef UTILITIES_TURNSTILE_H
+#define UTILITIES_TURNSTILE_H
+
+#include <mutex>
+#include <vector>
+#include <condition_variable>
+
+// Threads 0..n-1 taking turns in that order, so that work they share is done
+// in the same order on every run. A thread waits for its first turn, passes
+// each turn on with Next() and must Leave() once it is done:
+class Turnstile
+{
+    private:
+        std::mutex mutex_;
+        std::condition_variable turned_;
+
+        std::vector<bool> active_;
+        int turn_ = 0;
+
+        // To the next thread still taking turns, if any:
+        void advance()
+        {
+            for (size_t i = 0; i < active_.size(); i++) {
+                turn_ = (turn_ + 1) % active_.size();
+
+                if (active_[turn_])
+                    break;
+            }
+        }
+
+    public:
+        Turnstile(int n_threads):
+            active_(n_threads, true)
+        {}
+
+        void Wait(int id)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            turned_.wait(lock, [&]() { return turn_ == id; });
+        }
+
+        void Next(int id)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            advance();
+            turned_.notify_all();
+
+            turned_.wait(lock, [&]() { return turn_ == id; });
+        }
+
+        void Leave(int id)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            active_[id] = false;
+            if (turn_ == id)
+                advance();
+
+            turned_.notify_all();
+        }
+};
+
+#endif
@@ -1,7 +1,13 @@
 #include "data/basic.h"
 #include "utilities/time.h"
+#include "data/time_index.h"
+#include "utilities/serialise.h"
 
+#include <fstream>
+#include <utility>
 #include <iostream>
+#include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 using namespace data::basic;
@@ -24,22 +30,48 @@ void MarketDepth::LoadCSV(string path)
     csv_.openFile(path);
     csv_.skip(1);        // Ignore header
 
+    path_ = path;
+
     LoadNext();
 }
 
 bool MarketDepth::_LoadRow()
 {
-    while (row_.size() != 22) {
+    // Compacted files carry an extra column:
+    while (row_.size() != REPEATS and row_.size() != REPEATS + 1) {
         if (not csv_.hasData())
             return false;
 
+        row_.clear();
         csv_.next(row_);
     }
 
-    if (row_.size() == 22)
-        return true;
-    else
-        return false;
+    return true;
+}
+
+bool MarketDepth::_IsRepeat()
+{
+    return last_row_.size() > BV5 and
+        equal(row_.begin() + AP1, row_.begin() + BV5 + 1,
+              last_row_.begin() + AP1);
+}
+
+void MarketDepth::_ParseRepeats()
+{
+    const string& col = row_.at(REPEATS);
+    long time = record_next.time;
+
+    size_t pos = 0;
+    while (pos < col.size()) {
+        size_t next = col.find(';', pos);
+        if (next == string::npos)
+            next = col.size();
+
+        time += stol(col.substr(pos, next - pos));
+        repeats_.push_back(time);
+
+        pos = next + 1;
+    }
 }
 
 bool MarketDepth::_ParseRow()
@@ -47,21 +79,39 @@ bool MarketDepth::_ParseRow()
     record_next.date = stoi(row_.at(DATE));
     record_next.time = string_to_time(row_.at(TIME));
 
-    for (int i = 0; i < 5; i++) {
-        double nap = stof(row_.at(AP1 + i)),
-               nbp = stof(row_.at(BP1 + i));
+    bool repeat = _IsRepeat();
+    if (repeat) {
+        record_next.ask_prices = last_record_.ask_prices;
+        record_next.ask_volumes = last_record_.ask_volumes;
 
-        if (nap <= 0.0 or nbp <= 0.0) {
-            row_.clear();
+        record_next.bid_prices = last_record_.bid_prices;
+        record_next.bid_volumes = last_record_.bid_volumes;
 
-            return false;
+    } else {
+        for (int i = 0; i < 5; i++) {
+            double nap = stof(row_.at(AP1 + i)),
+                   nbp = stof(row_.at(BP1 + i));
+
+            if (nap <= 0.0 or nbp <= 0.0) {
+                row_.clear();
+
+                return false;
+            }
+
+            record_next.ask_prices[i] = nap;
+            record_next.ask_volumes[i] = stol(row_.at(AV1 + i));
+
+            record_next.bid_prices[i] = nbp;
+            record_next.bid_volumes[i] = stol(row_.at(BV1 + i));
         }
+    }
 
-        record_next.ask_prices[i] = nap;
-        record_next.ask_volumes[i] = stol(row_.at(AV1 + i));
+    if (row_.size() > REPEATS)
+        _ParseRepeats();
 
-        record_next.bid_prices[i] = nbp;
-        record_next.bid_volumes[i] = stol(row_.at(BV1 + i));
+    if (not repeat) {
+        last_record_ = record_next;
+        swap(row_, last_row_);
     }
 
     row_.clear();
@@ -71,6 +121,17 @@ bool MarketDepth::_ParseRow()
 
 bool MarketDepth::_LoadNext()
 {
+    // Expand the repeats of the last row first:
+    if (not repeats_.empty()) {
+        long time = repeats_.front();
+        repeats_.pop_front();
+
+        record_next = last_record_;
+        record_next.time = time;
+
+        return true;
+    }
+
     if (not csv_.isOpen())
         return false;
 
@@ -87,6 +148,9 @@ bool MarketDepth::_LoadNext()
 
 long MarketDepth::_TimeLookAhead()
 {
+    if (not repeats_.empty())
+        return repeats_.front();
+
     if (not _LoadRow())
         return -1;
     else
@@ -99,6 +163,13 @@ void MarketDepth::Reset()
 
     csv_.closeFile();
     row_.clear();
+
+    last_row_.clear();
+    repeats_.clear();
+
+    next_csv_.closeFile();
+    queue_.clear();
+    switched_ = false;
 }
 
 void MarketDepth::SkipN(long n)
@@ -106,6 +177,171 @@ void MarketDepth::SkipN(long n)
     csv_.skip(n);
 }
 
+bool MarketDepth::Save(std::ostream& os)
+{
+    // Positions are only meaningful within the first file of a session:
+    if (switched_)
+        return false;
+
+    long pos = csv_.tell();
+    if (pos < 0)
+        return false;
+
+    serialise::write(os, pos);
+    serialise::write(os, row_);
+
+    serialise::write(os, last_row_);
+    last_record_.save(os);
+    serialise::write(os, repeats_);
+
+    return Streamer::Save(os);
+}
+
+void MarketDepth::Load(std::istream& is)
+{
+    long pos;
+    serialise::read(is, pos);
+    serialise::read(is, row_);
+
+    serialise::read(is, last_row_);
+    last_record_.load(is);
+    serialise::read(is, repeats_);
+
+    csv_.seek(pos);
+
+    Streamer::Load(is);
+}
+
+void MarketDepth::QueueFile(string path)
+{
+    if (next_csv_.isOpen())
+        queue_.push_back(path);
+
+    else {
+        next_csv_.openFile(path);
+        next_csv_.skip(1);
+
+        next_path_ = path;
+    }
+}
+
+bool MarketDepth::NextFile()
+{
+    if (not next_csv_.isOpen())
+        return false;
+
+    Streamer::Reset();
+    row_.clear();
+
+    last_row_.clear();
+    repeats_.clear();
+
+    swap(csv_, next_csv_);
+    next_csv_.closeFile();
+
+    path_ = next_path_;
+
+    // Open the following file now so the next switch is free:
+    if (not queue_.empty()) {
+        next_csv_.openFile(queue_.front());
+        next_csv_.skip(1);
+
+        next_path_ = queue_.front();
+        queue_.pop_front();
+    }
+
+    switched_ = true;
+
+    LoadNext();
+
+    return true;
+}
+
+bool MarketDepth::SeekTime(long time)
+{
+    auto index = TimeIndex::Get(path_);
+
+    Streamer::Reset();
+    row_.clear();
+
+    last_row_.clear();
+    repeats_.clear();
+
+    csv_.seek(index->Find(time));
+    LoadNext();
+
+    return SkipUntil(index->date(), time);
+}
+
+long data::basic::CompactCSV(const string& in_path, const string& out_path)
+{
+    CSV csv(in_path);
+    ofstream ofs(out_path);
+
+    if (not ofs.is_open())
+        throw runtime_error("[CompactCSV] Failed to open file: " + out_path);
+
+    vector<string> row, kept;
+    string repeats;
+    long last_time = 0, n_rows = 0;
+
+    auto write_row = [&ofs](const vector<string>& cols) {
+        for (size_t i = 0; i < cols.size(); i++)
+            ofs << (i > 0 ? "," : "") << cols[i];
+    };
+
+    auto flush = [&]() {
+        if (kept.empty()) return;
+
+        write_row(kept);
+        if (not repeats.empty())
+            ofs << "," << repeats;
+        ofs << "\n";
+
+        n_rows++;
+    };
+
+    csv.next(row);
+    write_row(row);
+    ofs << ",repeats\n";
+
+    while (csv.hasData()) {
+        row.clear();
+        csv.next(row);
+
+        // Keep exactly the rows that MarketDepth would replay:
+        if (row.size() != 22)
+            continue;
+
+        bool valid = true;
+        for (int i = 0; i < 5; i++)
+            if (stof(row[2 + i]) <= 0.0 or stof(row[12 + i]) <= 0.0)
+                valid = false;
+
+        if (not valid)
+            continue;
+
+        long time = string_to_time(row[1]);
+
+        if (not kept.empty() and row[0] == kept[0] and
+            equal(row.begin() + 2, row.end(), kept.begin() + 2)) {
+            repeats += (repeats.empty() ? "" : ";") + to_string(time - last_time);
+
+        } else {
+            flush();
+
+            swap(row, kept);
+            repeats.clear();
+        }
+
+        last_time = time;
+    }
+
+    flush();
+
+    return n_rows;
+}
+
 // ------------------------------------------------------------------
 
 TimeAndSales::TimeAndSales():
@@ -127,6 +363,8 @@ void TimeAndSales::LoadCSV(string path)
     csv_.openFile(path);
     csv_.skip(1);
 
+    path_ = path;
+
     LoadNext();
 }
 
@@ -194,9 +432,95 @@ void TimeAndSales::Reset()
 
     csv_.closeFile();
     row_.clear();
+
+    next_csv_.closeFile();
+    queue_.clear();
+    switched_ = false;
 }
 
 void TimeAndSales::SkipN(long n)
 {
     csv_.skip(n);
 }
+
+bool TimeAndSales::Save(std::ostream& os)
+{
+    // Positions are only meaningful within the first file of a session:
+    if (switched_)
+        return false;
+
+    long pos = csv_.tell();
+    if (pos < 0)
+        return false;
+
+    serialise::write(os, pos);
+    serialise::write(os, row_);
+
+    return Streamer::Save(os);
+}
+
+void TimeAndSales::Load(std::istream& is)
+{
+    long pos;
+    serialise::read(is, pos);
+    serialise::read(is, row_);
+
+    csv_.seek(pos);
+
+    Streamer::Load(is);
+}
+
+void TimeAndSales::QueueFile(string path)
+{
+    if (next_csv_.isOpen())
+        queue_.push_back(path);
+
+    else {
+        next_csv_.openFile(path);
+        next_csv_.skip(1);
+
+        next_path_ = path;
+    }
+}
+
+bool TimeAndSales::NextFile()
+{
+    if (not next_csv_.isOpen())
+        return false;
+
+    Streamer::Reset();
+    row_.clear();
+
+    swap(csv_, next_csv_);
+    next_csv_.closeFile();
+
+    path_ = next_path_;
+
+    // Open the following file now so the next switch is free:
+    if (not queue_.empty()) {
+        next_csv_.openFile(queue_.front());
+        next_csv_.skip(1);
+
+        next_path_ = queue_.front();
+        queue_.pop_front();
+    }
+
+    switched_ = true;
+
+    LoadNext();
+
+    return true;
+}
+
+bool TimeAndSales::SeekTime(long time)
+{
+    auto index = TimeIndex::Get(path_);
+
+    Streamer::Reset();
+    row_.clear();
+
+    csv_.seek(index->Find(time));
+    LoadNext();
+
+    return SkipUntil(index->date(), time);
+}
@@ -0,0 +1,149 @@
+#include "data/downsampled.h"
+#include "data/basic.h"
+#include "data/itch.h"
+#include "data/reuters.h"
+#include "utilities/time.h"
+
+#include <stdexcept>
+
+using namespace std;
+using namespace data;
+
+void data::merge(MarketDepthRecord& into, const MarketDepthRecord& rec)
+{
+    into = rec;
+}
+
+void data::merge(TimeAndSalesRecord& into, const TimeAndSalesRecord& rec)
+{
+    into.date = rec.date;
+    into.time = rec.time;
+
+    for (auto& kv : rec.transactions)
+        into.transactions[kv.first] += kv.second;
+}
+
+template<class S>
+Downsampled<S>::Downsampled(long resolution):
+    Interface(),
+
+    source_()
+{
+    SetResolution(resolution);
+}
+
+template<class S>
+void Downsampled<S>::SetResolution(long ms)
+{
+    if (ms <= 0)
+        throw invalid_argument("[Downsampled] Resolution must be positive.");
+
+    resolution_ = add_millis(ms, 0);
+}
+
+template<class S>
+long Downsampled<S>::_BucketEnd(long time)
+{
+    return (time / resolution_ + 1) * resolution_;
+}
+
+template<class S>
+bool Downsampled<S>::_LoadNext()
+{
+    // The source's next record is the first of the bucket:
+    int date = source_.NextDate();
+    if (date == 0)
+        return false;
+
+    long end = _BucketEnd(source_.NextTime());
+
+    while (source_.NextDate() == date and source_.NextTime() < end) {
+        source_.LoadNext();
+
+        merge(this->record_next, source_.Record());
+    }
+
+    // Stamp with the time at which the bucket is complete:
+    this->record_next.time = end;
+
+    return true;
+}
+
+template<class S>
+long Downsampled<S>::_TimeLookAhead()
+{
+    if (source_.NextDate() == 0)
+        return -1;
+
+    return _BucketEnd(source_.NextTime());
+}
+
+template<class S>
+void Downsampled<S>::LoadCSV(string path)
+{
+    Interface::Reset();
+
+    source_.LoadCSV(path);
+
+    this->LoadNext();
+}
+
+template<class S>
+void Downsampled<S>::Reset()
+{
+    Interface::Reset();
+
+    source_.Reset();
+}
+
+template<class S>
+void Downsampled<S>::SkipN(long n)
+{
+    source_.SkipN(n);
+}
+
+template<class S>
+bool Downsampled<S>::Save(ostream&)
+{
+    return false;
+}
+
+template<class S>
+void Downsampled<S>::QueueFile(string path)
+{
+    source_.QueueFile(path);
+}
+
+template<class S>
+bool Downsampled<S>::NextFile()
+{
+    if (not source_.NextFile())
+        return false;
+
+    Interface::Reset();
+
+    this->LoadNext();
+
+    return true;
+}
+
+template<class S>
+bool Downsampled<S>::SeekTime(long time)
+{
+    if (not source_.SeekTime(time))
+        return false;
+
+    Interface::Reset();
+
+    this->LoadNext();
+
+    return true;
+}
+
+// Template specialisations:
+template class data::Downsampled<data::basic::MarketDepth>;
+template class data::Downsampled<data::basic::TimeAndSales>;
+template class data::Downsampled<data::reuters::MarketDepth>;
+template class data::Downsampled<data::reuters::TimeAndSales>;
+template class data::Downsampled<data::itch::MarketDepth>;
+template class data::Downsampled<data::itch::TimeAndSales>;
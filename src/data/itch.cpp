@@ -0,0 +1,820 @@
+#include "data/itch.h"
+#include "utilities/serialise.h"
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace data::itch;
+
+static_assert(sizeof(Header) == 11, "Unexpected ITCH header layout.");
+static_assert(sizeof(AddOrder) == 36, "Unexpected ITCH add layout.");
+static_assert(sizeof(OrderExecuted) == 31, "Unexpected ITCH execute layout.");
+static_assert(sizeof(OrderExecutedWithPrice) == 36,
+              "Unexpected ITCH execute with price layout.");
+static_assert(sizeof(OrderCancel) == 23, "Unexpected ITCH cancel layout.");
+static_assert(sizeof(OrderDelete) == 19, "Unexpected ITCH delete layout.");
+static_assert(sizeof(OrderReplace) == 35, "Unexpected ITCH replace layout.");
+static_assert(sizeof(Trade) == 44, "Unexpected ITCH trade layout.");
+
+// Big-endian fields to host order:
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static inline uint16_t be(uint16_t v) { return v; }
+static inline uint32_t be(uint32_t v) { return v; }
+static inline uint64_t be(uint64_t v) { return v; }
+#else
+static inline uint16_t be(uint16_t v) { return __builtin_bswap16(v); }
+static inline uint32_t be(uint32_t v) { return __builtin_bswap32(v); }
+static inline uint64_t be(uint64_t v) { return __builtin_bswap64(v); }
+#endif
+
+static inline long be48(const uint8_t* p)
+{
+    return ((long) p[0] << 40) | ((long) p[1] << 32) | ((long) p[2] << 24) |
+        ((long) p[3] << 16) | ((long) p[4] << 8) | (long) p[5];
+}
+
+// The trading date in a file name (its last 8 consecutive digits):
+static int date_from_path(const string& path)
+{
+    size_t start = path.find_last_of('/');
+    start = (start == string::npos) ? 0 : start + 1;
+
+    int date = 0, n = 0;
+    for (size_t i = start; i < path.size(); i++) {
+        if (isdigit(path[i])) {
+            if (++n == 8) date = stoi(path.substr(i - 7, 8));
+        } else
+            n = 0;
+    }
+
+    if (date == 0)
+        throw runtime_error("[ITCH] No date in file name: " + path);
+
+    return date;
+}
+
+// Data is laid out as <dir>/<symbol>/<file>:
+static string symbol_from_path(const string& path)
+{
+    size_t end = path.find_last_of('/');
+    if (end == string::npos or end == 0)
+        throw runtime_error("[ITCH] No symbol directory: " + path);
+
+    size_t start = path.find_last_of('/', end - 1);
+    start = (start == string::npos) ? 0 : start + 1;
+
+    return path.substr(start, end - start);
+}
+
+// ------------------------------------------------------------------
+void Reader::Open(const string& path, const string& symbol)
+{
+    file_.openFile(path);
+    pos_ = 0;
+
+    string stock = symbol.substr(0, symbol.find_first_of('.'));
+    memset(stock_, ' ', sizeof(stock_));
+    memcpy(stock_, stock.data(), min(stock.size(), sizeof(stock_)));
+
+    locate_ = -1;
+}
+
+void Reader::Close()
+{
+    file_.closeFile();
+
+    pos_ = 0;
+    locate_ = -1;
+}
+
+bool Reader::IsOpen() const
+{
+    return file_.isOpen();
+}
+
+bool Reader::Next(OrderEvent& ev)
+{
+    const char* data = file_.data();
+    const size_t size = file_.size();
+
+    while (pos_ + 2 <= size) {
+        uint16_t prefix;
+        memcpy(&prefix, data + pos_, sizeof(prefix));
+
+        size_t len = be(prefix);
+        const char* m = data + pos_ + 2;
+
+        if (pos_ + 2 + len > size or len < sizeof(Header))
+            throw runtime_error("[ITCH] Truncated message at byte " +
+                                to_string(pos_) + ".");
+
+        pos_ += 2 + len;
+
+        const Header* h = reinterpret_cast<const Header*>(m);
+
+        // The locate code is compared as it is on the wire:
+        if (locate_ >= 0 and h->locate != locate_)
+            continue;
+
+        switch (h->type) {
+            case 'R': {
+                auto r = reinterpret_cast<const StockDirectory*>(m);
+                if (len >= sizeof(StockDirectory) and
+                    memcmp(r->stock, stock_, sizeof(stock_)) == 0)
+                    locate_ = h->locate;
+
+                continue;
+            }
+
+            case 'A':
+            case 'F': {
+                if (len < sizeof(AddOrder))
+                    throw runtime_error("[ITCH] Invalid add order message.");
+
+                auto a = reinterpret_cast<const AddOrder*>(m);
+                if (locate_ < 0) {
+                    if (memcmp(a->stock, stock_, sizeof(stock_)) != 0)
+                        continue;
+
+                    locate_ = h->locate;
+                }
+
+                ev.type = OrderEvent::ADD;
+                ev.ref = be(a->ref);
+                ev.side = a->side;
+                ev.shares = be(a->shares);
+                ev.price = be(a->price);
+
+                break;
+            }
+
+            case 'P': {
+                if (len < sizeof(Trade))
+                    throw runtime_error("[ITCH] Invalid trade message.");
+
+                auto t = reinterpret_cast<const Trade*>(m);
+                if (locate_ < 0) {
+                    if (memcmp(t->stock, stock_, sizeof(stock_)) != 0)
+                        continue;
+
+                    locate_ = h->locate;
+                }
+
+                ev.type = OrderEvent::TRADE;
+                ev.ref = be(t->ref);
+                ev.side = t->side;
+                ev.shares = be(t->shares);
+                ev.price = be(t->price);
+                ev.printable = true;
+
+                break;
+            }
+
+            case 'E':
+            case 'C': {
+                if (locate_ < 0) continue;
+                if (len < (h->type == 'E' ? sizeof(OrderExecuted) :
+                           sizeof(OrderExecutedWithPrice)))
+                    throw runtime_error("[ITCH] Invalid execute message.");
+
+                auto e = reinterpret_cast<const OrderExecuted*>(m);
+                ev.type = OrderEvent::EXECUTE;
+                ev.ref = be(e->ref);
+                ev.shares = be(e->shares);
+
+                if (h->type == 'E') {
+                    ev.price = 0;
+                    ev.printable = true;
+
+                } else {
+                    auto c = reinterpret_cast<const OrderExecutedWithPrice*>(m);
+                    ev.price = be(c->price);
+                    ev.printable = (c->printable == 'Y');
+                }
+
+                break;
+            }
+
+            case 'X': {
+                if (locate_ < 0) continue;
+                if (len < sizeof(OrderCancel))
+                    throw runtime_error("[ITCH] Invalid cancel message.");
+
+                auto x = reinterpret_cast<const OrderCancel*>(m);
+                ev.type = OrderEvent::CANCEL;
+                ev.ref = be(x->ref);
+                ev.shares = be(x->shares);
+
+                break;
+            }
+
+            case 'D': {
+                if (locate_ < 0) continue;
+                if (len < sizeof(OrderDelete))
+                    throw runtime_error("[ITCH] Invalid delete message.");
+
+                ev.type = OrderEvent::DELETE;
+                ev.ref = be(reinterpret_cast<const OrderDelete*>(m)->ref);
+
+                break;
+            }
+
+            case 'U': {
+                if (locate_ < 0) continue;
+                if (len < sizeof(OrderReplace))
+                    throw runtime_error("[ITCH] Invalid replace message.");
+
+                auto u = reinterpret_cast<const OrderReplace*>(m);
+                ev.type = OrderEvent::REPLACE;
+                ev.ref = be(u->ref);
+                ev.new_ref = be(u->new_ref);
+                ev.shares = be(u->shares);
+                ev.price = be(u->price);
+
+                break;
+            }
+
+            default:
+                continue;
+        }
+
+        ev.time = be48(h->timestamp);
+
+        return true;
+    }
+
+    return false;
+}
+
+size_t Reader::Tell() const
+{
+    return pos_;
+}
+
+void Reader::Seek(size_t pos)
+{
+    pos_ = pos;
+}
+
+bool Reader::Save(std::ostream& os) const
+{
+    serialise::write(os, (uint64_t) pos_);
+    serialise::write(os, locate_);
+
+    return true;
+}
+
+void Reader::Load(std::istream& is)
+{
+    uint64_t pos;
+    serialise::read(is, pos);
+    serialise::read(is, locate_);
+
+    pos_ = pos;
+}
+
+// ------------------------------------------------------------------
+void OrderBook::_Add(uint64_t ref, const Order& o)
+{
+    orders_[ref] = o;
+
+    if (o.side == 'B')
+        bids_[o.price] += o.shares;
+    else
+        asks_[o.price] += o.shares;
+}
+
+void OrderBook::_Reduce(unordered_map<uint64_t, Order>::iterator it,
+                        long shares)
+{
+    Order& o = it->second;
+
+    if (o.side == 'B') {
+        auto l = bids_.find(o.price);
+        if ((l->second -= shares) <= 0) bids_.erase(l);
+
+    } else {
+        auto l = asks_.find(o.price);
+        if ((l->second -= shares) <= 0) asks_.erase(l);
+    }
+
+    if ((o.shares -= shares) <= 0)
+        orders_.erase(it);
+}
+
+bool OrderBook::_IsVisible(char side, uint32_t price) const
+{
+    // Fewer than DEPTH levels are better than the price:
+    int n = 0;
+    if (side == 'B') {
+        for (auto it = bids_.begin(); it != bids_.end() and it->first > price; ++it)
+            if (++n == DEPTH) return false;
+
+    } else {
+        for (auto it = asks_.begin(); it != asks_.end() and it->first < price; ++it)
+            if (++n == DEPTH) return false;
+    }
+
+    return true;
+}
+
+bool OrderBook::Apply(const OrderEvent& ev, Fill& fill)
+{
+    fill.shares = 0;
+
+    if (ev.type == OrderEvent::ADD) {
+        _Add(ev.ref, {ev.side, ev.price, ev.shares});
+
+        return _IsVisible(ev.side, ev.price);
+
+    } else if (ev.type == OrderEvent::TRADE) {
+        // Hidden liquidity; the book is unchanged:
+        fill.price = ev.price;
+        fill.shares = ev.shares;
+
+        return false;
+    }
+
+    // Orders placed before the start of the file are unknown:
+    auto it = orders_.find(ev.ref);
+    if (it == orders_.end())
+        return false;
+
+    Order o = it->second;
+    bool visible = _IsVisible(o.side, o.price);
+
+    switch (ev.type) {
+        case OrderEvent::EXECUTE:
+            if (ev.printable) {
+                fill.price = (ev.price > 0) ? ev.price : o.price;
+                fill.shares = min(ev.shares, o.shares);
+            }
+
+            _Reduce(it, min(ev.shares, o.shares));
+            break;
+
+        case OrderEvent::CANCEL:
+            _Reduce(it, min(ev.shares, o.shares));
+            break;
+
+        case OrderEvent::DELETE:
+            _Reduce(it, o.shares);
+            break;
+
+        case OrderEvent::REPLACE:
+            _Reduce(it, o.shares);
+            _Add(ev.new_ref, {o.side, ev.price, ev.shares});
+
+            visible = visible or _IsVisible(o.side, ev.price);
+            break;
+    }
+
+    return visible;
+}
+
+bool OrderBook::Snapshot(MarketDepthRecord& rec) const
+{
+    if (asks_.size() < DEPTH or bids_.size() < DEPTH)
+        return false;
+
+    auto a = asks_.begin();
+    auto b = bids_.begin();
+    for (int l = 0; l < DEPTH; l++, ++a, ++b) {
+        rec.ask_prices[l] = to_price(a->first);
+        rec.ask_volumes[l] = a->second;
+
+        rec.bid_prices[l] = to_price(b->first);
+        rec.bid_volumes[l] = b->second;
+    }
+
+    return true;
+}
+
+void OrderBook::Clear()
+{
+    orders_.clear();
+
+    bids_.clear();
+    asks_.clear();
+}
+
+void OrderBook::Save(std::ostream& os) const
+{
+    serialise::write(os, (uint64_t) orders_.size());
+    for (auto& kv : orders_) {
+        serialise::write(os, kv.first);
+        serialise::write(os, kv.second);
+    }
+}
+
+void OrderBook::Load(std::istream& is)
+{
+    Clear();
+
+    uint64_t n;
+    serialise::read(is, n);
+
+    orders_.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t ref;
+        Order o;
+
+        serialise::read(is, ref);
+        serialise::read(is, o);
+
+        _Add(ref, o);
+    }
+}
+
+// ------------------------------------------------------------------
+void OrderPrices::Apply(const OrderEvent& ev, Fill& fill)
+{
+    fill.shares = 0;
+
+    switch (ev.type) {
+        case OrderEvent::ADD:
+            orders_[ev.ref] = {ev.price, ev.shares};
+            return;
+
+        case OrderEvent::TRADE:
+            // Hidden liquidity:
+            fill.price = ev.price;
+            fill.shares = ev.shares;
+            return;
+    }
+
+    // Orders placed before the start of the file are unknown:
+    auto it = orders_.find(ev.ref);
+    if (it == orders_.end())
+        return;
+
+    Order& o = it->second;
+    long shares = o.shares;
+
+    switch (ev.type) {
+        case OrderEvent::EXECUTE:
+            shares = min(ev.shares, o.shares);
+
+            if (ev.printable) {
+                fill.price = (ev.price > 0) ? ev.price : o.price;
+                fill.shares = shares;
+            }
+            break;
+
+        case OrderEvent::CANCEL:
+            shares = min(ev.shares, o.shares);
+            break;
+
+        case OrderEvent::REPLACE:
+            orders_.erase(it);
+            orders_[ev.new_ref] = {ev.price, ev.shares};
+            return;
+    }
+
+    if ((o.shares -= shares) <= 0)
+        orders_.erase(it);
+}
+
+void OrderPrices::Clear()
+{
+    orders_.clear();
+}
+
+void OrderPrices::Save(std::ostream& os) const
+{
+    serialise::write(os, (uint64_t) orders_.size());
+    for (auto& kv : orders_) {
+        serialise::write(os, kv.first);
+        serialise::write(os, kv.second);
+    }
+}
+
+void OrderPrices::Load(std::istream& is)
+{
+    Clear();
+
+    uint64_t n;
+    serialise::read(is, n);
+
+    orders_.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        uint64_t ref;
+        Order o;
+
+        serialise::read(is, ref);
+        serialise::read(is, o);
+
+        orders_[ref] = o;
+    }
+}
+
+// ------------------------------------------------------------------
+MarketDepth::MarketDepth():
+    data::MarketDepth(),
+
+    reader_(),
+    orders_(),
+    next_(),
+    book_()
+{
+    book_.clear();
+}
+
+MarketDepth::MarketDepth(string file_path):
+    MarketDepth()
+{
+    LoadCSV(file_path);
+}
+
+void MarketDepth::_Open(const string& path)
+{
+    reader_.Open(path, symbol_from_path(path));
+    date_ = date_from_path(path);
+
+    // Each day starts from an empty book:
+    orders_.Clear();
+    has_next_ = false;
+
+    book_.clear();
+    pending_ = false;
+}
+
+void MarketDepth::LoadCSV(string path)
+{
+    Reset();
+
+    _Open(path);
+
+    LoadNext();
+}
+
+bool MarketDepth::_Peek()
+{
+    Fill fill;
+    bool changed = false;
+
+    // Events with the same time stamp (e.g. the fills of one aggressive
+    // order) make up one update, and only changes to the visible levels make
+    // a new record:
+    while (not pending_) {
+        if (not has_next_ and not (has_next_ = reader_.Next(next_)))
+            return false;
+
+        long time = next_.time;
+        changed = orders_.Apply(next_, fill) or changed;
+
+        has_next_ = reader_.Next(next_);
+        if (has_next_ and next_.time == time)
+            continue;
+
+        if (changed and orders_.Snapshot(book_)) {
+            book_.date = date_;
+            book_.time = time;
+
+            pending_ = true;
+        }
+
+        changed = false;
+    }
+
+    return true;
+}
+
+bool MarketDepth::_LoadNext()
+{
+    if (not _Peek())
+        return false;
+
+    record_next = book_;
+    pending_ = false;
+
+    return true;
+}
+
+long MarketDepth::_TimeLookAhead()
+{
+    return _Peek() ? book_.time : -1;
+}
+
+void MarketDepth::Reset()
+{
+    Streamer::Reset();
+
+    reader_.Close();
+    orders_.Clear();
+    has_next_ = false;
+
+    book_.clear();
+    pending_ = false;
+
+    queue_.clear();
+    switched_ = false;
+}
+
+void MarketDepth::SkipN(long n)
+{
+    // The book still follows the skipped updates:
+    for (long i = 0; i < n and _Peek(); i++)
+        pending_ = false;
+}
+
+bool MarketDepth::Save(std::ostream& os)
+{
+    // Positions are only meaningful within the first file of a session:
+    if (switched_)
+        return false;
+
+    reader_.Save(os);
+    orders_.Save(os);
+
+    serialise::write(os, next_);
+    serialise::write(os, has_next_);
+
+    book_.save(os);
+    serialise::write(os, pending_);
+
+    return Streamer::Save(os);
+}
+
+void MarketDepth::Load(std::istream& is)
+{
+    reader_.Load(is);
+    orders_.Load(is);
+
+    serialise::read(is, next_);
+    serialise::read(is, has_next_);
+
+    book_.load(is);
+    serialise::read(is, pending_);
+
+    Streamer::Load(is);
+}
+
+void MarketDepth::QueueFile(string path)
+{
+    queue_.push_back(path);
+}
+
+bool MarketDepth::NextFile()
+{
+    if (queue_.empty())
+        return false;
+
+    Streamer::Reset();
+
+    _Open(queue_.front());
+    queue_.pop_front();
+
+    switched_ = true;
+
+    LoadNext();
+
+    return true;
+}
+
+// ------------------------------------------------------------------
+TimeAndSales::TimeAndSales():
+    data::TimeAndSales(),
+
+    reader_(),
+    orders_(),
+    fill_()
+{}
+
+TimeAndSales::TimeAndSales(string file_path):
+    TimeAndSales()
+{
+    LoadCSV(file_path);
+}
+
+void TimeAndSales::_Open(const string& path)
+{
+    reader_.Open(path, symbol_from_path(path));
+    date_ = date_from_path(path);
+
+    // Executions refer to resting orders for their price:
+    orders_.Clear();
+    pending_ = false;
+}
+
+void TimeAndSales::LoadCSV(string path)
+{
+    Reset();
+
+    _Open(path);
+
+    LoadNext();
+}
+
+bool TimeAndSales::_Peek()
+{
+    OrderEvent ev;
+
+    while (not pending_) {
+        if (not reader_.Next(ev))
+            return false;
+
+        orders_.Apply(ev, fill_);
+
+        if (fill_.shares > 0) {
+            time_ = ev.time;
+            pending_ = true;
+        }
+    }
+
+    return true;
+}
+
+bool TimeAndSales::_LoadNext()
+{
+    if (not _Peek())
+        return false;
+
+    record_next.date = date_;
+    record_next.time = time_;
+
+    // Fills with the same (ns) time stamp make up one record:
+    do {
+        record_next.transactions[to_price(fill_.price)] += fill_.shares;
+        pending_ = false;
+
+    } while (_Peek() and time_ <= record_next.time);
+
+    return true;
+}
+
+long TimeAndSales::_TimeLookAhead()
+{
+    return _Peek() ? time_ : -1;
+}
+
+void TimeAndSales::Reset()
+{
+    Streamer::Reset();
+
+    reader_.Close();
+    orders_.Clear();
+    pending_ = false;
+
+    queue_.clear();
+    switched_ = false;
+}
+
+void TimeAndSales::SkipN(long n)
+{
+    for (long i = 0; i < n and _Peek(); i++)
+        pending_ = false;
+}
+
+bool TimeAndSales::Save(std::ostream& os)
+{
+    // Positions are only meaningful within the first file of a session:
+    if (switched_)
+        return false;
+
+    reader_.Save(os);
+    orders_.Save(os);
+
+    serialise::write(os, fill_);
+    serialise::write(os, time_);
+    serialise::write(os, pending_);
+
+    return Streamer::Save(os);
+}
+
+void TimeAndSales::Load(std::istream& is)
+{
+    reader_.Load(is);
+    orders_.Load(is);
+
+    serialise::read(is, fill_);
+    serialise::read(is, time_);
+    serialise::read(is, pending_);
+
+    Streamer::Load(is);
+}
+
+void TimeAndSales::QueueFile(string path)
+{
+    queue_.push_back(path);
+}
+
+bool TimeAndSales::NextFile()
+{
+    if (queue_.empty())
+        return false;
+
+    Streamer::Reset();
+
+    _Open(queue_.front());
+    queue_.pop_front();
+
+    switched_ = true;
+
+    LoadNext();
+
+    return true;
+}
@@ -0,0 +1,561 @@
+#include "data/live.h"
+#include "utilities/time.h"
+
+#include <chrono>
+#include <cerrno>
+#include <limits>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+using namespace std;
+using namespace data::live;
+
+static const size_t DEPTH_BODY = 5 * (2 * sizeof(double) + 2 * sizeof(int64_t));
+static const size_t TRADE_SIZE = sizeof(double) + sizeof(int64_t);
+
+long data::live::steady_ns()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static sockaddr_un socket_address(const string& path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+
+    if (path.size() >= sizeof(addr.sun_path))
+        throw runtime_error("[Feed] Socket path too long: " + path);
+
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    return addr;
+}
+
+template<typename T>
+static void put(vector<char>& frame, const T& val)
+{
+    const char* p = reinterpret_cast<const char*>(&val);
+    frame.insert(frame.end(), p, p + sizeof(T));
+}
+
+template<typename T>
+static T get(const char*& p)
+{
+    T val;
+    memcpy(&val, p, sizeof(T));
+    p += sizeof(T);
+
+    return val;
+}
+
+// ------------------------------------------------------------------
+mutex Feed::registry_mutex_;
+map<string, weak_ptr<Feed>> Feed::registry_;
+
+Feed::Feed(const string& path)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        throw runtime_error("[Feed] No feed at: " + path);
+
+    if (S_ISSOCK(info.st_mode)) {
+        fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        sockaddr_un addr = socket_address(path);
+        if (fd_ < 0 or
+            connect(fd_, (sockaddr*) &addr, sizeof(addr)) != 0) {
+            if (fd_ >= 0) close(fd_);
+
+            throw runtime_error("[Feed] Failed to connect to: " + path);
+        }
+
+    } else {
+        // FIFOs (or recorded feeds) are read like files:
+        fd_ = open(path.c_str(), O_RDONLY);
+        if (fd_ < 0)
+            throw runtime_error("[Feed] Failed to open: " + path);
+    }
+
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+}
+
+Feed::~Feed()
+{
+    if (fd_ >= 0)
+        close(fd_);
+}
+
+shared_ptr<Feed> Feed::Get(const string& path)
+{
+    lock_guard<mutex> lock(registry_mutex_);
+
+    auto it = registry_.find(path);
+    if (it != registry_.end())
+        if (auto feed = it->second.lock())
+            return feed;
+
+    auto feed = make_shared<Feed>(path);
+    registry_[path] = feed;
+
+    return feed;
+}
+
+bool Feed::Poll(bool block)
+{
+    if (ended_)
+        return false;
+
+    if (block) {
+        pollfd p = {fd_, POLLIN, 0};
+        while (poll(&p, 1, -1) < 0)
+            if (errno != EINTR)
+                throw runtime_error("[Feed] Poll failed: " +
+                                    string(strerror(errno)));
+    }
+
+    char chunk[65536];
+    while (true) {
+        ssize_t n = read(fd_, chunk, sizeof(chunk));
+
+        if (n > 0) {
+            buffer_.insert(buffer_.end(), chunk, chunk + n);
+            if ((size_t) n < sizeof(chunk)) break;
+
+        } else if (n == 0) {
+            ended_ = true;
+            break;
+
+        } else if (errno == EAGAIN or errno == EWOULDBLOCK)
+            break;
+
+        else if (errno != EINTR)
+            throw runtime_error("[Feed] Read failed: " +
+                                string(strerror(errno)));
+    }
+
+    _Parse(steady_ns());
+
+    return not ended_;
+}
+
+void Feed::_Parse(long now)
+{
+    size_t pos = 0;
+    while (buffer_.size() - pos >= sizeof(uint32_t)) {
+        uint32_t length;
+        memcpy(&length, buffer_.data() + pos, sizeof(length));
+
+        if (buffer_.size() - pos - sizeof(length) < length)
+            break;
+
+        const char* p = buffer_.data() + pos + sizeof(length);
+        const char* end = p + length;
+
+        pos += sizeof(length) + length;
+
+        if (length < sizeof(FrameHeader))
+            throw runtime_error("[Feed] Invalid frame.");
+
+        FrameHeader h;
+        memcpy(&h, p, sizeof(h));
+        p += sizeof(h);
+
+        if (h.type == 'E') {
+            ended_ = true;
+            break;
+
+        } else if (h.type == 'D') {
+            if ((size_t) (end - p) != DEPTH_BODY)
+                throw runtime_error("[Feed] Invalid depth frame.");
+
+            Arrival<MarketDepthRecord> a;
+            a.record.date = h.date;
+            a.record.time = h.time;
+            a.arrival = now;
+
+            for (int l = 0; l < 5; l++) a.record.ask_prices[l] = get<double>(p);
+            for (int l = 0; l < 5; l++) a.record.ask_volumes[l] = get<int64_t>(p);
+            for (int l = 0; l < 5; l++) a.record.bid_prices[l] = get<double>(p);
+            for (int l = 0; l < 5; l++) a.record.bid_volumes[l] = get<int64_t>(p);
+
+            depth_.push_back(a);
+
+        } else if (h.type == 'T') {
+            if ((end - p) % TRADE_SIZE != 0)
+                throw runtime_error("[Feed] Invalid trade frame.");
+
+            Arrival<TimeAndSalesRecord> a;
+            a.record.date = h.date;
+            a.record.time = h.time;
+            a.arrival = now;
+
+            while (p < end) {
+                double price = get<double>(p);
+                a.record.transactions[price] += get<int64_t>(p);
+            }
+
+            trades_.push_back(a);
+
+        } else
+            throw runtime_error("[Feed] Unknown frame type: " + string(1, h.type));
+
+        last_date_ = h.date;
+        last_time_ = h.time;
+
+        n_frames_++;
+    }
+
+    buffer_.erase(buffer_.begin(), buffer_.begin() + pos);
+}
+
+deque<Feed::Arrival<data::MarketDepthRecord>>& Feed::Depth() { return depth_; }
+deque<Feed::Arrival<data::TimeAndSalesRecord>>& Feed::Trades() { return trades_; }
+
+void Feed::SetMaxLag(long ms)
+{
+    max_lag_ = millis_to_time(ms);
+}
+
+void Feed::Conflate()
+{
+    if (max_lag_ <= 0)
+        return;
+
+    long now = steady_ns();
+    while (depth_.size() > 1 and now - depth_.front().arrival > max_lag_) {
+        depth_.pop_front();
+        n_conflated_++;
+    }
+}
+
+void Feed::DiscardBefore(int date)
+{
+    while (not depth_.empty() and depth_.front().record.date < date)
+        depth_.pop_front();
+
+    while (not trades_.empty() and trades_.front().record.date < date)
+        trades_.pop_front();
+}
+
+void Feed::MarkDelivered(long arrival)
+{
+    if (arrival > last_arrival_)
+        last_arrival_ = arrival;
+}
+
+int Feed::LastDate() const { return last_date_; }
+long Feed::LastTime() const { return last_time_; }
+long Feed::LastArrival() const { return last_arrival_; }
+
+long Feed::Frames() const { return n_frames_; }
+long Feed::Conflated() const { return n_conflated_; }
+
+// ------------------------------------------------------------------
+Publisher::Publisher(const string& path):
+    path_(path)
+{
+    struct stat info;
+    bool exists = (stat(path.c_str(), &info) == 0);
+
+    if (exists and S_ISFIFO(info.st_mode)) {
+        fd_ = open(path.c_str(), O_WRONLY);
+        if (fd_ < 0)
+            throw runtime_error("[Publisher] Failed to open: " + path);
+
+        return;
+    }
+
+    // Replace a stale socket, but nothing else:
+    if (exists and not S_ISSOCK(info.st_mode))
+        throw runtime_error("[Publisher] Not a socket or FIFO: " + path);
+
+    int s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s < 0)
+        throw runtime_error("[Publisher] Failed to create a socket.");
+
+    if (exists)
+        unlink(path.c_str());
+
+    sockaddr_un addr = socket_address(path);
+    if (bind(s, (sockaddr*) &addr, sizeof(addr)) != 0 or listen(s, 1) != 0) {
+        close(s);
+
+        throw runtime_error("[Publisher] Failed to listen on: " + path);
+    }
+
+    socket_ = true;
+
+    fd_ = accept(s, nullptr, nullptr);
+    close(s);
+
+    if (fd_ < 0)
+        throw runtime_error("[Publisher] Failed to accept a reader.");
+}
+
+Publisher::~Publisher()
+{
+    if (fd_ >= 0)
+        close(fd_);
+
+    if (socket_)
+        unlink(path_.c_str());
+}
+
+void Publisher::_Write(const vector<char>& frame)
+{
+    size_t done = 0;
+    while (done < frame.size()) {
+        ssize_t n = socket_ ?
+            send(fd_, frame.data() + done, frame.size() - done, MSG_NOSIGNAL) :
+            write(fd_, frame.data() + done, frame.size() - done);
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+
+            throw runtime_error("[Publisher] Write failed: " +
+                                string(strerror(errno)));
+        }
+
+        done += n;
+    }
+}
+
+static vector<char> frame(char type, int date, long time, size_t body)
+{
+    vector<char> f;
+    f.reserve(sizeof(uint32_t) + sizeof(FrameHeader) + body);
+
+    put(f, (uint32_t) (sizeof(FrameHeader) + body));
+    put(f, FrameHeader{type, date, time});
+
+    return f;
+}
+
+void Publisher::Send(const data::MarketDepthRecord& rec)
+{
+    vector<char> f = frame('D', rec.date, rec.time, DEPTH_BODY);
+
+    for (auto v : rec.ask_prices) put(f, (double) v);
+    for (auto v : rec.ask_volumes) put(f, (int64_t) v);
+    for (auto v : rec.bid_prices) put(f, (double) v);
+    for (auto v : rec.bid_volumes) put(f, (int64_t) v);
+
+    _Write(f);
+}
+
+void Publisher::Send(const data::TimeAndSalesRecord& rec)
+{
+    vector<char> f = frame('T', rec.date, rec.time,
+                           TRADE_SIZE * rec.transactions.size());
+
+    for (auto& t : rec.transactions) {
+        put(f, (double) t.first);
+        put(f, (int64_t) t.second);
+    }
+
+    _Write(f);
+}
+
+void Publisher::End()
+{
+    _Write(frame('E', 0, 0L, 0));
+}
+
+// ------------------------------------------------------------------
+MarketDepth::MarketDepth():
+    data::MarketDepth()
+{}
+
+MarketDepth::MarketDepth(string path):
+    MarketDepth()
+{
+    LoadCSV(path);
+}
+
+void MarketDepth::LoadCSV(string path)
+{
+    Reset();
+
+    feed_ = Feed::Get(path);
+    feed_->Poll(false);
+    feed_->DiscardBefore(feed_->LastDate());
+
+    LoadNext();
+}
+
+bool MarketDepth::_LoadNext()
+{
+    auto& q = feed_->Depth();
+
+    // The record looked ahead to before has now been consumed:
+    if (held_) {
+        q.pop_front();
+        held_ = false;
+    }
+
+    feed_->Poll(false);
+    feed_->Conflate();
+
+    while (q.empty() and feed_->Poll(true)) {}
+
+    if (q.empty())
+        return false;
+
+    if (date_ == 0)
+        date_ = q.front().record.date;
+    else if (q.front().record.date != date_)
+        return false;
+
+    record_next = q.front().record;
+    held_ = true;
+
+    feed_->MarkDelivered(q.front().arrival);
+
+    return true;
+}
+
+long MarketDepth::_TimeLookAhead()
+{
+    auto& q = feed_->Depth();
+
+    size_t i = held_ ? 1 : 0;
+    while (q.size() <= i and feed_->Poll(true)) {}
+
+    if (q.size() > i and q[i].record.date == date_)
+        return q[i].record.time;
+
+    return -1;
+}
+
+void MarketDepth::Reset()
+{
+    Streamer::Reset();
+
+    // Leave the record looked ahead to for the next reader:
+    feed_.reset();
+    held_ = false;
+
+    date_ = 0;
+}
+
+void MarketDepth::SkipN(long n)
+{
+    for (long i = 0; i < n; i++)
+        if (not _LoadNext())
+            break;
+}
+
+bool MarketDepth::Save(ostream&)
+{
+    return false;
+}
+
+// ------------------------------------------------------------------
+TimeAndSales::TimeAndSales():
+    data::TimeAndSales()
+{}
+
+TimeAndSales::TimeAndSales(string path):
+    TimeAndSales()
+{
+    LoadCSV(path);
+}
+
+void TimeAndSales::LoadCSV(string path)
+{
+    Reset();
+
+    feed_ = Feed::Get(path);
+    feed_->Poll(false);
+    feed_->DiscardBefore(feed_->LastDate());
+
+    LoadNext();
+}
+
+bool TimeAndSales::_LoadNext()
+{
+    auto& q = feed_->Trades();
+
+    if (held_) {
+        q.pop_front();
+        held_ = false;
+    }
+
+    feed_->Poll(false);
+    while (q.empty() and feed_->LastDate() == 0 and feed_->Poll(true)) {}
+
+    if (date_ == 0)
+        date_ = q.empty() ? feed_->LastDate() : q.front().record.date;
+
+    if (not q.empty()) {
+        auto& a = q.front();
+        if (a.record.date != date_)
+            return false;
+
+        record_next.date = a.record.date;
+        record_next.time = a.record.time;
+        for (auto& t : a.record.transactions)
+            record_next.transactions[t.first] += t.second;
+
+        held_ = true;
+        feed_->MarkDelivered(a.arrival);
+
+        return true;
+    }
+
+    if (not feed_->Poll(false) or feed_->LastDate() != date_)
+        return false;
+
+    // No trades since; every trade up to the latest frame has been received:
+    record_next.date = date_;
+    record_next.time = feed_->LastTime();
+
+    return true;
+}
+
+long TimeAndSales::_TimeLookAhead()
+{
+    auto& q = feed_->Trades();
+
+    bool open = feed_->Poll(false);
+
+    size_t i = held_ ? 1 : 0;
+    if (q.size() > i)
+        return (q[i].record.date == date_) ? q[i].record.time : -1;
+
+    // The next trade, if any, comes after the latest frame, and so after
+    // any time we could be loading up to:
+    return (open and feed_->LastDate() == date_) ?
+        numeric_limits<long>::max() : -1;
+}
+
+void TimeAndSales::Reset()
+{
+    Streamer::Reset();
+
+    feed_.reset();
+    held_ = false;
+
+    date_ = 0;
+}
+
+void TimeAndSales::SkipN(long n)
+{
+    for (long i = 0; i < n; i++)
+        if (not _LoadNext())
+            break;
+}
+
+bool TimeAndSales::Save(ostream&)
+{
+    return false;
+}
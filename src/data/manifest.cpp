@@ -0,0 +1,392 @@
+#include "data/manifest.h"
+#include "data/itch.h"
+#include "market/market.h"
+#include "utilities/time.h"
+#include "utilities/files.h"
+#include "utilities/serialise.h"
+#include "utilities/mapped_file.h"
+
+#include <map>
+#include <atomic>
+#include <cctype>
+#include <memory>
+#include <thread>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace data;
+
+// Bumped whenever the layout of an entry changes:
+static const uint32_t VERSION = 1;
+
+static void write_entry(ostream& os, const ManifestEntry& e)
+{
+    serialise::write(os, e.symbol);
+    serialise::write(os, e.date);
+    serialise::write(os, e.md_path);
+    serialise::write(os, e.tas_path);
+
+    serialise::write(os, e.md_bytes);
+    serialise::write(os, e.tas_bytes);
+    serialise::write(os, e.md_mtime);
+    serialise::write(os, e.tas_mtime);
+
+    serialise::write(os, e.md_rows);
+    serialise::write(os, e.tas_rows);
+
+    serialise::write(os, e.open_offset);
+    serialise::write(os, e.close_offset);
+}
+
+static void read_entry(istream& is, ManifestEntry& e)
+{
+    serialise::read(is, e.symbol);
+    serialise::read(is, e.date);
+    serialise::read(is, e.md_path);
+    serialise::read(is, e.tas_path);
+
+    serialise::read(is, e.md_bytes);
+    serialise::read(is, e.tas_bytes);
+    serialise::read(is, e.md_mtime);
+    serialise::read(is, e.tas_mtime);
+
+    serialise::read(is, e.md_rows);
+    serialise::read(is, e.tas_rows);
+
+    serialise::read(is, e.open_offset);
+    serialise::read(is, e.close_offset);
+}
+
+static bool file_info(const string& path, long& bytes, long& mtime)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return false;
+
+    bytes = info.st_size;
+    mtime = info.st_mtime;
+
+    return true;
+}
+
+// The last 8 consecutive digits of a file name:
+static int date_from_path(const string& path)
+{
+    size_t start = path.find_last_of('/');
+    start = (start == string::npos) ? 0 : start + 1;
+
+    int date = 0, n = 0;
+    for (size_t i = start; i < path.size(); i++) {
+        if (isdigit(path[i])) {
+            if (++n == 8) date = stoi(path.substr(i - 7, 8));
+        } else
+            n = 0;
+    }
+
+    return date;
+}
+
+static long count_lines(const MappedFile& f)
+{
+    long n = 0;
+
+    const char *p = f.data(), *end = p + f.size();
+    while ((p = (const char*) memchr(p, '\n', end - p)) != nullptr) {
+        n++;
+        p++;
+    }
+
+    // An unterminated last line:
+    if (f.size() > 0 and f.data()[f.size() - 1] != '\n')
+        n++;
+
+    return n;
+}
+
+static long count_events(const string& path, const string& symbol)
+{
+    itch::Reader reader;
+    reader.Open(path, symbol);
+
+    long n = 0;
+    itch::OrderEvent ev;
+    while (reader.Next(ev)) n++;
+
+    return n;
+}
+
+// ------------------------------------------------------------------
+ManifestEntry Manifest::_Scan(ManifestEntry e, const string& format)
+{
+    e.open_offset = e.close_offset = -1;
+
+    if (format == "itch") {
+        e.md_rows = count_events(e.md_path, e.symbol);
+        e.tas_rows = count_events(e.tas_path, e.symbol);
+
+        return e;
+    }
+
+    MappedFile md(e.md_path), tas(e.tas_path);
+
+    e.md_rows = max(0L, count_lines(md) - 1);
+    e.tas_rows = max(0L, count_lines(tas) - 1);
+
+    if (format != "basic" or e.md_rows == 0)
+        return e;
+
+    // Rows of basic files start with date,hh:mm:ss.mmm:
+    string symbol = e.symbol.substr(0, e.symbol.find_first_of('.')),
+           venue = e.symbol.substr(e.symbol.find_first_of('.') + 1);
+
+    unique_ptr<market::Market> m(market::Market::make_market(symbol, venue));
+    long open = m->open_time(), close = m->close_time();
+
+    const char *begin = md.data(), *end = begin + md.size();
+    const char *p = (const char*) memchr(begin, '\n', end - begin);
+
+    while (p != nullptr and ++p < end) {
+        const char* c1 = (const char*) memchr(p, ',', end - p);
+        const char* c2 = (c1 == nullptr) ?
+            nullptr : (const char*) memchr(c1 + 1, ',', end - c1 - 1);
+        if (c2 == nullptr)
+            break;
+
+        long t = parse_time(c1 + 1, c2 - c1 - 1);
+
+        if (e.open_offset < 0 and t >= open)
+            e.open_offset = p - begin;
+
+        if (t >= close) {
+            e.close_offset = p - begin;
+            break;
+        }
+
+        p = (const char*) memchr(p, '\n', end - p);
+    }
+
+    if (e.open_offset < 0) e.open_offset = md.size();
+    if (e.close_offset < 0) e.close_offset = md.size();
+
+    return e;
+}
+
+bool Manifest::Load(const string& path)
+{
+    entries_.clear();
+
+    ifstream ifs(path, ios::binary);
+    if (not ifs.is_open())
+        return false;
+
+    uint32_t version;
+    uint64_t n;
+
+    try {
+        serialise::read(ifs, version);
+        if (version != VERSION)
+            return false;
+
+        serialise::read(ifs, n);
+
+        entries_.resize(n);
+        for (auto& e : entries_)
+            read_entry(ifs, e);
+
+    } catch (runtime_error& e) {
+        entries_.clear();
+
+        return false;
+    }
+
+    return true;
+}
+
+void Manifest::Save(const string& path) const
+{
+    // Written aside and renamed, so that readers never see half a manifest:
+    string tmp = path + ".tmp";
+
+    {
+        ofstream ofs(tmp, ios::binary);
+        if (not ofs.is_open())
+            throw runtime_error("[Manifest] Failed to write: " + tmp);
+
+        serialise::write(ofs, VERSION);
+        serialise::write(ofs, (uint64_t) entries_.size());
+
+        for (auto& e : entries_)
+            write_entry(ofs, e);
+    }
+
+    if (rename(tmp.c_str(), path.c_str()) != 0)
+        throw runtime_error("[Manifest] Failed to write: " + path);
+}
+
+long Manifest::Update(const string& md_dir, const string& tas_dir,
+                      const vector<string>& symbols, const string& format,
+                      int n_threads)
+{
+    // What we already know, by market depth file:
+    map<string, const ManifestEntry*> known;
+    for (auto& e : entries_)
+        known[e.md_path] = &e;
+
+    vector<ManifestEntry> entries, pending;
+    for (auto& s : symbols) {
+        auto files = get_file_sample(md_dir, tas_dir, {s},
+                                     format == "itch" ? "itch" : "csv");
+
+        for (auto& f : files) {
+            ManifestEntry e;
+            e.symbol = s;
+            e.md_path = get<1>(f);
+            e.tas_path = get<2>(f);
+            e.date = date_from_path(e.md_path);
+
+            if (not (file_info(e.md_path, e.md_bytes, e.md_mtime) and
+                     file_info(e.tas_path, e.tas_bytes, e.tas_mtime)))
+                continue;
+
+            auto it = known.find(e.md_path);
+            if (it != known.end() and
+                it->second->tas_path == e.tas_path and
+                it->second->md_bytes == e.md_bytes and
+                it->second->md_mtime == e.md_mtime and
+                it->second->tas_bytes == e.tas_bytes and
+                it->second->tas_mtime == e.tas_mtime)
+                entries.push_back(*it->second);
+            else
+                pending.push_back(e);
+        }
+    }
+
+    // Symbols not being updated are kept as they are:
+    for (auto& e : entries_)
+        if (find(symbols.begin(), symbols.end(), e.symbol) == symbols.end())
+            entries.push_back(e);
+
+    // Scan the new days in parallel; workers take the next day as they go:
+    vector<ManifestEntry> scanned(pending.size());
+    vector<string> errors(pending.size());
+
+    atomic<size_t> next{0};
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next++) < pending.size()) {
+            try {
+                scanned[i] = _Scan(pending[i], format);
+            } catch (exception& ex) {
+                errors[i] = ex.what();
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 1; t < min<int>(n_threads, pending.size()); t++)
+        threads.emplace_back(worker);
+
+    worker();
+    for (auto& t : threads) t.join();
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        if (not errors[i].empty())
+            throw runtime_error("[Manifest] Failed to scan " +
+                                pending[i].md_path + ": " + errors[i]);
+
+        entries.push_back(scanned[i]);
+    }
+
+    sort(entries.begin(), entries.end(),
+         [](const ManifestEntry& a, const ManifestEntry& b) {
+             return tie(a.symbol, a.md_path) < tie(b.symbol, b.md_path);
+         });
+
+    entries_.swap(entries);
+
+    return pending.size();
+}
+
+bool Manifest::Contains(const string& symbol) const
+{
+    for (auto& e : entries_)
+        if (e.symbol == symbol)
+            return true;
+
+    return false;
+}
+
+vector<ManifestEntry> Manifest::Select(const vector<string>& symbols) const
+{
+    vector<ManifestEntry> selected;
+    for (auto& s : symbols) {
+        auto lo = lower_bound(entries_.begin(), entries_.end(), s,
+                              [](const ManifestEntry& e, const string& s) {
+                                  return e.symbol < s;
+                              });
+
+        for (auto it = lo; it != entries_.end() and it->symbol == s; ++it)
+            if (it->md_rows > 0)
+                selected.push_back(*it);
+    }
+
+    return selected;
+}
+
+const vector<ManifestEntry>& Manifest::Entries() const
+{
+    return entries_;
+}
+
+void data::split_balanced(const vector<ManifestEntry>& entries, size_t n,
+                          vector<ManifestEntry>& train,
+                          vector<ManifestEntry>& test)
+{
+    // The days of each symbol, latest last:
+    map<string, vector<size_t>> days;
+    for (size_t i = 0; i < entries.size(); i++)
+        days[entries[i].symbol].push_back(i);
+
+    for (auto& d : days)
+        sort(d.second.begin(), d.second.end(), [&](size_t a, size_t b) {
+            return entries[a].date < entries[b].date;
+        });
+
+    map<string, long> held_rows;
+    vector<bool> held(entries.size(), false);
+
+    for (size_t k = 0; k < n; k++) {
+        const string* best = nullptr;
+        for (auto& d : days)
+            if (not d.second.empty() and
+                (best == nullptr or held_rows[d.first] < held_rows[*best]))
+                best = &d.first;
+
+        if (best == nullptr)
+            break;
+
+        size_t i = days[*best].back();
+        days[*best].pop_back();
+
+        held[i] = true;
+        held_rows[*best] += entries[i].md_rows;
+    }
+
+    train.clear();
+    test.clear();
+    for (size_t i = 0; i < entries.size(); i++)
+        (held[i] ? test : train).push_back(entries[i]);
+}
+
+vector<tuple<string, string, string>> data::to_samples(
+    const vector<ManifestEntry>& entries)
+{
+    vector<tuple<string, string, string>> samples;
+    for (auto& e : entries)
+        samples.push_back(make_tuple(e.symbol, e.md_path, e.tas_path));
+
+    return samples;
+}
@@ -1,4 +1,5 @@
 #include "data/records.h"
+#include "utilities/serialise.h"
 
 #include <numeric>
 #include <algorithm>
@@ -12,6 +13,18 @@ void Record::clear()
     time = 0;
 }
 
+void Record::save(std::ostream& os) const
+{
+    serialise::write(os, date);
+    serialise::write(os, time);
+}
+
+void Record::load(std::istream& is)
+{
+    serialise::read(is, date);
+    serialise::read(is, time);
+}
+
 
 void MarketDepthRecord::clear()
 {
@@ -24,6 +37,28 @@ void MarketDepthRecord::clear()
     bid_volumes.fill(0);
 }
 
+void MarketDepthRecord::save(std::ostream& os) const
+{
+    Record::save(os);
+
+    serialise::write(os, ask_prices);
+    serialise::write(os, ask_volumes);
+
+    serialise::write(os, bid_prices);
+    serialise::write(os, bid_volumes);
+}
+
+void MarketDepthRecord::load(std::istream& is)
+{
+    Record::load(is);
+
+    serialise::read(is, ask_prices);
+    serialise::read(is, ask_volumes);
+
+    serialise::read(is, bid_prices);
+    serialise::read(is, bid_volumes);
+}
+
 
 double TimeAndSalesRecord::mean_price() const
 {
@@ -42,3 +77,17 @@ void TimeAndSalesRecord::clear()
 
     transactions.clear();
 }
+
+void TimeAndSalesRecord::save(std::ostream& os) const
+{
+    Record::save(os);
+
+    serialise::write(os, transactions);
+}
+
+void TimeAndSalesRecord::load(std::istream& is)
+{
+    Record::load(is);
+
+    serialise::read(is, transactions);
+}
@@ -0,0 +1,537 @@
+#include "data/reuters.h"
+#include "utilities/time.h"
+#include "utilities/serialise.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace data::reuters;
+
+// FNV-1a, usable in case labels so that the FID table is built by the
+// compiler (a collision between two names would not compile):
+static constexpr uint32_t fnv1a(const char* s, uint32_t h = 2166136261u)
+{
+    return *s == '\0' ? h : fnv1a(s + 1, (h ^ (uint8_t) *s) * 16777619u);
+}
+
+static inline uint32_t fnv1a(const char* s, size_t n, uint32_t h)
+{
+    for (size_t i = 0; i < n; i++)
+        h = (h ^ (uint8_t) s[i]) * 16777619u;
+
+    return h;
+}
+
+static const char* const FID_NAMES[N_TRACKED] = {
+    "BEST_ASK1", "BEST_ASK2", "BEST_ASK3", "BEST_ASK4", "BEST_ASK5",
+    "BEST_ASIZ1", "BEST_ASIZ2", "BEST_ASIZ3", "BEST_ASIZ4", "BEST_ASIZ5",
+    "BEST_BID1", "BEST_BID2", "BEST_BID3", "BEST_BID4", "BEST_BID5",
+    "BEST_BSIZ1", "BEST_BSIZ2", "BEST_BSIZ3", "BEST_BSIZ4", "BEST_BSIZ5",
+    "TRDPRC_1", "TRDVOL_1"
+};
+
+int data::reuters::fid_index(const char* name, size_t len)
+{
+    int i;
+    switch (fnv1a(name, len, 2166136261u)) {
+        case fnv1a("BEST_ASK1"): i = ASK_PRICE; break;
+        case fnv1a("BEST_ASK2"): i = ASK_PRICE + 1; break;
+        case fnv1a("BEST_ASK3"): i = ASK_PRICE + 2; break;
+        case fnv1a("BEST_ASK4"): i = ASK_PRICE + 3; break;
+        case fnv1a("BEST_ASK5"): i = ASK_PRICE + 4; break;
+
+        case fnv1a("BEST_ASIZ1"): i = ASK_SIZE; break;
+        case fnv1a("BEST_ASIZ2"): i = ASK_SIZE + 1; break;
+        case fnv1a("BEST_ASIZ3"): i = ASK_SIZE + 2; break;
+        case fnv1a("BEST_ASIZ4"): i = ASK_SIZE + 3; break;
+        case fnv1a("BEST_ASIZ5"): i = ASK_SIZE + 4; break;
+
+        case fnv1a("BEST_BID1"): i = BID_PRICE; break;
+        case fnv1a("BEST_BID2"): i = BID_PRICE + 1; break;
+        case fnv1a("BEST_BID3"): i = BID_PRICE + 2; break;
+        case fnv1a("BEST_BID4"): i = BID_PRICE + 3; break;
+        case fnv1a("BEST_BID5"): i = BID_PRICE + 4; break;
+
+        case fnv1a("BEST_BSIZ1"): i = BID_SIZE; break;
+        case fnv1a("BEST_BSIZ2"): i = BID_SIZE + 1; break;
+        case fnv1a("BEST_BSIZ3"): i = BID_SIZE + 2; break;
+        case fnv1a("BEST_BSIZ4"): i = BID_SIZE + 3; break;
+        case fnv1a("BEST_BSIZ5"): i = BID_SIZE + 4; break;
+
+        case fnv1a("TRDPRC_1"): i = TRADE_PRICE; break;
+        case fnv1a("TRDVOL_1"): i = TRADE_VOLUME; break;
+
+        default: return -1;
+    }
+
+    // Untracked names may share a hash with a tracked one:
+    if (strlen(FID_NAMES[i]) != len or memcmp(FID_NAMES[i], name, len) != 0)
+        return -1;
+
+    return i;
+}
+
+// Field parsers over unterminated views into the mapped file ---------
+
+static inline bool is(const char* p, size_t n, const char* s)
+{
+    return strlen(s) == n and memcmp(p, s, n) == 0;
+}
+
+static inline long parse_long(const char* p, size_t n)
+{
+    long v = 0;
+    for (size_t i = 0; i < n and p[i] >= '0' and p[i] <= '9'; i++)
+        v = 10 * v + (p[i] - '0');
+
+    return v;
+}
+
+static const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static double parse_decimal(const char* p, size_t n)
+{
+    size_t i = 0;
+
+    bool negative = (n > 0 and p[0] == '-');
+    if (negative or (n > 0 and p[0] == '+')) i++;
+
+    // Up to 18 significant digits fit the mantissa; since both it and the
+    // power of ten are exact doubles the division is correctly rounded:
+    uint64_t mantissa = 0;
+    int digits = 0, scale = 0;
+    bool point = false;
+
+    for (; i < n; i++) {
+        char c = p[i];
+
+        if (c >= '0' and c <= '9') {
+            if (++digits > 18) break;
+
+            mantissa = 10 * mantissa + (c - '0');
+            if (point) scale++;
+
+        } else if (c == '.' and not point)
+            point = true;
+        else
+            break;
+    }
+
+    // Rare long or exponent forms go the slow way:
+    if (i < n and (digits > 18 or p[i] == 'e' or p[i] == 'E'))
+        return strtod(string(p, n).c_str(), nullptr);
+
+    double v = (double) mantissa / POW10[scale];
+
+    return negative ? -v : v;
+}
+
+// DD-MMM-YYYY (as exported) or YYYYMMDD:
+static int parse_date(const char* p, size_t n)
+{
+    static const char* const MONTHS = "JANFEBMARAPRMAYJUNJULAUGSEPOCTNOVDEC";
+
+    if (n == 11 and p[2] == '-' and p[6] == '-') {
+        char m[3] = {(char) toupper(p[3]), (char) toupper(p[4]),
+                     (char) toupper(p[5])};
+
+        for (int month = 0; month < 12; month++)
+            if (memcmp(MONTHS + 3 * month, m, 3) == 0)
+                return 10000 * parse_long(p + 7, 4) + 100 * (month + 1) +
+                    parse_long(p, 2);
+
+        throw runtime_error("[Reuters] Unknown month: " + string(p, n));
+    }
+
+    return parse_long(p, n);
+}
+
+// ------------------------------------------------------------------
+void Reader::Open(const string& path)
+{
+    file_.openFile(path);
+    pos_ = 0;
+}
+
+void Reader::Close()
+{
+    file_.closeFile();
+    pos_ = 0;
+}
+
+bool Reader::IsOpen() const
+{
+    return file_.isOpen();
+}
+
+size_t Reader::_Split(size_t pos, const char* fields[], size_t lens[]) const
+{
+    const char *data = file_.data(),
+               *line = data + pos,
+               *end = static_cast<const char*>(
+                   memchr(line, '\n', file_.size() - pos));
+
+    size_t next = (end == nullptr) ? file_.size() : (end - data) + 1;
+
+    if (end == nullptr) end = data + file_.size();
+    if (end > line and end[-1] == '\r') end--;
+
+    // Missing trailing fields are left empty:
+    const char* p = line;
+    for (int i = 0; i < N_COLUMNS; i++) {
+        const char* c = (p == nullptr) ? nullptr :
+            static_cast<const char*>(memchr(p, ',', end - p));
+
+        fields[i] = (p == nullptr) ? end : p;
+        lens[i] = (p == nullptr) ? 0 : ((c == nullptr ? end : c) - p);
+
+        p = (c == nullptr) ? nullptr : c + 1;
+    }
+
+    return next;
+}
+
+bool Reader::Next(Message& msg)
+{
+    const char* f[N_COLUMNS];
+    size_t n[N_COLUMNS];
+
+    while (pos_ < file_.size()) {
+        size_t next = _Split(pos_, f, n);
+        pos_ = next;
+
+        // Skips the header and any FID rows without a message:
+        if (not is(f[TYPE], n[TYPE], "Raw"))
+            continue;
+
+        msg.date = parse_date(f[DATE], n[DATE]);
+        msg.time = parse_time(f[TIME], n[TIME]);
+        msg.present = 0;
+
+        long n_fids = parse_long(f[N_FIDS], n[N_FIDS]);
+        for (long i = 0; i < n_fids and pos_ < file_.size(); i++) {
+            next = _Split(pos_, f, n);
+
+            // Truncated message; leave the row for the next call:
+            if (not is(f[TYPE], n[TYPE], "FID"))
+                break;
+
+            int k = fid_index(f[FID_NAME], n[FID_NAME]);
+            if (k >= 0) {
+                msg.values[k] = parse_decimal(f[FID_VAL], n[FID_VAL]);
+                msg.present |= 1u << k;
+            }
+
+            pos_ = next;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+size_t Reader::Tell() const
+{
+    return pos_;
+}
+
+void Reader::Seek(size_t pos)
+{
+    pos_ = pos;
+}
+
+void Reader::Swap(Reader& other)
+{
+    file_.swap(other.file_);
+    std::swap(pos_, other.pos_);
+}
+
+// ------------------------------------------------------------------
+MarketDepth::MarketDepth():
+    data::MarketDepth(),
+
+    reader_(),
+    msg_(),
+    book_()
+{
+    book_.clear();
+}
+
+MarketDepth::MarketDepth(string file_path):
+    MarketDepth()
+{
+    LoadCSV(file_path);
+}
+
+void MarketDepth::LoadCSV(string path)
+{
+    Reset();
+
+    reader_.Open(path);
+
+    LoadNext();
+}
+
+bool MarketDepth::_Peek()
+{
+    static const uint32_t DEPTH_FIDS = (1u << TRADE_PRICE) - 1;
+
+    while (not pending_) {
+        if (not reader_.Next(msg_))
+            return false;
+
+        if ((msg_.present & DEPTH_FIDS) == 0)
+            continue;
+
+        // Prices are kept at float precision, as the basic streamers read
+        // them, so that both formats replay a day identically:
+        for (int l = 0; l < 5; l++) {
+            if (msg_.has(ASK_PRICE + l))
+                book_.ask_prices[l] = (float) msg_.values[ASK_PRICE + l];
+            if (msg_.has(ASK_SIZE + l))
+                book_.ask_volumes[l] = (long) msg_.values[ASK_SIZE + l];
+
+            if (msg_.has(BID_PRICE + l))
+                book_.bid_prices[l] = (float) msg_.values[BID_PRICE + l];
+            if (msg_.has(BID_SIZE + l))
+                book_.bid_volumes[l] = (long) msg_.values[BID_SIZE + l];
+        }
+
+        book_.date = msg_.date;
+        book_.time = msg_.time;
+
+        // Only stream the book once every level is populated:
+        pending_ = true;
+        for (int l = 0; l < 5; l++)
+            if (book_.ask_prices[l] <= 0.0 or book_.ask_volumes[l] <= 0 or
+                book_.bid_prices[l] <= 0.0 or book_.bid_volumes[l] <= 0)
+                pending_ = false;
+    }
+
+    return true;
+}
+
+bool MarketDepth::_LoadNext()
+{
+    if (not _Peek())
+        return false;
+
+    record_next = book_;
+    pending_ = false;
+
+    return true;
+}
+
+long MarketDepth::_TimeLookAhead()
+{
+    return _Peek() ? book_.time : -1;
+}
+
+void MarketDepth::Reset()
+{
+    Streamer::Reset();
+
+    reader_.Close();
+
+    book_.clear();
+    pending_ = false;
+
+    queue_.clear();
+    switched_ = false;
+}
+
+void MarketDepth::SkipN(long n)
+{
+    // The book still follows the skipped updates:
+    for (long i = 0; i < n and _Peek(); i++)
+        pending_ = false;
+}
+
+bool MarketDepth::Save(std::ostream& os)
+{
+    // Positions are only meaningful within the first file of a session:
+    if (switched_)
+        return false;
+
+    serialise::write(os, (uint64_t) reader_.Tell());
+
+    book_.save(os);
+    serialise::write(os, pending_);
+
+    return Streamer::Save(os);
+}
+
+void MarketDepth::Load(std::istream& is)
+{
+    uint64_t pos;
+    serialise::read(is, pos);
+
+    reader_.Seek(pos);
+
+    book_.load(is);
+    serialise::read(is, pending_);
+
+    Streamer::Load(is);
+}
+
+void MarketDepth::QueueFile(string path)
+{
+    queue_.push_back(path);
+}
+
+bool MarketDepth::NextFile()
+{
+    if (queue_.empty())
+        return false;
+
+    Streamer::Reset();
+
+    reader_.Open(queue_.front());
+    queue_.pop_front();
+
+    // Each day starts from a refresh of the book:
+    book_.clear();
+    pending_ = false;
+
+    switched_ = true;
+
+    LoadNext();
+
+    return true;
+}
+
+// ------------------------------------------------------------------
+TimeAndSales::TimeAndSales():
+    data::TimeAndSales(),
+
+    reader_(),
+    msg_()
+{}
+
+TimeAndSales::TimeAndSales(string file_path):
+    TimeAndSales()
+{
+    LoadCSV(file_path);
+}
+
+void TimeAndSales::LoadCSV(string path)
+{
+    Reset();
+
+    reader_.Open(path);
+
+    LoadNext();
+}
+
+bool TimeAndSales::_Peek()
+{
+    while (not pending_) {
+        if (not reader_.Next(msg_))
+            return false;
+
+        pending_ = msg_.has(TRADE_PRICE) and msg_.has(TRADE_VOLUME) and
+            msg_.values[TRADE_PRICE] > 0.0 and msg_.values[TRADE_VOLUME] > 0.0;
+    }
+
+    return true;
+}
+
+bool TimeAndSales::_LoadNext()
+{
+    if (not _Peek())
+        return false;
+
+    record_next.date = msg_.date;
+    record_next.time = msg_.time;
+
+    // Trades sharing a time stamp make up one record:
+    do {
+        record_next.transactions[(float) msg_.values[TRADE_PRICE]] +=
+            (long) msg_.values[TRADE_VOLUME];
+
+        pending_ = false;
+
+    } while (_Peek() and msg_.date == record_next.date and
+             msg_.time <= record_next.time);
+
+    return true;
+}
+
+long TimeAndSales::_TimeLookAhead()
+{
+    return _Peek() ? msg_.time : -1;
+}
+
+void TimeAndSales::Reset()
+{
+    Streamer::Reset();
+
+    reader_.Close();
+    pending_ = false;
+
+    queue_.clear();
+    switched_ = false;
+}
+
+void TimeAndSales::SkipN(long n)
+{
+    for (long i = 0; i < n and _Peek(); i++)
+        pending_ = false;
+}
+
+bool TimeAndSales::Save(std::ostream& os)
+{
+    // Positions are only meaningful within the first file of a session:
+    if (switched_)
+        return false;
+
+    serialise::write(os, (uint64_t) reader_.Tell());
+
+    serialise::write(os, msg_);
+    serialise::write(os, pending_);
+
+    return Streamer::Save(os);
+}
+
+void TimeAndSales::Load(std::istream& is)
+{
+    uint64_t pos;
+    serialise::read(is, pos);
+
+    reader_.Seek(pos);
+
+    serialise::read(is, msg_);
+    serialise::read(is, pending_);
+
+    Streamer::Load(is);
+}
+
+void TimeAndSales::QueueFile(string path)
+{
+    queue_.push_back(path);
+}
+
+bool TimeAndSales::NextFile()
+{
+    if (queue_.empty())
+        return false;
+
+    Streamer::Reset();
+
+    reader_.Open(queue_.front());
+    queue_.pop_front();
+
+    pending_ = false;
+    switched_ = true;
+
+    LoadNext();
+
+    return true;
+}
@@ -38,6 +38,48 @@ void Streamer<R>::Reset()
     record_3.clear();
 }
 
+template<typename R>
+bool Streamer<R>::Save(std::ostream& os)
+{
+    record_1.save(os);
+    record_2.save(os);
+    record_3.save(os);
+
+    return true;
+}
+
+template<typename R>
+void Streamer<R>::Load(std::istream& is)
+{
+    record_1.load(is);
+    record_2.load(is);
+    record_3.load(is);
+}
+
+template<typename R>
+void Streamer<R>::QueueFile(string)
+{
+    throw runtime_error("[Streamer] Queueing files is not supported.");
+}
+
+template<typename R>
+bool Streamer<R>::NextFile()
+{
+    return false;
+}
+
+template<typename R>
+bool Streamer<R>::SeekTime(long time)
+{
+    return SkipUntil(record_next.date, time);
+}
+
+template<typename R>
+void Streamer<R>::SetResolution(long)
+{
+    throw runtime_error("[Streamer] Downsampling is not supported.");
+}
+
 template<typename R>
 bool Streamer<R>::LoadNext()
 {
@@ -0,0 +1,89 @@
+#include "data/time_index.h"
+#include "utilities/time.h"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace data;
+
+mutex TimeIndex::cache_mutex_;
+map<string, shared_ptr<const TimeIndex>> TimeIndex::cache_;
+
+TimeIndex::TimeIndex(const string& path):
+    date_(0)
+{
+    ifstream fs(path);
+    if (not fs.is_open())
+        throw runtime_error("[TimeIndex] Failed to open file: " + path);
+
+    string line;
+    getline(fs, line);      // Ignore header
+
+    long offset = fs.tellg(), last_second = -1;
+    while (getline(fs, line)) {
+        size_t c1 = line.find(','),
+               c2 = line.find(',', c1 + 1);
+
+        if (c1 != string::npos and c2 != string::npos) {
+            long t = string_to_time(line.substr(c1 + 1, c2 - c1 - 1));
+
+            if (date_ == 0)
+                date_ = stoi(line.substr(0, c1));
+
+            if (t / NS_PER_S != last_second) {
+                times_.push_back(t);
+                offsets_.push_back(offset);
+
+                last_second = t / NS_PER_S;
+            }
+        }
+
+        offset = fs.tellg();
+    }
+
+    if (times_.empty())
+        throw runtime_error("[TimeIndex] No rows in file: " + path);
+}
+
+int TimeIndex::date() const
+{
+    return date_;
+}
+
+long TimeIndex::first_time() const
+{
+    return times_.front();
+}
+
+long TimeIndex::last_time() const
+{
+    return times_.back();
+}
+
+long TimeIndex::Find(long time) const
+{
+    auto it = upper_bound(times_.begin(), times_.end(), time);
+    if (it != times_.begin()) --it;
+
+    return offsets_[it - times_.begin()];
+}
+
+shared_ptr<const TimeIndex> TimeIndex::Get(const string& path)
+{
+    {
+        lock_guard<mutex> lock(cache_mutex_);
+
+        auto it = cache_.find(path);
+        if (it != cache_.end())
+            return it->second;
+    }
+
+    // Build outside the lock; concurrent builds of the same file agree:
+    auto index = make_shared<const TimeIndex>(path);
+
+    lock_guard<mutex> lock(cache_mutex_);
+
+    return cache_.emplace(path, index).first->second;
+}
@@ -52,26 +52,47 @@ Base::Base(Config &c):
     // Debugging:
     INSPECT_BOOKS(c["debug"]["inspect_books"].as<bool>(false))
 {
+    // Any window that is warmed up must be part of the snapshot tag:
+    snapshot_tag_ =
+        "vwap=" + to_string(c["state"]["lookback"]["vwap"].as<int>(0)) +
+        ",mpm=" + to_string(c["state"]["lookback"]["mpm"].as<int>(0)) +
+        ",vlt=" + to_string(c["state"]["lookback"]["vlt"].as<int>(0)) +
+        ",svl=" + to_string(c["state"]["lookback"]["svl"].as<int>(0)) +
+        ",rsi=" + to_string(c["state"]["lookback"]["rsi"].as<int>(0)) +
+        ",spd=" + to_string(c["policy"]["spread_lookback"].as<int>(10)) +
+        ",pnl=" + to_string(c["reward"]["pnl_lookback"].as<int>(0)) +
+        ",tp=" + c["market"]["target_price"]["type"].as<string>("midprice") +
+        ":" + to_string(c["market"]["target_price"]["lookback"].as<int>(1));
+
     string rm = c["reward"]["measure"].as<string>("pnl");
-    if (rm == "none")
+    if (rm == "none") {
         reward = RewardMeasure::none;
-    else if (rm == "pnl")
+        reward_fn_ = &Base::_reward_none;
+    } else if (rm == "pnl") {
         reward = RewardMeasure::pnl;
-    else if (rm == "pnl_damped")
+        reward_fn_ = &Base::_reward_pnl;
+    } else if (rm == "pnl_damped") {
         reward = RewardMeasure::pnl_damped;
-    else if (rm == "spread")
+        reward_fn_ = &Base::_reward_pnl_damped;
+    } else if (rm == "spread") {
         reward = RewardMeasure::spread;
-    else if (rm == "normed")
+        reward_fn_ = &Base::_reward_spread;
+    } else if (rm == "normed") {
         reward = RewardMeasure::normed;
-    else if (rm == "lovol")
+        reward_fn_ = &Base::_reward_normed;
+    } else if (rm == "lovol") {
         reward = RewardMeasure::lovol;
-    else if (rm == "mm_linear")
+        reward_fn_ = &Base::_reward_lovol;
+    } else if (rm == "mm_linear") {
         reward = RewardMeasure::mm_linear;
-    else if (rm == "mm_exp")
+        reward_fn_ = &Base::_reward_mm_linear;
+    } else if (rm == "mm_exp") {
         reward = RewardMeasure::mm_exp;
-    else if (rm == "mm_div")
+        reward_fn_ = &Base::_reward_mm_exp;
+    } else if (rm == "mm_div") {
         reward = RewardMeasure::mm_div;
-    else
+        reward_fn_ = &Base::_reward_mm_div;
+    } else
         throw runtime_error("Unknown reward measure: " + rm);
 
     // Initialie latency sampler:
@@ -137,8 +158,13 @@ bool Base::Initialise()
 void Base::ClearStats()
 {
     episode_stats.reset();
+    marked_pnl = 0.0;
     trade_stats.reset();
     tick_stats.reset();
+    step_stats.reset();
+
+    session_ask_transactions = 0;
+    session_bid_transactions = 0;
 }
 
 void Base::ClearWindows()
@@ -162,78 +188,151 @@ void Base::ClearWindows()
     f_bid_transactions.clear();
 }
 
+void Base::SaveSnapshot(std::ostream& os)
+{
+    ask_book_.SaveState(os);
+    bid_book_.SaveState(os);
+
+    target_price_->save(os);
+
+    f_vwap_numer.save(os);
+    f_vwap_denom.save(os);
+
+    f_midprice.save(os);
+    f_volatility.save(os);
+    f_ask_transactions.save(os);
+    f_bid_transactions.save(os);
+
+    spread_window.save(os);
+    pnl_ups.save(os);
+    pnl_downs.save(os);
+
+    return_ups.save(os);
+    return_downs.save(os);
+}
+
+void Base::LoadSnapshot(std::istream& is)
+{
+    ask_book_.LoadState(is);
+    bid_book_.LoadState(is);
+
+    target_price_->load(is);
+
+    f_vwap_numer.load(is);
+    f_vwap_denom.load(is);
+
+    f_midprice.load(is);
+    f_volatility.load(is);
+    f_ask_transactions.load(is);
+    f_bid_transactions.load(is);
+
+    spread_window.load(is);
+    pnl_ups.load(is);
+    pnl_downs.load(is);
+
+    return_ups.load(is);
+    return_downs.load(is);
+}
+
+bool Base::FastForward(double&, double&, double&)
+{
+    return false;
+}
+
+void Base::MarkDecisionPoint() {}
+
 // Learning ---------------------------------------------------------
+void Base::getState(vector<float>& out)
+{
+    size_t offset = out.size();
+
+    out.resize(offset + getStateSize());
+    getState(&out[offset]);
+}
+
 double Base::getReward()
 {
-    double r = 0.0;
-    int abs_pos = abs(risk_manager_.exposure());
+    return (this->*reward_fn_)()*100;
+}
+
+double Base::_reward_none()
+{
+    return 0.0;
+}
+
+double Base::_reward_pnl()
+{
+    return pnl_step;
+}
 
-    switch (reward) {
-        case RewardMeasure::none:
-            break;
+double Base::_reward_pnl_damped()
+{
+    return pnl_step - r_damping_factor*max(0.0, momentum_pnl_step);
+}
 
-        case RewardMeasure::pnl:
-            r = pnl_step;
-            break;
+double Base::_reward_spread()
+{
+    return pnl_step / spread_window.mean();
+}
 
-        case RewardMeasure::pnl_damped:
-            r = pnl_step - r_damping_factor*max(0.0, momentum_pnl_step);
-            break;
+double Base::_reward_normed()
+{
+    if (not (pnl_ups.full() && pnl_downs.full()))
+        return 0.0;
 
-        case RewardMeasure::spread:
-            r = pnl_step / spread_window.mean();
-            break;
+    double u = pnl_ups.mean(),
+           d = pnl_downs.mean();
+    double su = pnl_ups.std(),
+           sd = pnl_downs.std();
 
-        case RewardMeasure::normed:
-            if (not (pnl_ups.full() && pnl_downs.full()))
-                r = 0.0;
-            else {
-                double u = pnl_ups.mean(),
-                       d = pnl_downs.mean();
-                double su = pnl_ups.std(),
-                       sd = pnl_downs.std();
+    double numer = (u*sd - d*su),
+           denom = (su + sd);
 
-                double numer = (u*sd - d*su),
-                       denom = (su + sd);
+    if (::isnan(numer) || ::isinf(numer)) numer = 0.0;
+    if (::isnan(denom) || ::isinf(denom)) denom = 0.0;
 
-                if (::isnan(numer) || ::isinf(numer)) numer = 0.0;
-                if (::isnan(denom) || ::isinf(denom)) denom = 0.0;
+    return (abs(denom) < 1e-5) ? numer : (numer / denom);
+}
 
-                r = (abs(denom) < 1e-5) ? numer : (numer / denom);
-            }
+double Base::_reward_lovol()
+{
+    return lo_vol_step;
+}
 
-            break;
+double Base::_reward_mm_linear()
+{
+    int abs_pos = abs(risk_manager_.exposure());
 
-        case RewardMeasure::lovol:
-            r = lo_vol_step;
-            break;
+    // Punish holding a position:
+    double r = -r_pos_weight * abs_pos;
 
-        case RewardMeasure::mm_linear:
-            // Punish holding a position:
-            r = -r_pos_weight * abs_pos;
+    // Reward/punish profit/loss from trades:
+    r += r_pnl_weight * pnl_step;
 
-            // Reward/punish profit/loss from trades:
-            r += r_pnl_weight * pnl_step;
+    return r;
+}
 
-            break;
+double Base::_reward_mm_exp()
+{
+    int abs_pos = abs(risk_manager_.exposure());
 
-        case RewardMeasure::mm_exp:
-            // Punish holding a position:
-            r = -pow(1.0 - exp(r_pos_weight * abs_pos), 2);
+    // Punish holding a position:
+    double r = -pow(1.0 - exp(r_pos_weight * abs_pos), 2);
 
-            // Reward/punish profit/loss from trades:
-            r += r_pnl_weight * pnl_step;
+    // Reward/punish profit/loss from trades:
+    r += r_pnl_weight * pnl_step;
 
-            break;
+    return r;
+}
 
-        case RewardMeasure::mm_div:
-            if (pnl_step > 0)
-                r = pnl_step / max(1.0, (double) abs_pos);
-            else
-                r = pnl_step;
-    }
+double Base::_reward_mm_div()
+{
+    int abs_pos = abs(risk_manager_.exposure());
 
-    return r*100;
+    if (pnl_step > 0)
+        return pnl_step / max(1.0, (double) abs_pos);
+    else
+        return pnl_step;
 }
 
 double Base::getPotential()
@@ -262,6 +361,7 @@ bool Base::performAction(int action)
 
     pnl_step = 0.0;
     momentum_pnl_step = 0.0;
+    captured_step = 0.0;
 
     // Given that the environment is first initialised we can assume
     // that we are currently in a valid state. This means that we should call
@@ -282,27 +382,31 @@ bool Base::performAction(int action)
     double agg_pnl = pnl_step;
     double agg_mpm = 0.0;
     long observed_volume = 0L;
-    do {
-        pnl_step = 0.0;
+    if (not FastForward(agg_r, agg_pnl, agg_mpm)) {
+        do {
+            pnl_step = 0.0;
+
+            /* Handle state transition */
+            if (not NextState())
+                return false;
 
-        /* Handle state transition */
-        if (not NextState())
-            return false;
+            // Add in the reward for moving to the new state
+            double mpm = midprice_move(ask_book_, bid_book_);
+            pnl_step += risk_manager_.exposure() * mpm;
+            momentum_pnl_step += risk_manager_.exposure() * mpm;
 
-        // Add in the reward for moving to the new state
-        double mpm = midprice_move(ask_book_, bid_book_);
-        pnl_step += risk_manager_.exposure() * mpm;
-        momentum_pnl_step += risk_manager_.exposure() * mpm;
+            agg_r += getReward();
+            agg_pnl += pnl_step;
+            agg_mpm += mpm;
 
-        agg_r += getReward();
-        agg_pnl += pnl_step;
-        agg_mpm += mpm;
+            observed_volume += ask_book_.observed_volume() +
+                               bid_book_.observed_volume();
 
-        observed_volume += ask_book_.observed_volume() +
-                           bid_book_.observed_volume();
+        // } while (false);
+        } while (not isTerminal() and abs(agg_mpm) < 1e-5);
 
-    // } while (false);
-    } while (not isTerminal() and abs(agg_mpm) < 1e-5);
+        MarkDecisionPoint();
+    }
 
     /* BLOCK 3 - Apply inventory constraints */
     // if (risk_manager_.at_bound()) {
@@ -322,13 +426,11 @@ bool Base::performAction(int action)
 
     // Logging {
     episode_stats.reward += agg_r;
-    experiment_stats.reward += agg_r;
-
-    // episode_stats.pnl += agg_pnl;
-    experiment_stats.pnl += agg_pnl;
-
     episode_stats.bandh += agg_mpm;
-    experiment_stats.bandh += agg_mpm;
+    marked_pnl += agg_pnl;
+
+    step_stats.pnl.push(pnl_step);
+    step_stats.spread_captured.push(captured_step);
 
     LogProfit(action, pnl_step, agg_mpm);
     // }
@@ -396,6 +498,12 @@ void Base::printInfo(int action)
 
 void Base::start_logging()
 {
+    profit_binlog = binlog::Log::Get("profit_log");
+    trade_binlog = binlog::Log::Get("trade_log");
+
+    if (profit_binlog != nullptr and trade_binlog != nullptr)
+        return;
+
     profit_logger = spdlog::get("profit_log");
     trade_logger = spdlog::get("trade_log");
 
@@ -407,13 +515,18 @@ void Base::stop_logging()
 {
     profit_logger = nullptr;
     trade_logger = nullptr;
+
+    profit_binlog = nullptr;
+    trade_binlog = nullptr;
 }
 
 void Base::UpdateStats()
 {
     // Episode stats:
-    trade_stats.ask_transactions = ask_book_.n_transacted();
-    trade_stats.bid_transactions = bid_book_.n_transacted();
+    trade_stats.ask_transactions =
+        session_ask_transactions + ask_book_.n_transacted();
+    trade_stats.bid_transactions =
+        session_bid_transactions + bid_book_.n_transacted();
 
     // Tick stats:
     tick_stats.total_ticks++;
@@ -431,6 +544,7 @@ void Base::UpdateStats()
         tick_stats.ticks_with_both++;
 
     long exposure = risk_manager_.exposure();
+    step_stats.inventory.push(exposure);
 
     if (exposure != 0)
         tick_stats.ticks_with_position++;
@@ -445,14 +559,32 @@ void Base::resetStats()
 {
     trade_stats.reset();
     tick_stats.reset();
+    step_stats.reset();
     episode_stats.reset();
+    marked_pnl = 0.0;
+}
+
+void Base::commitStats()
+{
+    experiment_stats.episodes++;
+
+    ExperimentStatistics totals = episode_stats;
+    totals.pnl = marked_pnl;
+
+    experiment_stats.totals.merge(totals);
+    experiment_stats.trades.merge(trade_stats);
+    experiment_stats.ticks.merge(tick_stats);
+    experiment_stats.steps.merge(step_stats);
 }
 
 void Base::writeStats(string path)
 {
     experiment_stats.write(path);
-    tick_stats.write(path);
-    trade_stats.write(path);
+}
+
+const Statistics& Base::getStats() const
+{
+    return experiment_stats;
 }
 
 double Base::getEpisodePnL()
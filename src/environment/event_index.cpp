@@ -0,0 +1,58 @@
+#include "environment/event_index.h"
+
+using namespace environment;
+
+EventIndexCache::EventIndexCache():
+    capacity_(0)
+{}
+
+EventIndexCache& EventIndexCache::Global()
+{
+    static EventIndexCache cache;
+
+    return cache;
+}
+
+void EventIndexCache::SetCapacity(size_t n)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    capacity_ = n;
+}
+
+std::shared_ptr<const EventIndex> EventIndexCache::Fetch(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = indices_.find(key);
+    if (it == indices_.end())
+        return nullptr;
+
+    return it->second;
+}
+
+void EventIndexCache::Store(const std::string& key,
+                            std::shared_ptr<const EventIndex> index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // First writer wins; indices of the same day are interchangeable:
+    if (not indices_.emplace(key, index).second)
+        return;
+
+    order_.push_back(key);
+
+    // Evict the oldest days once over capacity:
+    while (capacity_ > 0 and order_.size() > capacity_) {
+        indices_.erase(order_.front());
+        order_.pop_front();
+    }
+}
+
+void EventIndexCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    order_.clear();
+    indices_.clear();
+}
@@ -1,16 +1,26 @@
 #include "environment/intraday.h"
 
 #include "data/records.h"
+#include "data/itch.h"
+#include "data/live.h"
+#include "data/reuters.h"
+#include "data/downsampled.h"
+#include "data/time_index.h"
 #include "market/book.h"
 #include "market/market.h"
 #include "market/measures.h"
 #include "utilities/time.h"
 #include "utilities/maths.h"
+#include "utilities/serialise.h"
 #include "utilities/comparison.h"
+#include "environment/snapshot.h"
+#include "environment/event_index.h"
 
 #include <map>
 #include <cmath>
+#include <limits>
 #include <numeric>
+#include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <stdexcept>
@@ -42,7 +52,20 @@ Intraday<T1, T2>::Intraday(Config& c):
     market_depth(),
     time_and_sales(),
 
-    state_vars()
+    state_vars(),
+    state_kernels(),
+
+    SLICE_LENGTH(add_minutes(c["data"]["slice"]["minutes"].as<long>(0), 0)),
+    SLICE_STEPS(c["data"]["slice"]["steps"].as<long>(0)),
+
+    slice_gen_(c["debug"]["random_seed"].as<unsigned>(random_device{}())),
+
+    // Snapshots and event indices are per day, not per slice:
+    WARM_START(c["data"]["warm_start"].as<bool>(false) and not _IsSliced()),
+
+    EVENT_INDEX(c["data"]["event_index"].as<bool>(false) and not _IsSliced()),
+
+    COMPACT(c["data"]["compact"].as<bool>(true))
 {
     static_assert(is_base_of<data::MarketDepth, T1>::value,
                   "T1 is not a subclass of data::MarketDepth");
@@ -53,6 +76,7 @@ Intraday<T1, T2>::Intraday(Config& c):
     for (auto it = v.begin(); it != v.end(); ++it) {
         try {
             state_vars.push_back(v_to_i.at(*it));
+            state_kernels.push_back(kernel(state_vars.back()));
 
         } catch (const out_of_range& oor) {
             cout << "Unknown state variable: " << *it << "." << endl;
@@ -61,6 +85,14 @@ Intraday<T1, T2>::Intraday(Config& c):
         }
     }
 
+    if (WARM_START and c["data"]["snapshot_dir"])
+        SnapshotCache::Global().SetDirectory(
+            c["data"]["snapshot_dir"].as<string>());
+
+    if (EVENT_INDEX and c["data"]["event_index_days"])
+        EventIndexCache::Global().SetCapacity(
+            c["data"]["event_index_days"].as<size_t>());
+
     if (c["market"]["target_price"]["type"].as<string>() == "book") {
         l2p_ = [this](int al, int bl) {
             return std::make_tuple(
@@ -95,6 +127,8 @@ Intraday<T1, T2>::Intraday(Config& c,
 template<class T1, class T2>
 Intraday<T1, T2>::~Intraday()
 {
+    PublishEventIndex();
+
     if (market != nullptr)
         delete market;
 }
@@ -104,10 +138,73 @@ bool Intraday<T1, T2>::Initialise()
 {
     bool stat = Base::Initialise();
 
+    PublishEventIndex();
+
     last_date = 0;
     market->set_date(0);
     market->set_time(0L);
 
+    n_steps_ = 0;
+    slice_end_ = 0;
+
+    if (_IsSliced() and not _SeekSlice())
+        return false;
+
+    // Skip the warm-up replay if we have already seen this day:
+    if (WARM_START and RestoreSnapshot()) {
+        BeginEventIndex();
+        _place_orders(1, 1);
+
+        return stat;
+    }
+
+    if (not _WarmUp())
+        return false;
+
+    ref_time = market->time();
+    init_date = market->date();
+
+    if (SLICE_LENGTH > 0)
+        slice_end_ = market->time() + SLICE_LENGTH;
+
+    if (WARM_START)
+        StoreSnapshot();
+
+    BeginEventIndex();
+    _place_orders(1, 1);
+
+    return stat;
+}
+
+template<class T1, class T2>
+bool Intraday<T1, T2>::_IsSliced()
+{
+    return SLICE_LENGTH > 0 or SLICE_STEPS > 0;
+}
+
+template<class T1, class T2>
+bool Intraday<T1, T2>::_SeekSlice()
+{
+    auto index = data::TimeIndex::Get(md_path_);
+
+    // Start anywhere (to the second) that leaves room for the whole slice
+    // within trading hours:
+    long lo = max(index->first_time(), add_minutes(30, market->open_time())),
+         hi = min(index->last_time(), add_minutes(-30, market->close_time())) -
+              SLICE_LENGTH;
+
+    slice_start_ = lo;
+    if (hi > lo)
+        slice_start_ = NS_PER_S * uniform_int_distribution<long>(
+            lo / NS_PER_S, hi / NS_PER_S)(slice_gen_);
+
+    return market_depth.SeekTime(slice_start_) and
+        time_and_sales.SeekTime(slice_start_);
+}
+
+template<class T1, class T2>
+bool Intraday<T1, T2>::_WarmUp()
+{
     // Keep loading data until we are ready:
     while (not market->IsOpen())
         if (not UpdateBookProfiles())
@@ -129,36 +226,392 @@ bool Intraday<T1, T2>::Initialise()
 
     time_and_sales.SkipUntil(market->date(), market->time());
 
-    ref_time = market->time();
-    init_date = market->date();
+    return true;
+}
 
-    _place_orders(1, 1);
+template<class T1, class T2>
+bool Intraday<T1, T2>::_DayIsOver()
+{
+    // Either the market has closed or the next record belongs to another
+    // day (or there is none):
+    return (not market->IsOpen()) or
+        (market_depth.NextDate() != market->date());
+}
 
-    return stat;
+template<class T1, class T2>
+bool Intraday<T1, T2>::_Overnight()
+{
+    // Event indices are per day, so stop recording and jumping here:
+    PublishEventIndex();
+
+    if (not (market_depth.NextFile() and time_and_sales.NextFile()))
+        return false;
+
+    days_left_--;
+
+    // Resting orders are cancelled overnight, but the position is carried:
+    double close = midprice(ask_book_, bid_book_);
+
+    // Resetting the books restarts their fill counts too:
+    session_ask_transactions += ask_book_.n_transacted();
+    session_bid_transactions += bid_book_.n_transacted();
+
+    ask_book_.Reset();
+    bid_book_.Reset();
+
+    // Price-level windows would straddle the overnight gap; the flow, spread
+    // and return windows carry over to the next day:
+    target_price_->clear();
+
+    f_midprice.clear();
+    f_volatility.clear();
+
+    f_vwap_numer.clear();
+    f_vwap_denom.clear();
+
+    last_date = 0;
+    market->set_date(0);
+    market->set_time(0L);
+
+    if (not _WarmUp())
+        return false;
+
+    // Mark the position to market over the gap, up to the last mid-price
+    // (the step adds the move from there):
+    double gap = last_midprice(ask_book_, bid_book_) - close;
+
+    pnl_step += risk_manager_.exposure() * gap;
+    momentum_pnl_step += risk_manager_.exposure() * gap;
+
+    _place_orders(ask_level, bid_level);
+
+    return true;
+}
+
+template<class T1, class T2>
+string Intraday<T1, T2>::_SnapshotKey()
+{
+    return snapshot_tag_ + "|" + md_path_ + "|" + tas_path_;
+}
+
+template<class T1, class T2>
+bool Intraday<T1, T2>::RestoreSnapshot()
+{
+    string blob;
+    if (not SnapshotCache::Global().Fetch(_SnapshotKey(), blob))
+        return false;
+
+    istringstream is(blob);
+    LoadSnapshot(is);
+
+    return true;
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::StoreSnapshot()
+{
+    ostringstream os;
+
+    // Streamers that cannot report their position are not cacheable:
+    try {
+        SaveSnapshot(os);
+    } catch (runtime_error& e) {
+        return;
+    }
+
+    SnapshotCache::Global().Store(_SnapshotKey(), os.str());
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::SaveSnapshot(std::ostream& os)
+{
+    Base::SaveSnapshot(os);
+
+    serialise::write(os, market->date());
+    serialise::write(os, market->time());
+
+    serialise::write(os, last_date);
+    serialise::write(os, init_date);
+    serialise::write(os, ref_time);
+
+    if (not (market_depth.Save(os) and time_and_sales.Save(os)))
+        throw runtime_error("[Intraday] Streamer position unavailable.");
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::LoadSnapshot(std::istream& is)
+{
+    Base::LoadSnapshot(is);
+
+    int date;
+    long time;
+    serialise::read(is, date);
+    serialise::read(is, time);
+
+    market->set_date(date);
+    market->set_time(time);
+
+    serialise::read(is, last_date);
+    serialise::read(is, init_date);
+    serialise::read(is, ref_time);
+
+    market_depth.Load(is);
+    time_and_sales.Load(is);
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::BeginEventIndex()
+{
+    event_ = 0;
+    interval_ = 0;
+    interval_start_ = 0;
+
+    _ResetExtents();
+
+    if (not EVENT_INDEX)
+        return;
+
+    // Use a completed index if one exists, otherwise build our own from this
+    // episode's replay:
+    index_ = EventIndexCache::Global().Fetch(_SnapshotKey());
+
+    if (index_ == nullptr)
+        recording_ = make_shared<EventIndex>();
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::PublishEventIndex()
+{
+    _SyncStreams();
+
+    if (recording_ != nullptr and not recording_->intervals.empty())
+        EventIndexCache::Global().Store(_SnapshotKey(), recording_);
+
+    index_ = nullptr;
+    recording_ = nullptr;
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::_SaveCursor(std::ostream& os)
+{
+    ask_book_.SaveState(os);
+    bid_book_.SaveState(os);
+
+    serialise::write(os, market->date());
+    serialise::write(os, market->time());
+    serialise::write(os, last_date);
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::_LoadCursor(const string& cursor)
+{
+    cursor_is_.str(cursor);
+    cursor_is_.clear();
+
+    ask_book_.LoadState(cursor_is_);
+    bid_book_.LoadState(cursor_is_);
+
+    int date;
+    long time;
+    serialise::read(cursor_is_, date);
+    serialise::read(cursor_is_, time);
+
+    market->set_date(date);
+    market->set_time(time);
+
+    serialise::read(cursor_is_, last_date);
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::_SyncStreams()
+{
+    if (pending_streams_ == nullptr)
+        return;
+
+    cursor_is_.str(*pending_streams_);
+    cursor_is_.clear();
+
+    market_depth.Load(cursor_is_);
+    time_and_sales.Load(cursor_is_);
+
+    pending_streams_ = nullptr;
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::_ReplayEvent(const IndexedEvent& e)
+{
+    f_midprice.push(e.mid_ticks);
+    f_volatility.push(e.mid_ticks);
+    f_vwap_numer.push(e.obs.value);
+    f_vwap_denom.push(e.obs.volume);
+
+    spread_window.push(max(0.0, e.spread));
+    target_price_->update(e.obs);
+
+    return_ups.push(max(0.0, e.mpm));
+    return_downs.push(abs(min(0.0, e.mpm)));
+
+    f_ask_transactions.push(e.ask_volume);
+    f_bid_transactions.push(e.bid_volume);
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::_ResetExtents()
+{
+    ask_extent_ = 0.0;
+    bid_extent_ = numeric_limits<double>::max();
+}
+
+template<class T1, class T2>
+bool Intraday<T1, T2>::_QuotesAtRisk(const DecisionInterval& di)
+{
+    // An order is untouched over the interval if its price never appears in
+    // the visible book, is never traded through and is never crossed by the
+    // opposite touch. Allow half a tick of slack on the comparisons.
+    if (ask_book_.order_count() > 0) {
+        double hi = max(di.ask_extent,
+                        max(ask_book_.price(-1), bid_book_.price(0)));
+
+        if (ask_book_.best_open_order_price() - hi <= market->tick_size(hi) / 2.0)
+            return true;
+    }
+
+    if (bid_book_.order_count() > 0) {
+        double lo = min(di.bid_extent,
+                        min(bid_book_.price(-1), ask_book_.price(0)));
+
+        if (lo - bid_book_.best_open_order_price() <= market->tick_size(lo) / 2.0)
+            return true;
+    }
+
+    return false;
+}
+
+template<class T1, class T2>
+bool Intraday<T1, T2>::FastForward(double& agg_r, double& agg_pnl,
+                                   double& agg_mpm)
+{
+    if (index_ == nullptr or interval_ >= index_->intervals.size())
+        return false;
+
+    const DecisionInterval& di = index_->intervals[interval_];
+    if (di.start != event_ or _QuotesAtRisk(di))
+        return false;
+
+    // No fills can occur, so the position is fixed over the interval:
+    long exposure = risk_manager_.exposure();
+    for (size_t i = event_; i < di.end; i++) {
+        const IndexedEvent& e = index_->events[i];
+
+        _ReplayEvent(e);
+
+        pnl_step = 0.0;
+        pnl_step += exposure * e.mpm;
+        momentum_pnl_step += exposure * e.mpm;
+
+        agg_r += getReward();
+        agg_pnl += pnl_step;
+        agg_mpm += e.mpm;
+    }
+
+    _LoadCursor(di.cursor);
+    pending_streams_ = &di.streams;
+
+    event_ = interval_start_ = di.end;
+    interval_++;
+
+    return true;
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::MarkDecisionPoint()
+{
+    if (recording_ != nullptr) {
+        DecisionInterval di;
+
+        di.start = interval_start_;
+        di.end = event_;
+        di.ask_extent = ask_extent_;
+        di.bid_extent = bid_extent_;
+
+        cursor_os_.str("");
+        _SaveCursor(cursor_os_);
+        di.cursor = cursor_os_.str();
+
+        // Streamers that cannot report their position are not indexable:
+        cursor_os_.str("");
+        if (market_depth.Save(cursor_os_) and time_and_sales.Save(cursor_os_)) {
+            di.streams = cursor_os_.str();
+
+            recording_->intervals.push_back(std::move(di));
+
+        } else
+            recording_ = nullptr;
+    }
+
+    interval_++;
+    interval_start_ = event_;
+    _ResetExtents();
 }
 
 template<class T1, class T2>
 void Intraday<T1, T2>::LoadData(string ticker, string md_path, string tas_path)
 {
+    PublishEventIndex();
+
     market_depth.LoadCSV(md_path);
     time_and_sales.LoadCSV(tas_path);
 
+    md_path_ = md_path;
+    tas_path_ = tas_path;
+
     std::string symbol = ticker.substr(0, ticker.find_first_of('.'));
     std::string venue  = ticker.substr(ticker.find_first_of('.') + 1);
 
     market = market::Market::make_market(symbol, venue);
+
+    days_left_ = 0;
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::QueueData(string md_path, string tas_path)
+{
+    market_depth.QueueFile(md_path);
+    time_and_sales.QueueFile(tas_path);
+
+    days_left_++;
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::SetResolution(long ms)
+{
+    market_depth.SetResolution(ms);
+    time_and_sales.SetResolution(ms);
 }
 
 template<class T1, class T2>
 bool Intraday<T1, T2>::isTerminal()
 {
+    if ((slice_end_ > 0 and market->time() >= slice_end_) or
+        (SLICE_STEPS > 0 and n_steps_ >= SLICE_STEPS))
+        return true;
+
+    // Day ends are handled in NextState until the last day of a session:
+    if (days_left_ > 0)
+        return false;
+
     return (not market->IsOpen()) or
         ((last_date != 0) and (market->date() != last_date));
 }
 
 template<class T1, class T2>
 string Intraday<T1, T2>::getEpisodeId()
-{ return to_string(init_date); }
+{
+    if (_IsSliced())
+        return to_string(init_date) + "@" + time_to_string(slice_start_);
+
+    return to_string(init_date);
+}
 
 template<class T1, class T2>
 void Intraday<T1, T2>::_place_orders(int al, int bl, bool replace)
@@ -175,7 +628,8 @@ void Intraday<T1, T2>::_place_orders(int al, int bl, bool replace)
 template<class T1, class T2>
 void Intraday<T1, T2>::DoAction(int action)
 {
-    ref_time = (long) ceil(market->time() + latency_->sample());
+    ref_time = market->time() + millis_to_time(latency_->sample());
+    n_steps_++;
 
     // Do the action
     switch (action) {
@@ -224,11 +678,16 @@ void Intraday<T1, T2>::DoAction(int action)
 template<class T1, class T2>
 bool Intraday<T1, T2>::NextState()
 {
+    _SyncStreams();
+
+    if (days_left_ > 0 and _DayIsOver())
+        return _Overnight();
+
     int target_date = market_depth.NextDate();
     long target_time = market_depth.NextTime();
 
     if (not time_and_sales.LoadUntil(target_date, target_time))
-        return false;
+        return days_left_ > 0 and _Overnight();
 
     const data::TimeAndSalesRecord& rec_ts = time_and_sales.Record();
 
@@ -237,12 +696,13 @@ bool Intraday<T1, T2>::NextState()
          bu = bid_book_.ApplyTransactions(rec_ts.transactions, mp);
 
     if (not UpdateBookProfiles(rec_ts.transactions))
-        return false;
+        return days_left_ > 0 and _Overnight();
 
     auto adverse_selection =
         market::BookUtils::HandleAdverseSelection(ask_book_, bid_book_);
 
     pnl_step += get<1>(au) + get<1>(bu) + get<1>(adverse_selection);
+    captured_step += get<1>(au) + get<1>(bu) + get<1>(adverse_selection);
     lo_vol_step += get<0>(bu) - get<0>(au) + abs(get<0>(adverse_selection));
 
     episode_stats.pnl += get<2>(au) + get<2>(bu) + get<2>(adverse_selection);
@@ -250,23 +710,29 @@ bool Intraday<T1, T2>::NextState()
     // Update our position:
     risk_manager_.Update(get<0>(bu) + get<0>(au) + get<0>(adverse_selection));
 
-    long mpt = market->ToTicks(midprice(ask_book_, bid_book_));
-    double mpm = midprice_move(ask_book_, bid_book_),
-           sp = spread(ask_book_, bid_book_);
+    IndexedEvent e;
 
-    f_midprice.push(mpt);
-    f_volatility.push(mpt);
-    f_vwap_numer.push(ask_book_.observed_value() + bid_book_.observed_value());
-    f_vwap_denom.push(ask_book_.observed_volume() + bid_book_.observed_volume());
+    e.mid_ticks = market->ToTicks(midprice(ask_book_, bid_book_));
+    e.mpm = midprice_move(ask_book_, bid_book_);
+    e.spread = spread(ask_book_, bid_book_);
 
-    spread_window.push(max(0.0, sp));
-    target_price_->update(ask_book_, bid_book_);
+    e.ask_volume = ask_book_.observed_volume();
+    e.bid_volume = bid_book_.observed_volume();
 
-    return_ups.push(max(0.0, mpm));
-    return_downs.push(abs(min(0.0, mpm)));
+    e.obs = market::tp::Observation::from(ask_book_, bid_book_);
 
-    f_ask_transactions.push(ask_book_.observed_volume());
-    f_bid_transactions.push(bid_book_.observed_volume());
+    _ReplayEvent(e);
+
+    if (recording_ != nullptr) {
+        if (not rec_ts.transactions.empty()) {
+            ask_extent_ = max(ask_extent_, rec_ts.transactions.rbegin()->first);
+            bid_extent_ = min(bid_extent_, rec_ts.transactions.begin()->first);
+        }
+
+        recording_->events.push_back(e);
+    }
+
+    event_++;
 
     return true;
 }
@@ -287,13 +753,14 @@ bool Intraday<T1, T2>::UpdateBookProfiles(
         market->set_date(rec_md.date);
         market->set_time(rec_md.time);
 
-        ask_book_.ApplyChanges(rec_md.ask_prices,
-                               rec_md.ask_volumes,
-                               transactions);
+        _ApplyDepth(rec_md, transactions);
 
-        bid_book_.ApplyChanges(rec_md.bid_prices,
-                               rec_md.bid_volumes,
-                               transactions);
+        if (recording_ != nullptr) {
+            ask_extent_ = max(ask_extent_,
+                              max(ask_book_.price(-1), bid_book_.price(0)));
+            bid_extent_ = min(bid_extent_,
+                              min(bid_book_.price(-1), ask_book_.price(0)));
+        }
 
         if (not market_depth.WillTimeChange()) continue;
 
@@ -313,111 +780,190 @@ bool Intraday<T1, T2>::UpdateBookProfiles(
 }
 
 template<class T1, class T2>
-double Intraday<T1, T2>::getVariable(Variable v)
+void Intraday<T1, T2>::_ApplyDepth(
+    const data::MarketDepthRecord& rec,
+    const std::map<double, long, FloatComparator<>>& transactions)
+{
+    // Each side is held or rebuilt on its own; both give the same book:
+    if (not (COMPACT and ask_book_.HoldState(rec.ask_prices, rec.ask_volumes)))
+        ask_book_.ApplyChanges(rec.ask_prices, rec.ask_volumes, transactions);
+
+    if (not (COMPACT and bid_book_.HoldState(rec.bid_prices, rec.bid_volumes)))
+        bid_book_.ApplyChanges(rec.bid_prices, rec.bid_volumes, transactions);
+}
+
+template<class T1, class T2>
+typename Intraday<T1, T2>::VariableKernel Intraday<T1, T2>::kernel(Variable v)
 {
     switch (v) {
-        case Variable::pos:
-            // Generalise -> ORDER_SIZE (default: 1)
-            return double(risk_manager_.exposure()) / ORDER_SIZE;
-
-        case Variable::spd:
-            // Generalise -> 1 tick
-            return ulb((double)(market->ToTicks(ask_book_.price(0)) -
-                                market->ToTicks(bid_book_.price(0))),
-                       0.0, 20.0);
-
-        case Variable::mpm:
-            // Generalise -> 1 tick
-            return ulb(
-                (double)(market->ToTicks(f_midprice.front()) -
-                         market->ToTicks(f_midprice.back())),
-                -10.0, 10.0
-                );
-
-        case Variable::imb: {
-            double v_a = (double) ask_book_.total_volume(),
-                   v_b = (double) bid_book_.total_volume();
-
-            // Generalise -> 0.2
-            return ((v_a + v_b) > 0 ? 5*(v_b - v_a) / (v_b + v_a) : 0.0);
-        }
+        case Variable::pos: return &Intraday::_pos;
+        case Variable::spd: return &Intraday::_spd;
+        case Variable::mpm: return &Intraday::_mpm;
+        case Variable::imb: return &Intraday::_imb;
+        case Variable::svl: return &Intraday::_svl;
+        case Variable::vol: return &Intraday::_vol;
+        case Variable::rsi: return &Intraday::_rsi;
+        case Variable::vwap: return &Intraday::_vwap;
+        case Variable::a_dist: return &Intraday::_a_dist;
+        case Variable::a_queue: return &Intraday::_a_queue;
+        case Variable::b_dist: return &Intraday::_b_dist;
+        case Variable::b_queue: return &Intraday::_b_queue;
+        case Variable::last_action: return &Intraday::_last_action;
 
-        case Variable::svl: {
-            double q_a = (double) f_ask_transactions.sum(),
-                   q_b = (double) f_bid_transactions.sum();
+        default:
+            throw std::invalid_argument("Unknown state-var enum value: " +
+                                        to_string((int) v) + ".");
+    }
+}
 
-            // Generalise -> 0.2
-            return ((q_a + q_b) > 0 ? 5*(q_b - q_a) / (q_a + q_b) : 0.0);
-        }
+template<class T1, class T2>
+double Intraday<T1, T2>::_pos()
+{
+    // Generalise -> ORDER_SIZE (default: 1)
+    return double(risk_manager_.exposure()) / ORDER_SIZE;
+}
 
-        case Variable::vol:
-            return ulb(5.0*f_volatility.std(), 0.0, 10.0);
+template<class T1, class T2>
+double Intraday<T1, T2>::_spd()
+{
+    // Generalise -> 1 tick
+    return ulb((double)(market->ToTicks(ask_book_.price(0)) -
+                        market->ToTicks(bid_book_.price(0))),
+               0.0, 20.0);
+}
 
-        case Variable::rsi: {
-            double u = return_ups.mean(),
-                   d = return_downs.mean();
+template<class T1, class T2>
+double Intraday<T1, T2>::_mpm()
+{
+    // Generalise -> 1 tick
+    return ulb(
+        (double)(market->ToTicks(f_midprice.front()) -
+                 market->ToTicks(f_midprice.back())),
+        -10.0, 10.0
+        );
+}
 
-            // Generalise -> 0.20
-            return (u + d) != 0.0 ? 5.0 * (u - d) / (u + d) : 0.0;
-        }
+template<class T1, class T2>
+double Intraday<T1, T2>::_imb()
+{
+    double v_a = (double) ask_book_.total_volume(),
+           v_b = (double) bid_book_.total_volume();
 
-        case Variable::vwap: {
-            double d = f_vwap_numer.sum() / f_vwap_denom.sum();
+    // Generalise -> 0.2
+    return ((v_a + v_b) > 0 ? 5*(v_b - v_a) / (v_b + v_a) : 0.0);
+}
 
-            return ulb(
-                d / spread_window.mean(), -10.0, 10.0
-            );
-        }
+template<class T1, class T2>
+double Intraday<T1, T2>::_svl()
+{
+    double q_a = (double) f_ask_transactions.sum(),
+           q_b = (double) f_bid_transactions.sum();
 
-        case Variable::a_dist:
-            // Generalise -> 1 tick
-            if (ask_book_.order_count() > 0)
-                return ((double) market->ToTicks(ask_book_.best_open_order_price()) -
-                        (double) market->ToTicks(ask_book_.price(0)));
-            else
-                return -100.0;
-
-        case Variable::a_queue:
-            // Generalise -> 10%
-            if (ask_book_.order_count() > 0)
-                return 10.0 * ask_book_.queue_progress();
-            else
-                return -1.0;
-
-        case Variable::b_dist:
-            // Generalise -> 1 tick
-            if (bid_book_.order_count() > 0)
-                return ((double) market->ToTicks(bid_book_.price(0)) -
-                        (double) market->ToTicks(bid_book_.best_open_order_price()));
-            else
-                return -100.0;
-
-        case Variable::b_queue:
-            // Generalise -> 10%
-            if (bid_book_.order_count() > 0)
-                return 10.0 * bid_book_.queue_progress();
-            else
-                return -1.0;
-
-        case Variable::last_action:
-            return last_action;
+    // Generalise -> 0.2
+    return ((q_a + q_b) > 0 ? 5*(q_b - q_a) / (q_a + q_b) : 0.0);
+}
 
-        default:
-            throw std::invalid_argument("Unknown state-var enum value: " +
-                                        to_string((int) v) + ".");
-    }
+template<class T1, class T2>
+double Intraday<T1, T2>::_vol()
+{
+    return ulb(5.0*f_volatility.std(), 0.0, 10.0);
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::_rsi()
+{
+    double u = return_ups.mean(),
+           d = return_downs.mean();
+
+    // Generalise -> 0.20
+    return (u + d) != 0.0 ? 5.0 * (u - d) / (u + d) : 0.0;
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::_vwap()
+{
+    double d = f_vwap_numer.sum() / f_vwap_denom.sum();
+
+    return ulb(
+        d / spread_window.mean(), -10.0, 10.0
+    );
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::_a_dist()
+{
+    // Generalise -> 1 tick
+    if (ask_book_.order_count() > 0)
+        return ((double) market->ToTicks(ask_book_.best_open_order_price()) -
+                (double) market->ToTicks(ask_book_.price(0)));
+    else
+        return -100.0;
 }
 
 template<class T1, class T2>
-void Intraday<T1, T2>::getState(std::vector<float>& out)
+double Intraday<T1, T2>::_a_queue()
 {
-    for (auto it = state_vars.begin(); it != state_vars.end(); ++it)
-        out.push_back(getVariable(*it));
+    // Generalise -> 10%
+    if (ask_book_.order_count() > 0)
+        return 10.0 * ask_book_.queue_progress();
+    else
+        return -1.0;
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::_b_dist()
+{
+    // Generalise -> 1 tick
+    if (bid_book_.order_count() > 0)
+        return ((double) market->ToTicks(bid_book_.price(0)) -
+                (double) market->ToTicks(bid_book_.best_open_order_price()));
+    else
+        return -100.0;
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::_b_queue()
+{
+    // Generalise -> 10%
+    if (bid_book_.order_count() > 0)
+        return 10.0 * bid_book_.queue_progress();
+    else
+        return -1.0;
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::_last_action()
+{
+    return last_action;
+}
+
+template<class T1, class T2>
+double Intraday<T1, T2>::getVariable(Variable v)
+{
+    return (this->*kernel(v))();
+}
+
+template<class T1, class T2>
+size_t Intraday<T1, T2>::getStateSize()
+{
+    return state_kernels.size();
+}
+
+template<class T1, class T2>
+void Intraday<T1, T2>::getState(float* out)
+{
+    const size_t n = state_kernels.size();
+    const VariableKernel* k = state_kernels.data();
+
+    for (size_t i = 0; i < n; i++)
+        out[i] = (this->*k[i])();
 }
 
 template<class T1, class T2>
 void Intraday<T1, T2>::printInfo(const int action)
 {
+    _SyncStreams();
+
     cout << "Date: " << market->date() << endl;
     cout << "Time: " << time_to_string(market->time()) << "ms" << endl;
 
@@ -437,7 +983,17 @@ void Intraday<T1, T2>::printInfo(const int action)
 template<class T1, class T2>
 void Intraday<T1, T2>::LogProfit(int action, double pnl, double bandh)
 {
-    if (profit_logger != nullptr)
+    if (profit_binlog != nullptr)
+        profit_binlog->append(market->date(),
+                              market->time(),
+                              action,
+                              risk_manager_.exposure(),
+                              midprice(ask_book_, bid_book_),
+                              spread(ask_book_, bid_book_),
+                              ask_quote, bid_quote,
+                              ask_level, bid_level,
+                              pnl, bandh);
+    else if (profit_logger != nullptr)
         profit_logger->info("{},{},{},{},{},{},{},{},{},{},{},{}",
                             market->date(),
                             market->time(),
@@ -454,7 +1010,11 @@ template<class T1, class T2>
 void Intraday<T1, T2>::LogTrade(char side, char type, double price,
                                 long size, double pnl)
 {
-    if (trade_logger != nullptr)
+    if (trade_binlog != nullptr)
+        trade_binlog->append(market->date(), market->time(),
+                             risk_manager_.exposure(),
+                             side, type, price, size, pnl);
+    else if (trade_logger != nullptr)
         trade_logger->info("{},{},{},{},{},{},{},{}",
                            market->date(), market->time(),
                            risk_manager_.exposure(),
@@ -464,3 +1024,18 @@ void Intraday<T1, T2>::LogTrade(char side, char type, double price,
 // Template specialisations
 template class environment::Intraday<data::basic::MarketDepth,
                                      data::basic::TimeAndSales>;
+template class environment::Intraday<
+    data::Downsampled<data::basic::MarketDepth>,
+    data::Downsampled<data::basic::TimeAndSales>>;
+template class environment::Intraday<data::reuters::MarketDepth,
+                                     data::reuters::TimeAndSales>;
+template class environment::Intraday<
+    data::Downsampled<data::reuters::MarketDepth>,
+    data::Downsampled<data::reuters::TimeAndSales>>;
+template class environment::Intraday<data::itch::MarketDepth,
+                                     data::itch::TimeAndSales>;
+template class environment::Intraday<
+    data::Downsampled<data::itch::MarketDepth>,
+    data::Downsampled<data::itch::TimeAndSales>>;
+template class environment::Intraday<data::live::MarketDepth,
+                                     data::live::TimeAndSales>;
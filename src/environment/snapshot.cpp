@@ -0,0 +1,104 @@
+#include "environment/snapshot.h"
+#include "utilities/serialise.h"
+
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <functional>
+
+using namespace environment;
+
+SnapshotCache& SnapshotCache::Global()
+{
+    static SnapshotCache cache;
+
+    return cache;
+}
+
+void SnapshotCache::SetDirectory(std::string dir)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (not dir.empty() and dir.back() != '/')
+        dir.append("/");
+
+    directory_ = dir;
+}
+
+std::string SnapshotCache::_FilePath(const std::string& key)
+{
+    std::stringstream ss;
+    ss << directory_ << "snapshot_" << std::hex << std::setfill('0')
+       << std::setw(16) << std::hash<std::string>()(key) << ".bin";
+
+    return ss.str();
+}
+
+bool SnapshotCache::Fetch(const std::string& key, std::string& blob)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = blobs_.find(key);
+    if (it != blobs_.end()) {
+        blob = it->second;
+
+        return true;
+    }
+
+    if (directory_.empty())
+        return false;
+
+    std::ifstream ifs(_FilePath(key), std::ios::binary);
+    if (not ifs.is_open())
+        return false;
+
+    try {
+        std::string stored_key;
+        serialise::read(ifs, stored_key);
+
+        // Guard against hash collisions between different keys:
+        if (stored_key != key)
+            return false;
+
+        serialise::read(ifs, blob);
+
+    } catch (std::runtime_error& e) {
+        std::cout << "[SnapshotCache] Ignoring corrupt snapshot for: "
+                  << key << std::endl;
+
+        return false;
+    }
+
+    blobs_[key] = blob;
+
+    return true;
+}
+
+void SnapshotCache::Store(const std::string& key, const std::string& blob)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    blobs_[key] = blob;
+
+    if (directory_.empty())
+        return;
+
+    std::ofstream ofs(_FilePath(key), std::ios::binary);
+    if (not ofs.is_open()) {
+        std::cout << "[SnapshotCache] Failed to write snapshot to: "
+                  << directory_ << std::endl;
+
+        return;
+    }
+
+    serialise::write(ofs, key);
+    serialise::write(ofs, blob);
+}
+
+void SnapshotCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    blobs_.clear();
+}
@@ -1,26 +1,225 @@
 #include "environment/statistics.h"
 
+#include <cmath>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
 using namespace environment;
 
-void ExperimentStatistics::write(std::string path)
+// Magnitudes below this are counted as zero by the quantile sketch:
+static const double SKETCH_ZERO = 1e-12;
+
+static const double QUANTILES[] = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+
+// ------------------------------------------------------------------
+void Moments::merge(const Moments& other)
 {
-    try {
-        std::ofstream ofs(path, std::ofstream::out);
+    if (other.n == 0) return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
 
-        ofs << "reward," << reward << std::endl;
-        ofs << "pnl," << pnl << std::endl;
-        ofs << "bandh," << bandh << std::endl;
+    long total = n + other.n;
+    double delta = other.mean - mean;
 
-        ofs.close();
+    mean += delta * other.n / total;
+    m2 += other.m2 + delta * delta * ((double) n * other.n / total);
 
-    } catch (std::runtime_error& e) {
-        std::cout << "Error writing experiment stats to: " << path << std::endl;
-        std::cout << e.what() << std::endl;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+
+    n = total;
+}
+
+double Moments::sum() const
+{
+    return mean * n;
+}
+
+double Moments::variance() const
+{
+    return n > 1 ? m2 / (n - 1) : 0.0;
+}
+
+double Moments::stddev() const
+{
+    return std::sqrt(variance());
+}
+
+void Moments::reset()
+{
+    n = 0;
+
+    mean = 0.0;
+    m2 = 0.0;
+
+    min = 0.0;
+    max = 0.0;
+}
+
+// ------------------------------------------------------------------
+QuantileSketch::QuantileSketch():
+    count_(0),
+    zero_count_(0),
+
+    pos_offset_(0),
+    neg_offset_(0)
+{}
+
+int QuantileSketch::_key(double magnitude)
+{
+    int e;
+    double m = std::frexp(magnitude, &e);
+
+    return e * SUB_BUCKETS + (int) ((m - 0.5) * 2 * SUB_BUCKETS);
+}
+
+double QuantileSketch::_value(int key)
+{
+    int e = key / SUB_BUCKETS, sub = key % SUB_BUCKETS;
+    if (sub < 0) {
+        e--;
+        sub += SUB_BUCKETS;
     }
+
+    // Mid-point of the bucket:
+    return std::ldexp(0.5 + (sub + 0.5) / (2 * SUB_BUCKETS), e);
+}
+
+void QuantileSketch::_add(std::vector<long>& buckets, int& offset,
+                          int key, long n)
+{
+    if (buckets.empty()) {
+        offset = key;
+        buckets.assign(1, 0);
+
+    } else if (key < offset) {
+        buckets.insert(buckets.begin(), offset - key, 0);
+        offset = key;
+
+    } else if ((size_t) (key - offset) >= buckets.size())
+        buckets.resize(key - offset + 1, 0);
+
+    buckets[key - offset] += n;
+}
+
+void QuantileSketch::push(double x)
+{
+    if (not std::isfinite(x)) return;
+
+    count_++;
+
+    if (std::abs(x) < SKETCH_ZERO)
+        zero_count_++;
+    else if (x > 0.0)
+        _add(pos_, pos_offset_, _key(x), 1);
+    else
+        _add(neg_, neg_offset_, _key(-x), 1);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    count_ += other.count_;
+    zero_count_ += other.zero_count_;
+
+    for (size_t i = 0; i < other.pos_.size(); i++)
+        if (other.pos_[i] > 0)
+            _add(pos_, pos_offset_, other.pos_offset_ + (int) i, other.pos_[i]);
+
+    for (size_t i = 0; i < other.neg_.size(); i++)
+        if (other.neg_[i] > 0)
+            _add(neg_, neg_offset_, other.neg_offset_ + (int) i, other.neg_[i]);
+}
+
+long QuantileSketch::count() const
+{
+    return count_;
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    if (count_ == 0) return 0.0;
+
+    long rank = (long) (std::min(std::max(q, 0.0), 1.0) * (count_ - 1)),
+         seen = 0;
+
+    // Most negative values first, i.e. the largest negative magnitudes:
+    for (size_t i = neg_.size(); i-- > 0;) {
+        seen += neg_[i];
+        if (seen > rank)
+            return -_value(neg_offset_ + (int) i);
+    }
+
+    seen += zero_count_;
+    if (seen > rank) return 0.0;
+
+    for (size_t i = 0; i < pos_.size(); i++) {
+        seen += pos_[i];
+        if (seen > rank)
+            return _value(pos_offset_ + (int) i);
+    }
+
+    return pos_.empty() ? 0.0 : _value(pos_offset_ + (int) pos_.size() - 1);
+}
+
+void QuantileSketch::reset()
+{
+    count_ = 0;
+    zero_count_ = 0;
+
+    pos_offset_ = 0;
+    pos_.clear();
+
+    neg_offset_ = 0;
+    neg_.clear();
+}
+
+// ------------------------------------------------------------------
+void Distribution::merge(const Distribution& other)
+{
+    moments.merge(other.moments);
+    sketch.merge(other.sketch);
+}
+
+void Distribution::write(std::ostream& os, const std::string& section) const
+{
+    os << section << ",count," << moments.n << std::endl;
+    os << section << ",sum," << moments.sum() << std::endl;
+    os << section << ",mean," << moments.mean << std::endl;
+    os << section << ",stddev," << moments.stddev() << std::endl;
+    os << section << ",min," << moments.min << std::endl;
+
+    // Bucket mid-points can fall just outside the observed range:
+    for (double q : QUANTILES)
+        os << section << ",p" << (int) std::round(100 * q) << ","
+           << std::min(std::max(sketch.quantile(q), moments.min), moments.max)
+           << std::endl;
+
+    os << section << ",max," << moments.max << std::endl;
+}
+
+void Distribution::reset()
+{
+    moments.reset();
+    sketch.reset();
+}
+
+// ------------------------------------------------------------------
+void ExperimentStatistics::merge(const ExperimentStatistics& other)
+{
+    reward += other.reward;
+    pnl += other.pnl;
+    bandh += other.bandh;
+}
+
+void ExperimentStatistics::write(std::ostream& os) const
+{
+    os << "experiment,reward," << reward << std::endl;
+    os << "experiment,pnl," << pnl << std::endl;
+    os << "experiment,bandh," << bandh << std::endl;
 }
 
 void ExperimentStatistics::reset()
@@ -30,26 +229,29 @@ void ExperimentStatistics::reset()
     bandh = 0.0;
 }
 
-void TradeStatistics::write(std::string path)
+// ------------------------------------------------------------------
+void TradeStatistics::merge(const TradeStatistics& other)
 {
-    try {
-        std::ofstream ofs(path, std::ofstream::out);
-
-        ofs << "asks_placed," << asks_placed << std::endl;
-        ofs << "bids_placed," << bids_placed << std::endl;
-        ofs << "asks_cancelled," << asks_cancelled << std::endl;
-        ofs << "bids_cancelled," << bids_cancelled << std::endl;
-        ofs << "ask_transactions," << ask_transactions << std::endl;
-        ofs << "bid_transactions," << bid_transactions << std::endl;
-        ofs << "market_sells," << market_sells << std::endl;
-        ofs << "market_buys," << market_buys << std::endl;
-
-        ofs.close();
+    ask_transactions += other.ask_transactions;
+    bid_transactions += other.bid_transactions;
+    bids_placed += other.bids_placed;
+    asks_placed += other.asks_placed;
+    bids_cancelled += other.bids_cancelled;
+    asks_cancelled += other.asks_cancelled;
+    market_buys += other.market_buys;
+    market_sells += other.market_sells;
+}
 
-    } catch (std::runtime_error& e) {
-        std::cout << "Error writing trade stats to: " << path << std::endl;
-        std::cout << e.what() << std::endl;
-    }
+void TradeStatistics::write(std::ostream& os) const
+{
+    os << "trades,asks_placed," << asks_placed << std::endl;
+    os << "trades,bids_placed," << bids_placed << std::endl;
+    os << "trades,asks_cancelled," << asks_cancelled << std::endl;
+    os << "trades,bids_cancelled," << bids_cancelled << std::endl;
+    os << "trades,ask_transactions," << ask_transactions << std::endl;
+    os << "trades,bid_transactions," << bid_transactions << std::endl;
+    os << "trades,market_sells," << market_sells << std::endl;
+    os << "trades,market_buys," << market_buys << std::endl;
 }
 
 void TradeStatistics::reset()
@@ -64,31 +266,33 @@ void TradeStatistics::reset()
     market_sells = 0;
 }
 
-void TickStatistics::write(std::string path)
+// ------------------------------------------------------------------
+void TickStatistics::merge(const TickStatistics& other)
 {
-    try {
-        std::ofstream ofs(path, std::ofstream::out);
-
-        float ask_occ = 100*float(ticks_with_ask)/total_ticks;
-        float bid_occ = 100*float(ticks_with_bid)/total_ticks;
-        float both_occ = 100*float(ticks_with_both)/total_ticks;
-        float position_occ = 100 * float(ticks_with_position)/total_ticks;
-        float short_occ = 100 * float(ticks_short)/total_ticks;
-        float long_occ = 100 * float(ticks_long)/total_ticks;
-
-        ofs << "ask_occupancy," << ask_occ << "%" << std::endl;
-        ofs << "bid_occupancy," << bid_occ << "%" << std::endl;
-        ofs << "both_occupancy," << both_occ << "%" << std::endl;
-        ofs << "pos_occupancy," << position_occ << "%" << std::endl;
-        ofs << "short_occupancy," << short_occ << "%" << std::endl;
-        ofs << "long_occupancy," << long_occ << "%" << std::endl;
+    ticks_with_ask += other.ticks_with_ask;
+    ticks_with_no_ask += other.ticks_with_no_ask;
+    ticks_with_bid += other.ticks_with_bid;
+    ticks_with_no_bid += other.ticks_with_no_bid;
+    ticks_with_both += other.ticks_with_both;
+    ticks_without_both += other.ticks_without_both;
+    ticks_with_position += other.ticks_with_position;
+    ticks_with_no_position += other.ticks_with_no_position;
+    ticks_short += other.ticks_short;
+    ticks_long += other.ticks_long;
+    total_ticks += other.total_ticks;
+}
 
-        ofs.close();
+void TickStatistics::write(std::ostream& os) const
+{
+    float n = std::max(total_ticks, 1);
 
-    } catch (std::runtime_error& e) {
-        std::cout << "Error writing tick stats to: " << path << std::endl;
-        std::cout << e.what() << std::endl;
-    }
+    os << "ticks,total," << total_ticks << std::endl;
+    os << "ticks,ask_occupancy," << 100*ticks_with_ask/n << "%" << std::endl;
+    os << "ticks,bid_occupancy," << 100*ticks_with_bid/n << "%" << std::endl;
+    os << "ticks,both_occupancy," << 100*ticks_with_both/n << "%" << std::endl;
+    os << "ticks,pos_occupancy," << 100*ticks_with_position/n << "%" << std::endl;
+    os << "ticks,short_occupancy," << 100*ticks_short/n << "%" << std::endl;
+    os << "ticks,long_occupancy," << 100*ticks_long/n << "%" << std::endl;
 }
 
 void TickStatistics::reset()
@@ -105,3 +309,67 @@ void TickStatistics::reset()
     ticks_long = 0;
     total_ticks = 0;
 }
+
+// ------------------------------------------------------------------
+void StepStatistics::merge(const StepStatistics& other)
+{
+    pnl.merge(other.pnl);
+    inventory.merge(other.inventory);
+    spread_captured.merge(other.spread_captured);
+}
+
+void StepStatistics::write(std::ostream& os) const
+{
+    pnl.write(os, "step_pnl");
+    inventory.write(os, "inventory");
+    spread_captured.write(os, "spread_captured");
+}
+
+void StepStatistics::reset()
+{
+    pnl.reset();
+    inventory.reset();
+    spread_captured.reset();
+}
+
+// ------------------------------------------------------------------
+void Statistics::merge(const Statistics& other)
+{
+    episodes += other.episodes;
+
+    totals.merge(other.totals);
+    trades.merge(other.trades);
+    ticks.merge(other.ticks);
+    steps.merge(other.steps);
+}
+
+void Statistics::write(std::string path) const
+{
+    try {
+        std::ofstream ofs(path, std::ofstream::out);
+
+        ofs << "section,statistic,value" << std::endl;
+        ofs << "experiment,episodes," << episodes << std::endl;
+
+        totals.write(ofs);
+        trades.write(ofs);
+        ticks.write(ofs);
+        steps.write(ofs);
+
+        ofs.close();
+
+    } catch (std::runtime_error& e) {
+        std::cout << "Error writing stats to: " << path << std::endl;
+        std::cout << e.what() << std::endl;
+    }
+}
+
+void Statistics::reset()
+{
+    episodes = 0;
+
+    totals.reset();
+    trades.reset();
+    ticks.reset();
+    steps.reset();
+}
@@ -1,4 +1,5 @@
 #include "experiment/serial.h"
+#include "utilities/binlog.h"
 
 #include <iostream>
 #include <algorithm>
@@ -29,6 +30,7 @@ bool Runner::RunEpisode(rl::Agent *m)
     while (not is_terminal);
 
     environment.ClearInventory();
+    environment.commitStats();
 
     return true;
 }
@@ -47,6 +49,8 @@ Learner::Learner(Config &c, environment::Base& env):
 
             log->info("episode,episode_id,reward,pnl,n_steps,epsilon");
         } catch (spdlog::spdlog_ex& e) {}
+
+        training_logger = spdlog::get("training_log");
     }
 }
 
@@ -66,6 +70,9 @@ bool Learner::_step(rl::Agent *m)
 
     _step_counter++;
 
+    if (on_step_)
+        on_step_();
+
     return false;
 }
 
@@ -78,14 +85,14 @@ bool Learner::RunEpisode(rl::Agent *m)
     {
         m->HandleTerminal(_episode_counter++);
 
-        spdlog::get("training_log")
-            ->info("{},{},{},{},{},{}",
-                   _episode_counter,
-                   environment.getEpisodeId(),
-                   environment.getEpisodeReward(),
-                   environment.getEpisodePnL(),
-                   _step_counter,
-                   m->policy->descr());
+        if (training_logger != nullptr)
+            training_logger->info("{},{},{},{},{},{}",
+                                  _episode_counter,
+                                  environment.getEpisodeId(),
+                                  environment.getEpisodeReward(),
+                                  environment.getEpisodePnL(),
+                                  _step_counter,
+                                  m->policy->descr());
 
         return true;
     }
@@ -93,12 +100,41 @@ bool Learner::RunEpisode(rl::Agent *m)
     return false;
 }
 
+void Learner::OnStep(std::function<void()> hook)
+{
+    on_step_ = hook;
+}
+
 
 Backtester::Backtester(Config &c, environment::Base& env):
     Runner(c, env)
 {
     // Register loggers for environment:
     if (c["logging"] and c["logging"]["log_backtest"].as<bool>()) {
+        if (c["logging"]["binary"].as<bool>(false)) {
+            using binlog::Type;
+
+            binlog::Log::Register("profit_log",
+                                  c["output_dir"].as<string>() + "profit_log.bin",
+                                  {{"episode", Type::i32}, {"step", Type::i64},
+                                   {"action", Type::i32}, {"position", Type::i64},
+                                   {"midprice", Type::f64}, {"spread", Type::f64},
+                                   {"quoted_ask", Type::f64}, {"quoted_bid", Type::f64},
+                                   {"ask_level", Type::i32}, {"bid_level", Type::i32},
+                                   {"pnl_step", Type::f64}, {"bandh_step", Type::f64}});
+
+            binlog::Log::Register("trade_log",
+                                  c["output_dir"].as<string>() + "order_log.bin",
+                                  {{"episode", Type::i32}, {"step", Type::i64},
+                                   {"position", Type::i64}, {"side", Type::chr},
+                                   {"action", Type::chr}, {"price", Type::f64},
+                                   {"size", Type::i64}, {"pnl", Type::f64}});
+
+            env.start_logging();
+
+            return;
+        }
+
         try {
             spdlog::rotating_logger_mt("profit_log",
                                        c["output_dir"].as<string>() + "profit_log.csv",
@@ -130,8 +166,16 @@ bool Backtester::_step(rl::Agent *m)
 
     int action = m->action(*state);
 
+    if (on_decision_)
+        on_decision_();
+
     if (not environment.performAction(action))
         return true; // Action failed to execute (no data, etc)...
 
     return false;
 }
+
+void Backtester::OnDecision(std::function<void()> hook)
+{
+    on_decision_ = hook;
+}
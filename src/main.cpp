@@ -1,5 +1,6 @@
 #include <ctime>
 #include <mutex>
+#include <memory>
 #include <chrono>
 #include <vector>
 #include <string>
@@ -19,11 +20,19 @@
 #include "rl/agent.h"
 #include "rl/tiles.h"
 #include "data/basic.h"
+#include "data/itch.h"
+#include "data/live.h"
+#include "data/manifest.h"
+#include "data/reuters.h"
+#include "data/downsampled.h"
 #include "experiment/batch.h"
 #include "experiment/serial.h"
 #include "utilities/files.h"
+#include "utilities/binlog.h"
 #include "utilities/sampler.h"
+#include "utilities/turnstile.h"
 #include "environment/intraday.h"
+#include "environment/statistics.h"
 
 using namespace std;
 
@@ -34,38 +43,131 @@ typedef tuple<string, string, string> data_sample_t;
 vector<data_sample_t> train_set;
 vector<data_sample_t> test_set;
 
+// The same days by symbol, from which multi-day sessions are built:
+Sessions train_sessions;
+Sessions test_sessions;
+
 // Synchronisation variables for the training threads
 int n_threads;
 int n_train_episodes;
 int n_eval_episodes;
+int n_session_days;
+int n_coarse_episodes;
 
 int current_episode = 1;
 mutex episode_mutex;
 
-void train(int id, Config &c, rl::Agent* m)
+// Training statistics, merged from each thread's environment once it is done
+environment::Statistics train_stats;
+mutex stats_mutex;
+
+// Environment replaying the data in coarse time buckets, for pre-training:
+template<class T1, class T2>
+using CoarseIntraday = environment::Intraday<data::Downsampled<T1>,
+                                             data::Downsampled<T2>>;
+
+template<class E>
+void load_sample(E& env, const data_sample_t& ds, const Sessions& sessions)
+{
+    env.LoadData(get<0>(ds), get<1>(ds), get<2>(ds));
+
+    auto session = sessions.get(ds, n_session_days);
+    for (size_t d = 1; d < session.size(); d++)
+        env.QueueData(get<1>(session[d]), get<2>(session[d]));
+}
+
+std::unique_ptr<rl::Policy> make_policy(Config &c, unsigned seed)
 {
-    environment::Intraday<> env(c);
+    unsigned int n_actions = c["learning"]["n_actions"].as<unsigned int>();
+
+    string policy_type = c["policy"]["type"].as<string>("");
+    if (policy_type == "greedy")
+        return std::unique_ptr<rl::Policy>(new rl::Greedy(n_actions, seed));
+
+    else if (policy_type == "random")
+        return std::unique_ptr<rl::Policy>(new rl::Random(n_actions, seed));
+
+    else if (policy_type == "epsilon_greedy") {
+        float eps = c["policy"]["eps_init"].as<float>(),
+              eps_floor = c["policy"]["eps_floor"].as<float>();
+        unsigned int eps_T = c["policy"]["eps_T"].as<unsigned int>();
+
+        return std::unique_ptr<rl::Policy>(
+            new rl::EpsilonGreedy(n_actions, eps, eps_floor, eps_T, seed));
+
+    } else if (policy_type == "boltzmann") {
+        float tau = c["policy"]["tau_init"].as<float>(),
+              tau_floor = c["policy"]["tau_floor"].as<float>();
+        unsigned int tau_T = c["policy"]["tau_T"].as<unsigned int>();
+
+        return std::unique_ptr<rl::Policy>(
+            new rl::Boltzmann(n_actions, tau, tau_floor, tau_T, seed));
+
+    } else
+        throw runtime_error("Please specify a valid policy!");
+}
+
+// With a turnstile, the threads take their learning steps in turn:
+template<class T1, class T2>
+void train(int id, Config &c, rl::Agent* m, Turnstile* turnstile)
+{
+    environment::Intraday<T1, T2> env(c);
     experiment::serial::Learner experiment(c, env);
 
+    unique_ptr<CoarseIntraday<T1, T2>> coarse_env;
+    unique_ptr<experiment::serial::Learner> coarse_experiment;
+    if (n_coarse_episodes > 0) {
+        coarse_env.reset(new CoarseIntraday<T1, T2>(c));
+        coarse_env->SetResolution(c["data"]["downsample"]["ms"].as<long>());
+
+        coarse_experiment.reset(
+            new experiment::serial::Learner(c, *coarse_env));
+    }
+
+    // The days each thread draws are only repeatable when it takes turns:
+    unsigned seed = (turnstile == nullptr) ?
+        chrono::system_clock::now().time_since_epoch().count() :
+        c["debug"]["random_seed"].as<unsigned>(0) + id;
+
     data_sample_t ds;
-    RandomSampler<data_sample_t> rs(train_set);
+    RandomSampler<data_sample_t> rs(train_set, seed);
+
+    if (turnstile != nullptr) {
+        auto next = [turnstile, id]() { turnstile->Next(id); };
+
+        experiment.OnStep(next);
+        if (coarse_experiment != nullptr)
+            coarse_experiment->OnStep(next);
+
+        turnstile->Wait(id);
+    }
 
     while (true) {
         ds = rs.sample();
-        env.LoadData(get<0>(ds), get<1>(ds), get<2>(ds));
+
+        // Pre-train on the coarse replay, then switch to full resolution:
+        bool coarse = current_episode <= n_coarse_episodes;
+        if (coarse)
+            load_sample(*coarse_env, ds, train_sessions);
+        else
+            load_sample(env, ds, train_sessions);
+
+        environment::Base& e = coarse ? *coarse_env : (environment::Base&) env;
+        experiment::serial::Learner& ex = coarse ? *coarse_experiment : experiment;
 
         // Run episode:
-        if (experiment.RunEpisode(m)) {
+        if (ex.RunEpisode(m)) {
             cout << "[" << id << "]";
-            cout << " Trained on episode " << current_episode;
+            cout << " Trained" << (coarse ? " (coarse)" : "")
+                << " on episode " << current_episode;
 
-            cout << " (" << get<0>(ds) << " - " << env.getEpisodeId() << "):";
+            cout << " (" << get<0>(ds) << " - " << e.getEpisodeId() << "):";
 
-            cout << "\n\tRwd = " << env.getEpisodeReward() << endl;
-            cout << "\tRho = " << env.getMeanEpisodeReward() << endl;
-            cout << "\tPnl = " << env.getEpisodePnL() << endl;
-            cout << "\tnTr = " << env.getTotalTransactions() << endl;
-            cout << "\tPpt = " << env.getEpisodePnL()/env.getTotalTransactions() << endl;
+            cout << "\n\tRwd = " << e.getEpisodeReward() << endl;
+            cout << "\tRho = " << e.getMeanEpisodeReward() << endl;
+            cout << "\tPnl = " << e.getEpisodePnL() << endl;
+            cout << "\tnTr = " << e.getTotalTransactions() << endl;
+            cout << "\tPpt = " << e.getEpisodePnL()/e.getTotalTransactions() << endl;
             cout << endl;
 
             // Episode completed...
@@ -77,6 +179,305 @@ void train(int id, Config &c, rl::Agent* m)
                 break;
         }
     }
+
+    if (turnstile != nullptr)
+        turnstile->Leave(id);
+
+    stats_mutex.lock();
+    train_stats.merge(env.getStats());
+    if (coarse_env != nullptr)
+        train_stats.merge(coarse_env->getStats());
+    stats_mutex.unlock();
+}
+
+// Carries weights dumped with the hashed layout over to the action-major
+// layout of m: the training days are replayed greedily under the old weights,
+// and the weights of every state visited are copied (both sets of them for
+// double learners). Tiles that were never visited keep the agent's initial
+// weights:
+template<class T1, class T2>
+void migrate_theta(Config &c, rl::Agent* m, const string& path)
+{
+    Config lc(YAML::Clone(c));
+    lc["learning"]["weight_layout"] = "hashed";
+    lc["logging"]["log_learning"] = false;
+
+    unsigned int n_actions = c["learning"]["n_actions"].as<unsigned int>();
+    std::unique_ptr<rl::Policy> p(new rl::Greedy(n_actions));
+
+    string algorithm = c["learning"]["algorithm"].as<string>("");
+    std::unique_ptr<rl::Agent> legacy;
+    if (algorithm.compare(0, 7, "double_") == 0)
+        legacy.reset(new rl::DoubleQLearn(std::move(p), lc));
+    else
+        legacy.reset(new rl::QLearn(std::move(p), lc));
+
+    legacy->read_theta(path);
+
+    rl::State from(lc), to(c);
+    environment::Intraday<T1, T2> env(c);
+
+    long n_states = 0;
+    for (auto& ds : train_set) {
+        load_sample(env, ds, train_sessions);
+        if (not env.Initialise())
+            continue;
+
+        while (not env.isTerminal()) {
+            from.newState(env);
+            to.newState(env);
+
+            m->ImportWeights(to, *legacy, from);
+            n_states++;
+
+            if (not env.performAction(legacy->action(from)))
+                break;
+        }
+
+        env.ClearInventory();
+    }
+
+    cout << "[-] Migrated the weights of " << n_states << " states." << endl;
+}
+
+template<class T1, class T2>
+void run_phases(Config &c, rl::Agent* m, unsigned seed)
+{
+    // Start from saved weights, in this layout or migrated to it:
+    if (c["learning"]["load_theta"]) {
+        string path = c["learning"]["load_theta"].as<string>(),
+               layout = c["learning"]["weight_layout"].as<string>("hashed"),
+               from = c["learning"]["load_theta_layout"].as<string>(layout);
+
+        if (from == layout)
+            m->read_theta(path);
+        else if (from == "hashed" and layout == "action_major")
+            migrate_theta<T1, T2>(c, m, path);
+        else
+            throw runtime_error("Cannot migrate weights from " + from +
+                                " to " + layout + ".");
+    }
+
+    // Run training phases:
+    if (n_train_episodes > 0) {
+        n_threads = min(c["training"]["n_threads"].as<int>(1),
+                        n_train_episodes);
+
+        if (n_threads > 1) {
+            // Each thread learns with a fork of the agent, which updates its
+            // weights but keeps traces, a policy and random numbers apart:
+            vector<unique_ptr<rl::Agent>> forks;
+            for (int i = 0; i < n_threads; i++)
+                forks.push_back(m->Fork(make_policy(c, seed + i + 1),
+                                        seed + i + 1));
+
+            // For debugging, the threads can take their steps in turn so
+            // that runs (with a random_seed) are repeatable:
+            unique_ptr<Turnstile> turnstile;
+            if (c["training"]["deterministic"].as<bool>(false))
+                turnstile.reset(new Turnstile(n_threads));
+
+            // Setup threads:
+            vector<thread*> threads;
+            for (int i = 0; i < n_threads; i++)
+                threads.push_back(new thread(train<T1, T2>, i, ref(c),
+                                             forks[i].get(), turnstile.get()));
+
+            // Wait for threads to end
+            for (int i = 0; i < n_threads; i++) {
+                threads[i]->join();
+                delete threads[i];
+            }
+        } else {
+            train<T1, T2>(0, c, m, nullptr);
+        }
+
+        train_stats.write(c["output_dir"].as<string>() + "train_stats.csv");
+    }
+
+    if (c["learning"]["save_theta"])
+        m->write_theta(c["learning"]["save_theta"].as<string>());
+
+    // Reset counter:
+    current_episode = 0;
+    cout << endl;
+
+    // Run final testing phase:
+    m->GoGreedy();
+
+    environment::Intraday<T1, T2> env(c);
+    for (int i = 0; i < n_eval_episodes; i++) {
+        data_sample_t ds = test_set[i];
+
+        // Each test day is evaluated once, in sessions that don't overlap:
+        if (not test_sessions.opens(ds, n_session_days))
+            continue;
+
+        load_sample(env, ds, test_sessions);
+
+        experiment::serial::Backtester experiment(c, env);
+
+        current_episode++;
+
+        if (experiment.RunEpisode(m)) {
+            cout << "[0] \33[4mTested on episode " << current_episode
+                << " (" << get<0>(ds) << " - " << env.getEpisodeId() << "):\33[0m";
+
+            cout << "\n\tRwd = " << env.getEpisodeReward() << endl;
+            cout << "\tRho = " << env.getMeanEpisodeReward() << endl;
+            cout << "\tPnl = " << env.getEpisodePnL() << endl;
+            cout << "\tnTr = " << env.getTotalTransactions() << endl;
+            cout << "\tPpt = " << env.getEpisodePnL()/env.getTotalTransactions() << endl;
+            cout << endl;
+        }
+    }
+
+    // Output testing stats to a csv:
+    env.writeStats(c["output_dir"].as<string>() + "test_stats.csv");
+}
+
+// The days of the symbols in the data manifest, indexing those of symbols
+// it doesn't know yet (or all of them, if update is set):
+vector<data::ManifestEntry> load_manifest(Config &c, const vector<string>& symbols,
+                                          bool update = false)
+{
+    string path = c["data"]["manifest"].as<string>(),
+           format = c["data"]["format"].as<string>("basic");
+
+    data::Manifest manifest;
+    manifest.Load(path);
+
+    vector<string> pending;
+    for (auto& s : symbols)
+        if (update or not manifest.Contains(s))
+            pending.push_back(s);
+
+    if (not pending.empty()) {
+        long n = manifest.Update(c["data"]["md_dir"].as<string>(),
+                                 c["data"]["tas_dir"].as<string>(),
+                                 pending, format,
+                                 max(1u, thread::hardware_concurrency()));
+        manifest.Save(path);
+
+        cout << "[-] Indexed " << n << " new days in " << path << "." << endl;
+    }
+
+    return manifest.Select(symbols);
+}
+
+void run_live(Config &c, rl::Agent* m)
+{
+    string path = c["live"]["feed"].as<string>();
+    string symbol = c["data"]["symbols"].as<vector<string>>().at(0);
+
+    int n_episodes = c["live"]["episodes"].as<int>(1);
+
+    // Hold on to the connection, so that every episode reads on from where
+    // the last one stopped:
+    auto feed = data::live::Feed::Get(path);
+    feed->SetMaxLag(c["live"]["max_lag_ms"].as<long>(0));
+
+    // Time from the arrival of the latest frame to each decision:
+    environment::Distribution latency;
+
+    environment::Intraday<data::live::MarketDepth,
+                          data::live::TimeAndSales> env(c);
+
+    for (int i = 0; i < n_episodes; i++) {
+        env.LoadData(symbol, path, path);
+
+        experiment::serial::Backtester experiment(c, env);
+        experiment.OnDecision([&]() {
+            latency.push((data::live::steady_ns() - feed->LastArrival()) / 1000.0);
+        });
+
+        if (experiment.RunEpisode(m)) {
+            cout << "[0] \33[4mTraded live episode " << i + 1
+                << " (" << symbol << " - " << env.getEpisodeId() << "):\33[0m";
+
+            cout << "\n\tRwd = " << env.getEpisodeReward() << endl;
+            cout << "\tPnl = " << env.getEpisodePnL() << endl;
+            cout << "\tnTr = " << env.getTotalTransactions() << endl;
+            cout << endl;
+        }
+
+        // Nothing left to trade on:
+        if (not feed->Poll(false) and feed->Depth().empty())
+            break;
+    }
+
+    env.writeStats(c["output_dir"].as<string>() + "live_test_stats.csv");
+
+    ofstream ofs(c["output_dir"].as<string>() + "live_stats.csv");
+
+    ofs << "feed,frames," << feed->Frames() << endl;
+    ofs << "feed,conflated," << feed->Conflated() << endl;
+    latency.write(ofs, "latency_us");
+}
+
+template<class T1, class T2>
+void publish(Config &c, const string& path, double speed)
+{
+    string format = c["data"]["format"].as<string>("basic");
+    string symbol = c["data"]["symbols"].as<vector<string>>().at(0);
+
+    auto file_samples = get_file_sample(c["data"]["md_dir"].as<string>(),
+                                        c["data"]["tas_dir"].as<string>(),
+                                        vector<string> {symbol},
+                                        format == "itch" ? "itch" : "csv");
+    sort(file_samples.begin(), file_samples.end());
+
+    data::live::Publisher publisher(path);
+
+    for (auto& ds : file_samples) {
+        T1 md(get<1>(ds));
+        T2 tas(get<2>(ds));
+
+        bool tas_left = tas.LoadNext();
+        bool tas_pending = (tas.Record().date != 0);
+
+        // Pace the replay from the first update of each day:
+        long t0 = -1, w0 = data::live::steady_ns();
+
+        bool md_left;
+        do {
+            md_left = md.LoadNext();
+
+            auto& rec = md.Record();
+            if (rec.date == 0)
+                break;
+
+            if (t0 < 0)
+                t0 = rec.time;
+            else if (speed > 0.0)
+                this_thread::sleep_for(chrono::nanoseconds(
+                    w0 + (long) ((rec.time - t0) / speed) -
+                    data::live::steady_ns()));
+
+            // Trades go out before the update at the same time:
+            while (tas_pending and tas.Record().time <= rec.time) {
+                publisher.Send(tas.Record());
+
+                tas_pending = tas_left;
+                if (tas_left)
+                    tas_left = tas.LoadNext();
+            }
+
+            publisher.Send(rec);
+        } while (md_left);
+
+        while (tas_pending) {
+            publisher.Send(tas.Record());
+
+            tas_pending = tas_left;
+            if (tas_left)
+                tas_left = tas.LoadNext();
+        }
+
+        cout << "[-] Published " << get<1>(ds) << endl;
+    }
+
+    publisher.End();
 }
 
 void run(Config &c) {
@@ -90,12 +491,34 @@ void run(Config &c) {
     bool eval_from_train = c["evaluation"]["use_train_sample"].as<bool>(false);
     n_train_episodes = c["training"]["n_episodes"].as<int>();
     n_eval_episodes = c["evaluation"]["n_samples"].as<int>(-1);
+    n_session_days = c["data"]["session_days"].as<int>(1);
+
+    // Pre-training on the coarse replay is followed by fine-tuning at full
+    // resolution, so how long it lasts must be given:
+    n_coarse_episodes = 0;
+    if (c["data"]["downsample"]["ms"].as<long>(0) > 0) {
+        if (not c["data"]["downsample"]["n_episodes"])
+            throw runtime_error("Please specify data.downsample.n_episodes!");
+
+        n_coarse_episodes = c["data"]["downsample"]["n_episodes"].as<int>();
+    }
 
     // Partition the data
+    string format = c["data"]["format"].as<string>("basic");
+
     auto symbols = c["data"]["symbols"].as<vector<string>>();
-    auto file_samples = get_file_sample(c["data"]["md_dir"].as<string>(),
-                                        c["data"]["tas_dir"].as<string>(),
-                                        symbols);
+
+    vector<data::ManifestEntry> days;
+    vector<data_sample_t> file_samples;
+    if (c["data"]["manifest"]) {
+        days = load_manifest(c, symbols);
+        file_samples = data::to_samples(days);
+
+    } else
+        file_samples = get_file_sample(c["data"]["md_dir"].as<string>(),
+                                       c["data"]["tas_dir"].as<string>(),
+                                       symbols,
+                                       format == "itch" ? "itch" : "csv");
 
     int n_train_samples = c["training"]["n_samples"].as<int>(-1);
 
@@ -109,13 +532,26 @@ void run(Config &c) {
     } else {
         if (n_eval_episodes == -1) n_eval_episodes = file_samples.size();
 
-        int pivot = file_samples.size() - n_eval_episodes;
+        if (c["evaluation"]["balance"].as<bool>(false)) {
+            if (not c["data"]["manifest"])
+                throw runtime_error("Balanced splits need a data manifest.");
 
-        train_set.resize(pivot);
-        test_set.resize(n_eval_episodes);
+            // Test on the latest days of every symbol, by row count:
+            vector<data::ManifestEntry> train_days, test_days;
+            data::split_balanced(days, n_eval_episodes, train_days, test_days);
 
-        copy(file_samples.begin(), file_samples.begin() + pivot, train_set.begin());
-        copy(file_samples.begin() + pivot, file_samples.end(), test_set.begin());
+            train_set = data::to_samples(train_days);
+            test_set = data::to_samples(test_days);
+
+        } else {
+            int pivot = file_samples.size() - n_eval_episodes;
+
+            train_set.resize(pivot);
+            test_set.resize(n_eval_episodes);
+
+            copy(file_samples.begin(), file_samples.begin() + pivot, train_set.begin());
+            copy(file_samples.begin() + pivot, file_samples.end(), test_set.begin());
+        }
     }
 
     if (n_train_samples < 0) n_train_samples = train_set.size();
@@ -130,39 +566,19 @@ void run(Config &c) {
         copy(train_set.begin(), train_set.end(), test_set.begin());
     }
 
+    // Test sessions only span the days evaluated, so that none is repeated:
+    size_t n_eval_days = min(test_set.size(), (size_t) max(n_eval_episodes, 0));
+
+    train_sessions = Sessions(train_set);
+    test_sessions = Sessions(vector<data_sample_t>(
+        test_set.begin(), test_set.begin() + n_eval_days));
+
     cout << "[-] Training on " << n_train_episodes << " episodes." << endl;
     cout << "[-] Testing on " << n_eval_episodes << " episodes." << endl;
     cout << endl;
 
     // Set up policy:
-    unsigned int n_actions = c["learning"]["n_actions"].as<unsigned int>();
-
-    std::unique_ptr<rl::Policy> p;
-    string policy_type = c["policy"]["type"].as<string>("");
-    if (policy_type == "greedy")
-        p = std::unique_ptr<rl::Policy>(new rl::Greedy(n_actions, seed));
-
-    else if (policy_type == "random")
-        p = std::unique_ptr<rl::Policy>(new rl::Random(n_actions, seed));
-
-    else if (policy_type == "epsilon_greedy") {
-        float eps = c["policy"]["eps_init"].as<float>(),
-              eps_floor = c["policy"]["eps_floor"].as<float>();
-        unsigned int eps_T = c["policy"]["eps_T"].as<unsigned int>();
-
-        p = std::unique_ptr<rl::Policy>(
-            new rl::EpsilonGreedy(n_actions, eps, eps_floor, eps_T, seed));
-
-    } else if (policy_type == "boltzmann") {
-        float tau = c["policy"]["tau_init"].as<float>(),
-              tau_floor = c["policy"]["tau_floor"].as<float>();
-        unsigned int tau_T = c["policy"]["tau_T"].as<unsigned int>();
-
-        p = std::unique_ptr<rl::Policy>(
-            new rl::Boltzmann(n_actions, tau, tau_floor, tau_T, seed));
-
-    } else
-        throw runtime_error("Please specify a valid policy!");
+    std::unique_ptr<rl::Policy> p = make_policy(c, seed);
 
     // Set up the agent
     rl::Agent *m;
@@ -188,58 +604,22 @@ void run(Config &c) {
     else
         throw runtime_error("Please specify a valid learning algorithm!");
 
-    // Run training phases:
-    if (n_train_episodes > 0) {
-        n_threads = min(c["training"]["n_threads"].as<int>(1),
-                        n_train_episodes);
+    // Run training and testing on the configured data format:
+    if (format == "basic")
+        run_phases<data::basic::MarketDepth, data::basic::TimeAndSales>(c, m, seed);
 
-        if (n_threads > 1) {
-            // Setup threads:
-            vector<thread*> threads;
-            for (int i = 0; i < n_threads; i++)
-                threads.push_back(new thread(train, i, ref(c), m));
+    else if (format == "reuters")
+        run_phases<data::reuters::MarketDepth, data::reuters::TimeAndSales>(c, m, seed);
 
-            // Wait for threads to end
-            for (int i = 0; i < n_threads; i++) {
-                threads[i]->join();
-                delete threads[i];
-            }
-        } else {
-            train(0, c, m);
-        }
-    }
-
-    // Reset counter:
-    current_episode = 0;
-    cout << endl;
-
-    // Run final testing phase:
-    m->GoGreedy();
-
-    environment::Intraday<> env(c);
-    for (int i = 0; i < n_eval_episodes; i++) {
-        data_sample_t ds = test_set[i];
-        env.LoadData(get<0>(ds), get<1>(ds), get<2>(ds));
-
-        experiment::serial::Backtester experiment(c, env);
-
-        current_episode++;
-
-        if (experiment.RunEpisode(m)) {
-            cout << "[0] \33[4mTested on episode " << current_episode
-                << " (" << get<0>(ds) << " - " << env.getEpisodeId() << "):\33[0m";
+    else if (format == "itch")
+        run_phases<data::itch::MarketDepth, data::itch::TimeAndSales>(c, m, seed);
 
-            cout << "\n\tRwd = " << env.getEpisodeReward() << endl;
-            cout << "\tRho = " << env.getMeanEpisodeReward() << endl;
-            cout << "\tPnl = " << env.getEpisodePnL() << endl;
-            cout << "\tnTr = " << env.getTotalTransactions() << endl;
-            cout << "\tPpt = " << env.getEpisodePnL()/env.getTotalTransactions() << endl;
-            cout << endl;
-        }
-    }
+    else
+        throw runtime_error("Unknown data format: " + format);
 
-    // Output testing stats to a csv:
-    env.writeStats(c["output_dir"].as<string>() + "test_stats.csv");
+    // Then paper trade on a live feed:
+    if (c["live"]["feed"])
+        run_live(c, m);
 
     delete m;
 }
@@ -268,6 +648,20 @@ int main(int argc, char** argv)
             ("quiet",
              po::bool_switch()->default_value(false),
              "Disable episode logging to cout")
+            ("export", po::value<string>(),
+             "Convert a binary log (.bin) to csv and exit")
+            ("compact", po::value<string>(),
+             "Write a no-op compacted copy of a market depth file to the "
+             "output directory and exit")
+            ("index",
+             po::bool_switch()->default_value(false),
+             "Rebuild the data manifest (data.manifest) of the configured "
+             "symbols and exit")
+            ("publish", po::value<string>(),
+             "Replay the configured data to a live feed (a socket or FIFO "
+             "path) and exit")
+            ("speed", po::value<double>()->default_value(1.0),
+             "Replay speed when publishing (0: as fast as possible)")
             ("help,h", "Display help message");
 
         po::variables_map vm;
@@ -312,6 +706,29 @@ int main(int argc, char** argv)
                 return 0;
             }
 
+            if (vm.count("export")) {
+                string bin_path = vm["export"].as<string>();
+                string csv_path = bin_path.substr(0, bin_path.rfind(".bin")) + ".csv";
+
+                binlog::ExportCSV(bin_path, csv_path);
+                cout << csv_path << endl;
+
+                return 0;
+            }
+
+            if (vm.count("compact")) {
+                string md_path = vm["compact"].as<string>();
+                string out_path = output_dir + (output_dir.back() == '/' ? "" : "/") +
+                    md_path.substr(md_path.rfind('/') + 1);
+
+                boost::filesystem::create_directories(output_dir);
+
+                long n = data::basic::CompactCSV(md_path, out_path);
+                cout << out_path << " (" << n << " rows)" << endl;
+
+                return 0;
+            }
+
             po::notify(vm);
         } catch (po::error& e) {
             cerr << "ERROR: " << e.what() << endl << endl;
@@ -346,6 +763,40 @@ int main(int argc, char** argv)
 
         if (vm["debug"].as<bool>()) config["debug"]["inspect_books"] = true;
 
+        if (vm["index"].as<bool>()) {
+            if (not config["data"]["manifest"])
+                throw runtime_error("No data manifest configured.");
+
+            auto days = load_manifest(
+                config, config["data"]["symbols"].as<vector<string>>(), true);
+            cout << "[-] " << days.size() << " days indexed." << endl;
+
+            return 0;
+        }
+
+        if (vm.count("publish")) {
+            string path = vm["publish"].as<string>(),
+                   format = config["data"]["format"].as<string>("basic");
+            double speed = vm["speed"].as<double>();
+
+            if (format == "basic")
+                publish<data::basic::MarketDepth,
+                        data::basic::TimeAndSales>(config, path, speed);
+
+            else if (format == "reuters")
+                publish<data::reuters::MarketDepth,
+                        data::reuters::TimeAndSales>(config, path, speed);
+
+            else if (format == "itch")
+                publish<data::itch::MarketDepth,
+                        data::itch::TimeAndSales>(config, path, speed);
+
+            else
+                throw runtime_error("Unknown data format: " + format);
+
+            return 0;
+        }
+
         bool quiet = vm["quiet"].as<bool>();
 
         if (quiet) {
@@ -359,6 +810,9 @@ int main(int argc, char** argv)
         } else
             run(config);
 
+        // Make sure all binary logs hit the disk:
+        binlog::Log::DropAll();
+
         cout << output_dir << endl;
 
     } catch (exception& e) {
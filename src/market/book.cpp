@@ -2,6 +2,7 @@
 
 #include "market/measures.h"
 #include "utilities/memory.h"
+#include "utilities/serialise.h"
 #include "utilities/comparison.h"
 
 #include <tuple>
@@ -98,6 +99,35 @@ void Book<C, DEPTH>::ApplyChanges(
     }
 }
 
+template<typename C, size_t DEPTH>
+bool Book<C, DEPTH>::HoldState(
+    const std::array<double, DEPTH>& new_prices,
+    const std::array<long, DEPTH>& new_volumes)
+{
+    if (last_levels.size() != DEPTH)
+        return false;
+
+    // Keys must match exactly, not just within the comparator's tolerance:
+    for (unsigned int l = 0; l < DEPTH; l++) {
+        auto it = last_levels.find(new_prices[l]);
+
+        if (it == last_levels.end() or it->first != new_prices[l] or
+            it->second != new_volumes[l])
+            return false;
+    }
+
+    prices = last_prices;
+    levels = last_levels;
+
+    last_total_volume_ = total_volume_;
+    for (unsigned int l = 0; l < DEPTH; l++)
+        total_volume_ += new_volumes[l];
+
+    // Queues only move with the volume at their price, which is unchanged,
+    // so there is nothing to update for the open orders.
+    return true;
+}
+
 template<typename C, size_t DEPTH>
 typename Book<C, DEPTH>::OMI Book<C, DEPTH>::UpdateOrder(Book<C, DEPTH>::OMI it,
                                                          long transaction_volume)
@@ -159,6 +189,38 @@ void Book<C, DEPTH>::Reset()
     open_orders.clear();
 }
 
+template<typename C, size_t DEPTH>
+void Book<C, DEPTH>::SaveState(std::ostream& os)
+{
+    serialise::write(os, prices);
+    serialise::write(os, last_prices);
+
+    serialise::write(os, levels);
+    serialise::write(os, last_levels);
+
+    serialise::write(os, total_volume_);
+    serialise::write(os, last_total_volume_);
+
+    serialise::write(os, observed_transaction_value_);
+    serialise::write(os, observed_transaction_volume_);
+}
+
+template<typename C, size_t DEPTH>
+void Book<C, DEPTH>::LoadState(std::istream& is)
+{
+    serialise::read(is, prices);
+    serialise::read(is, last_prices);
+
+    serialise::read(is, levels);
+    serialise::read(is, last_levels);
+
+    serialise::read(is, total_volume_);
+    serialise::read(is, last_total_volume_);
+
+    serialise::read(is, observed_transaction_value_);
+    serialise::read(is, observed_transaction_volume_);
+}
+
 template<typename C, size_t DEPTH>
 int Book<C, DEPTH>::depth() { return DEPTH; }
 
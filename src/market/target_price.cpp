@@ -1,10 +1,25 @@
 #include "market/book.h"
 #include "market/measures.h"
 #include "market/target_price.h"
+#include "utilities/serialise.h"
 
 using namespace market::tp;
 
 
+Observation Observation::from(market::AskBook<>& ab, market::BidBook<>& bb)
+{
+    Observation obs;
+
+    obs.midprice = market::measure::midprice(ab, bb);
+    obs.microprice = market::measure::microprice(ab, bb);
+
+    obs.value = ab.observed_value() + bb.observed_value();
+    obs.volume = ab.observed_volume() + bb.observed_volume();
+
+    return obs;
+}
+
+
 TargetPrice::TargetPrice():
     val_(-1.0)
 {}
@@ -19,10 +34,19 @@ bool TargetPrice::ready()
     return val_ > 0.0;
 }
 
-void TargetPrice::update(market::AskBook<>&, market::BidBook<>&) {}
+void TargetPrice::update(market::AskBook<>& ab, market::BidBook<>& bb)
+{
+    update(Observation::from(ab, bb));
+}
+
+void TargetPrice::update(const Observation&) {}
 
 void TargetPrice::clear() {}
 
+void TargetPrice::save(std::ostream& os) { serialise::write(os, val_); }
+
+void TargetPrice::load(std::istream& is) { serialise::read(is, val_); }
+
 
 MidPrice::MidPrice(int lookback):
     TargetPrice(),
@@ -35,15 +59,27 @@ bool MidPrice::ready()
     return mp_.full();
 }
 
-void MidPrice::update(market::AskBook<>& ab, market::BidBook<>& bb)
+void MidPrice::update(const Observation& obs)
 {
-    mp_.push(market::measure::midprice(ab, bb));
+    mp_.push(obs.midprice);
 
     val_ = mp_.mean();
 }
 
 void MidPrice::clear() { mp_.clear(); }
 
+void MidPrice::save(std::ostream& os)
+{
+    TargetPrice::save(os);
+    mp_.save(os);
+}
+
+void MidPrice::load(std::istream& is)
+{
+    TargetPrice::load(is);
+    mp_.load(is);
+}
+
 
 MicroPrice::MicroPrice(int lookback):
     TargetPrice(),
@@ -56,15 +92,27 @@ bool MicroPrice::ready()
     return mp_.full();
 }
 
-void MicroPrice::update(market::AskBook<>& ab, market::BidBook<>& bb)
+void MicroPrice::update(const Observation& obs)
 {
-    mp_.push(market::measure::microprice(ab, bb));
+    mp_.push(obs.microprice);
 
     val_ = mp_.mean();
 }
 
 void MicroPrice::clear() { mp_.clear(); }
 
+void MicroPrice::save(std::ostream& os)
+{
+    TargetPrice::save(os);
+    mp_.save(os);
+}
+
+void MicroPrice::load(std::istream& is)
+{
+    TargetPrice::load(is);
+    mp_.load(is);
+}
+
 
 VWAP::VWAP(int lookback):
     TargetPrice(),
@@ -78,10 +126,10 @@ bool VWAP::ready()
     return numerator_.full() and denominator_.full();
 }
 
-void VWAP::update(market::AskBook<>& ab, market::BidBook<>& bb)
+void VWAP::update(const Observation& obs)
 {
-    numerator_.push(ab.observed_value() + bb.observed_value());
-    denominator_.push(ab.observed_volume() + bb.observed_volume());
+    numerator_.push(obs.value);
+    denominator_.push(obs.volume);
 
     val_ = numerator_.sum() / denominator_.sum();
 }
@@ -92,3 +140,18 @@ void VWAP::clear()
     denominator_.clear();
 }
 
+void VWAP::save(std::ostream& os)
+{
+    TargetPrice::save(os);
+
+    numerator_.save(os);
+    denominator_.save(os);
+}
+
+void VWAP::load(std::istream& is)
+{
+    TargetPrice::load(is);
+
+    numerator_.load(is);
+    denominator_.load(is);
+}
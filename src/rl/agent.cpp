@@ -1,23 +1,279 @@
 #include "rl/agent.h"
 
 #include <cmath>
+#include <atomic>
 #include <memory>
 #include <float.h>
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 #include <spdlog/spdlog.h>
 
 using namespace std;
 using namespace rl;
 
-Agent::Agent(std::unique_ptr<Policy> policy, Config &c):
+// A set of weights as the kernels below see it: theta[i] is the weight of
+// feature i.
+template<class T>
+struct Dense
+{
+    const T* w;
+    long stride;
+
+    double operator[](int i) const
+    {
+        return (double) load_relaxed(&w[stride*i]);
+    }
+    void prefetch(int i) const { __builtin_prefetch(&w[stride*i]); }
+};
+
+struct Sparse
+{
+    const SparseWeights* w;
+    int set;
+
+    double operator[](int i) const { return w->get(set, i); }
+    void prefetch(int i) const { w->prefetch(i); }
+};
+
+// Q of one action from its features, summed term by term in the order that
+// getQ always has (the third group's sum starts from the second's features):
+template<class V>
+static inline double q_sum(const V& theta, const int* f, int n_tilings,
+                           const tuple<double, double, double>& gw)
+{
+    double Q = 0.0;
+
+    double w = get<0>(gw);
+    for (int i = 0; i < n_tilings; i++)
+        Q += w*theta[f[i]];
+
+    w = get<1>(gw);
+    for (int i = n_tilings; i < 2*n_tilings; i++)
+        Q += w*theta[f[i]];
+
+    w = get<2>(gw);
+    for (int i = n_tilings; i < 3*n_tilings; i++)
+        Q += w*theta[f[i]];
+
+    return Q;
+}
+
+template<class V>
+static inline void prefetch(const V& theta, const int* f, int n)
+{
+    for (int i = 0; i < n; i++)
+        theta.prefetch(f[i]);
+}
+
+// Q of every action from the flat feature block of a state, for one or two
+// sets of weights (qb and theta_b may be null). The weights of the next action
+// are fetched while those of the current one are summed; those of theta_b
+// only if they do not share their lines with theta's:
+template<class V>
+static void q_all(const State& s, int n_actions, int n_tilings,
+                  const tuple<double, double, double>& gw,
+                  const V& theta, const V* theta_b, bool fetch_b,
+                  double q[], double qb[])
+{
+    const int n = 3*n_tilings;
+    fetch_b = fetch_b and theta_b != nullptr;
+
+    prefetch(theta, s.getFeatures(0), n);
+    if (fetch_b) prefetch(*theta_b, s.getFeatures(0), n);
+
+    for (int a = 0; a < n_actions; a++) {
+        const int* f = s.getFeatures(a);
+
+        if (a+1 < n_actions) {
+            prefetch(theta, f + n, n);
+            if (fetch_b) prefetch(*theta_b, f + n, n);
+        }
+
+        q[a] = q_sum(theta, f, n_tilings, gw);
+        if (theta_b != nullptr)
+            qb[a] = q_sum(*theta_b, f, n_tilings, gw);
+    }
+}
+
+// How far ahead of the sweep below weights are fetched:
+static const int PREFETCH_DISTANCE = 16;
+
+// Adds scale times the trace of every traced feature to its weight in a set.
+// The traces are swept in order from their arrays, fetching the weights
+// ahead. Each weight is rounded once; with compensation, the rounding error
+// is kept and added back in the next update:
+template<class T>
+static void add_traced(Weights& w, int set, Traces& traces, double scale)
+{
+    T* theta = w.data<T>(set);
+    T* residuals = w.residuals<T>(set);
+    const long stride = w.stride();
+
+    traces.prune();
+
+    const int n = traces.size();
+    const int* f = traces.getFeatures();
+    const double* e = traces.getValues();
+
+    scale *= traces.getScale();
+
+    for (int k = 0; k < n; k++) {
+        if (k + PREFETCH_DISTANCE < n)
+            __builtin_prefetch(&theta[stride * f[k + PREFETCH_DISTANCE]]);
+
+        long i = stride * f[k];
+        double v = (double) load_relaxed(&theta[i]) + scale * e[k];
+
+        if (residuals == nullptr)
+            store_relaxed(&theta[i], (T) v);
+        else {
+            v += (double) load_relaxed(&residuals[i]);
+
+            T rounded = (T) v;
+            store_relaxed(&theta[i], rounded);
+            store_relaxed(&residuals[i], (T) (v - (double) rounded));
+        }
+    }
+}
+
+// The kernels above on the weights as they are stored (set_b < 0 for none):
+template<class T>
+static Dense<T> dense(const Weights& w, int set)
+{
+    return {w.data<T>(set), w.stride()};
+}
+
+template<class T>
+static void q_all(const State& s, int n_actions, int n_tilings,
+                  const tuple<double, double, double>& gw, const Weights& w,
+                  int set_a, int set_b, double q[], double qb[])
+{
+    Dense<T> a = dense<T>(w, set_a), b = dense<T>(w, max(set_b, 0));
+
+    q_all(s, n_actions, n_tilings, gw, a, set_b < 0 ? nullptr : &b,
+          w.stride() == 1, q, qb);
+}
+
+static double q_sum(const Weights& w, int set, const int* f, int n_tilings,
+                    const tuple<double, double, double>& gw)
+{
+    if (w.sparse() != nullptr)
+        return q_sum(Sparse{w.sparse(), set}, f, n_tilings, gw);
+
+    switch (w.type()) {
+        case Weights::Type::FLOAT:
+            return q_sum(dense<float>(w, set), f, n_tilings, gw);
+        case Weights::Type::BF16:
+            return q_sum(dense<bf16>(w, set), f, n_tilings, gw);
+        default:
+            return q_sum(dense<double>(w, set), f, n_tilings, gw);
+    }
+}
+
+static void q_all(const State& s, int n_actions, int n_tilings,
+                  const tuple<double, double, double>& gw, const Weights& w,
+                  int set_a, int set_b, double q[], double qb[])
+{
+    if (w.sparse() != nullptr) {
+        // Both sets of a tile are in its slot:
+        Sparse a{w.sparse(), set_a}, b{w.sparse(), set_b};
+
+        return q_all(s, n_actions, n_tilings, gw, a,
+                     set_b < 0 ? nullptr : &b, false, q, qb);
+    }
+
+    switch (w.type()) {
+        case Weights::Type::FLOAT:
+            return q_all<float>(s, n_actions, n_tilings, gw, w,
+                                set_a, set_b, q, qb);
+        case Weights::Type::BF16:
+            return q_all<bf16>(s, n_actions, n_tilings, gw, w,
+                               set_a, set_b, q, qb);
+        default:
+            return q_all<double>(s, n_actions, n_tilings, gw, w,
+                                 set_a, set_b, q, qb);
+    }
+}
+
+static void add_traced(Weights& w, int set, Traces& traces, double scale)
+{
+    if (w.sparse() != nullptr) {
+        traces.prune();
+
+        const int* f = traces.getFeatures();
+        const double* e = traces.getValues();
+
+        scale *= traces.getScale();
+        for (int k = 0; k < traces.size(); k++)
+            w.sparse()->add(set, f[k], scale * e[k]);
+
+        return;
+    }
+
+    switch (w.type()) {
+        case Weights::Type::FLOAT:
+            return add_traced<float>(w, set, traces, scale);
+        case Weights::Type::BF16:
+            return add_traced<bf16>(w, set, traces, scale);
+        default:
+            return add_traced<double>(w, set, traces, scale);
+    }
+}
+
+// Versions of weights, unique across agents so that a state can tell whose
+// Q it holds:
+static unsigned long next_version()
+{
+    static std::atomic<unsigned long> last{0};
+
+    return ++last;
+}
+
+// The greedy action, breaking ties at random from the agent's own generator,
+// so that forks stay reproducible from their seeds:
+static int argmax(const double q[], int n_actions, mt19937_64& gen)
+{
+    int index = 0;
+    int n_ties = 1;
+    double currMaxQ = q[index];
+
+    for (int a = 1; a < n_actions; a++) {
+        double val = q[a];
+
+        if (val >= currMaxQ) {
+            if (val > currMaxQ) {
+                currMaxQ = val;
+                index = a;
+            } else {
+                n_ties++;
+
+                if (0 == gen() % n_ties) {
+                    currMaxQ = val;
+                    index = a;
+                }
+            }
+        }
+    }
+
+    return index;
+}
+
+Agent::Agent(std::unique_ptr<Policy> policy, Config &c, int n_sets):
     MEMORY_SIZE(c["learning"]["memory_size"].as<long>()),
     N_TILINGS(c["learning"]["n_tilings"].as<int>()),
     N_ACTIONS(c["learning"]["n_actions"].as<int>()),
 
+    weights(new Weights(
+        Weights::parse(c["learning"]["weight_type"].as<string>("double")),
+        MEMORY_SIZE, n_sets,
+        c["learning"]["interleave_weights"].as<bool>(false),
+        c["learning"]["compensated_updates"].as<bool>(false),
+        c["learning"]["weight_store"].as<string>("dense") == "sparse")),
+
     group_weights(make_tuple(1.0/3, 1.0/3, 1.0/3)),
 
-    traces(MEMORY_SIZE, N_TILINGS, N_ACTIONS),
+    traces(N_TILINGS, N_ACTIONS),
 
     alpha_start(c["learning"]["alpha_start"].as<double>(0.2)),
     alpha_floor(c["learning"]["alpha_floor"].as<double>(0.001)),
@@ -30,15 +286,12 @@ Agent::Agent(std::unique_ptr<Policy> policy, Config &c):
     gen(c["debug"]["random_seed"].as<unsigned>(random_device{}())),
     unif_dist(0.0, 1.0),
 
+    qs(N_ACTIONS, 0.0),
+    version(next_version()),
+
     policy(std::move(policy))
 {
-    theta = new double[MEMORY_SIZE];
-
-    if (c["learning"]["random_init"].as<bool>(false))
-        generate(&theta[0], &theta[MEMORY_SIZE],
-                 [this]() { return 2.0*unif_dist(gen)-1.0; });
-    else
-        fill(&theta[0], &theta[MEMORY_SIZE], 0.0);
+    weights->initialise(0, c["learning"]["random_init"].as<bool>(false), gen);
 
     if (c["learning"]["group_weights"]) {
         get<0>(group_weights) = c["learning"]["group_weights"][0].as<double>();
@@ -51,28 +304,85 @@ Agent::Agent(std::unique_ptr<Policy> policy, Config &c):
 
     // Register loggers for TD-error:
     if (c["logging"] and c["logging"]["log_learning"].as<bool>(true)) {
-        try {
-            auto log = spdlog::rotating_logger_mt("model_log",
-                                                  c["output_dir"].as<string>() + "model_log.csv",
-                                                  c["logging"]["max_size"].as<size_t>(), 1);
-        } catch (spdlog::spdlog_ex& e) {}
+        if (c["logging"]["binary"].as<bool>(false))
+            model_binlog = binlog::Log::Register(
+                "model_log", c["output_dir"].as<string>() + "model_log.bin",
+                {{"td_error", binlog::Type::f64}});
+
+        else {
+            try {
+                auto log = spdlog::rotating_logger_mt("model_log",
+                                                      c["output_dir"].as<string>() + "model_log.csv",
+                                                      c["logging"]["max_size"].as<size_t>(), 1);
+            } catch (spdlog::spdlog_ex& e) {}
+
+            model_logger = spdlog::get("model_log");
+        }
     }
 }
 
-Agent::~Agent()
+Agent::Agent(const Agent& other):
+    MEMORY_SIZE(other.MEMORY_SIZE),
+    N_TILINGS(other.N_TILINGS),
+    N_ACTIONS(other.N_ACTIONS),
+
+    weights(other.weights),
+    group_weights(other.group_weights),
+
+    traces(N_TILINGS, N_ACTIONS),
+
+    alpha_start(other.alpha_start),
+    alpha_floor(other.alpha_floor),
+    omega(other.omega),
+    alpha(other.alpha),
+
+    gamma(other.gamma),
+    lambda(other.lambda),
+
+    gen(other.gen),
+    unif_dist(other.unif_dist),
+
+    model_logger(other.model_logger),
+    model_binlog(other.model_binlog),
+
+    qs(N_ACTIONS, 0.0),
+    version(next_version())
+{}
+
+std::unique_ptr<Agent> Agent::Fork(std::unique_ptr<Policy> policy,
+                                   unsigned seed) const
 {
-    delete [] theta;
+    if (weights->sparse() != nullptr)
+        throw runtime_error("[Agent] Sparse weights cannot be shared "
+                            "between threads.");
+
+    std::unique_ptr<Agent> fork(Clone());
+    fork->policy = std::move(policy);
+    fork->gen.seed(seed);
+
+    return fork;
 }
 
 unsigned int Agent::action(State& s)
 {
-    std::vector<double> qs(N_ACTIONS, 0.0);
-    for (int a = 0; a < N_ACTIONS; a++)
-        qs[a] = getQ(s, a);
+    int chosen = s.takeChosenAction();
+    if (chosen >= 0)
+        return chosen;
+
+    const double* q = allQ(s);
+    copy(q, q + N_ACTIONS, qs.begin());
 
     return policy->Sample(qs);
 }
 
+unsigned int Agent::bootstrapAction(State& s)
+{
+    unsigned int a = action(s);
+    s.chooseAction(a);
+
+    return a;
+}
+
 void Agent::GoGreedy()
 {
     this->policy = std::unique_ptr<Policy>(new Greedy(N_ACTIONS));
@@ -93,7 +403,10 @@ void Agent::HandleTransition(State& from_state, int action,
     _agg_delta += abs(delta);
 
     if (++_update_counter % 1000 == 0) {
-        spdlog::get("model_log")->info(_agg_delta / 1000);
+        if (model_binlog != nullptr)
+            model_binlog->append(_agg_delta / 1000);
+        else if (model_logger != nullptr)
+            model_logger->info(_agg_delta / 1000);
 
         _agg_delta = 0.0;
         _update_counter = 0;
@@ -116,151 +429,198 @@ void Agent::UpdateTraces(State& from_state, int action)
 
 double Agent::getQ(State& state, int action)
 {
-    auto features = state.getFeatures(action);
-    double Q = 0.0;
+    const double* q = state.memoQ(0, version);
+    if (q != nullptr)
+        return q[action];
 
-    double w = get<0>(group_weights);
-    for (int i = 0; i < N_TILINGS; i++)
-        Q += w*theta[features[i]];
+    return q_sum(*weights, 0, state.getFeatures(action), N_TILINGS,
+                 group_weights);
+}
 
-    w = get<1>(group_weights);
-    for (int i = N_TILINGS; i < 2*N_TILINGS; i++)
-        Q += w*theta[features[i]];
+const double* Agent::allQ(State& state)
+{
+    const double* q = state.memoQ(0, version);
+    if (q != nullptr)
+        return q;
 
-    w = get<2>(group_weights);
-    for (int i = N_TILINGS; i < 3*N_TILINGS; i++)
-        Q += w*theta[features[i]];
+    double* memo = state.memoiseQ(0, version);
+    q_all(state, N_ACTIONS, N_TILINGS, group_weights, *weights, 0, -1,
+          memo, nullptr);
 
-    return Q;
+    return memo;
 }
 
 void Agent::updateQ(double update)
 {
-    double scaled_update = update / N_TILINGS;
-    for (auto it = traces.begin(); it != traces.end(); it++)
-        theta[*it] += scaled_update * traces.get(*it);
+    version = next_version();
+
+    add_traced(*weights, 0, traces, update / N_TILINGS);
 }
 
 int Agent::argmaxQ(State& state)
 {
-    int index = 0;
-    int n_ties = 1;
-    double currMaxQ = getQ(state, index);
-
-    for (int a = 1; a < N_ACTIONS; a++) {
-        double val = getQ(state, a);
+    return argmax(allQ(state), N_ACTIONS, gen);
+}
 
-        if (val >= currMaxQ) {
-            if (val > currMaxQ) {
-                currMaxQ = val;
-                index = a;
-            } else {
-                n_ties++;
+double Agent::maxQ(State& state)
+{
+    // Which of tied actions is the greedy one does not change the value:
+    const double* q = allQ(state);
 
-                if (0 == rand() % n_ties) {
-                    currMaxQ = val;
-                    index = a;
-                }
-            }
-        }
-    }
+    return *max_element(q, q + N_ACTIONS);
+}
 
-    return index;
+void Agent::invalidateQ()
+{
+    version = next_version();
 }
 
-double Agent::maxQ(State& state)
+// The file each set of weights is saved to:
+static string theta_path(const string& filename, int set)
 {
-    return getQ(state, argmaxQ(state));
+    return (set == 0) ? filename : filename + ".b";
 }
 
 void Agent::write_theta(string filename)
 {
-    ofstream file(filename.c_str(), ios::binary);
-    file.write((char *) theta, MEMORY_SIZE * sizeof(double));
-    file.close();
+    // Always as doubles, whatever they are stored as:
+    for (int set = 0; set < weights->n_sets(); set++) {
+        ofstream file(theta_path(filename, set).c_str(), ios::binary);
+        weights->save(set, file);
+    }
+}
+
+void Agent::read_theta(string filename)
+{
+    for (int set = 0; set < weights->n_sets(); set++) {
+        string path = theta_path(filename, set);
+
+        ifstream file(path.c_str(), ios::binary);
+        if (not file.is_open() and set > 0) {
+            path = filename;
+            file.open(path.c_str(), ios::binary);
+        }
+
+        if (not file.is_open())
+            throw runtime_error("[Agent] Failed to read weights: " + path);
+
+        if (not weights->load(set, file))
+            throw runtime_error("[Agent] Weights are not of memory_size: " +
+                                path);
+    }
+
+    invalidateQ();
+}
+
+void Agent::ImportWeights(State& state, const Agent& from, State& from_state)
+{
+    for (int set = 0; set < weights->n_sets(); set++) {
+        const Weights& from_w = *from.weights;
+        int from_set = min(set, from_w.n_sets() - 1);
+
+        for (int a = 0; a < N_ACTIONS; a++) {
+            const int *f = state.getFeatures(a),
+                      *from_f = from_state.getFeatures(a);
+
+            for (int i = 0; i < state.nFeatures(); i++)
+                weights->set(set, f[i], from_w.get(from_set, from_f[i]));
+        }
+    }
+
+    invalidateQ();
 }
 
 // ---------------
 
 DoubleAgent::DoubleAgent(std::unique_ptr<Policy> policy, Config& c):
-    Agent(std::move(policy), c)
-{
-    theta_b = new double[MEMORY_SIZE];
+    Agent(std::move(policy), c, 2),
 
-    if (c["learning"]["random_init"].as<bool>(false))
-        generate(&theta_b[0], &theta_b[MEMORY_SIZE],
-                 [this]() { return 2.0*unif_dist(gen)-1.0; });
-    else
-        fill(&theta_b[0], &theta_b[MEMORY_SIZE], 0.0);
+    version_b(next_version())
+{
+    weights->initialise(1, c["learning"]["random_init"].as<bool>(false), gen);
 }
 
-DoubleAgent::~DoubleAgent()
+DoubleAgent::DoubleAgent(const DoubleAgent& other):
+    Agent(other),
+
+    version_b(next_version())
+{}
+
+void DoubleAgent::invalidateQ()
 {
-    delete [] theta_b;
+    Agent::invalidateQ();
+    version_b = next_version();
 }
 
 unsigned int DoubleAgent::action(State& s)
 {
-    std::vector<double> qs(N_ACTIONS, 0.0);
+    int chosen = s.takeChosenAction();
+    if (chosen >= 0)
+        return chosen;
+
+    const double *qa, *qb;
+    allQab(s, qa, qb);
+
     for (int a = 0; a < N_ACTIONS; a++)
-        qs[a] = (getQ(s, a) + getQb(s, a)) / 2.0f;
+        qs[a] = (qa[a] + qb[a]) / 2.0f;
 
     return policy->Sample(qs);
 }
 
 double DoubleAgent::getQb(State& state, int action)
 {
-    auto features = state.getFeatures(action);
+    const double* q = state.memoQ(1, version_b);
+    if (q != nullptr)
+        return q[action];
 
-    double Q = 0.0;
+    return q_sum(*weights, 1, state.getFeatures(action), N_TILINGS,
+                 group_weights);
+}
+
+const double* DoubleAgent::allQb(State& state)
+{
+    const double* q = state.memoQ(1, version_b);
+    if (q != nullptr)
+        return q;
 
-    double w = get<0>(group_weights);
-    for (int i = 0; i < N_TILINGS; i++)
-        Q += w*theta_b[features[i]];
+    double* memo = state.memoiseQ(1, version_b);
+    q_all(state, N_ACTIONS, N_TILINGS, group_weights, *weights, 1, -1,
+          memo, nullptr);
 
-    w = get<1>(group_weights);
-    for (int i = N_TILINGS; i < 2*N_TILINGS; i++)
-        Q += w*theta_b[features[i]];
+    return memo;
+}
 
-    w = get<2>(group_weights);
-    for (int i = N_TILINGS; i < 3*N_TILINGS; i++)
-        Q += w*theta_b[features[i]];
+void DoubleAgent::allQab(State& state, const double*& qa, const double*& qb)
+{
+    qa = state.memoQ(0, version);
+    qb = state.memoQ(1, version_b);
 
-    return Q;
+    // Both in one pass when neither is known:
+    if (qa == nullptr and qb == nullptr) {
+        double* memo_a = state.memoiseQ(0, version);
+        double* memo_b = state.memoiseQ(1, version_b);
+
+        q_all(state, N_ACTIONS, N_TILINGS, group_weights, *weights, 0, 1,
+              memo_a, memo_b);
+
+        qa = memo_a;
+        qb = memo_b;
+    }
+
+    if (qa == nullptr) qa = allQ(state);
+    if (qb == nullptr) qb = allQb(state);
 }
 
 void DoubleAgent::updateQb(double update)
 {
-    double scaled_update = update / N_TILINGS;
-    for (auto it = traces.begin(); it != traces.end(); it++)
-        theta_b[*it] += scaled_update * traces.get(*it);
+    version_b = next_version();
+
+    add_traced(*weights, 1, traces, update / N_TILINGS);
 }
 
 int DoubleAgent::argmaxQb(State& state)
 {
-    int index = 0;
-    int n_ties = 1;
-    double currMaxQ = getQb(state, index);
-
-    for (int a = 1; a < N_ACTIONS; a++) {
-        double val = getQb(state, a);
-
-        if (val >= currMaxQ) {
-            if (val > currMaxQ) {
-                currMaxQ = val;
-                index = a;
-            } else {
-                n_ties++;
-
-                if (0 == rand() % n_ties) {
-                    currMaxQ = val;
-                    index = a;
-                }
-            }
-        }
-    }
-
-    return index;
+    return argmax(allQb(state), N_ACTIONS, gen);
 }
 
 // ---------------
@@ -269,6 +629,11 @@ QLearn::QLearn(std::unique_ptr<Policy> policy, Config& c):
     Agent(std::move(policy), c)
 {}
 
+Agent* QLearn::Clone() const
+{
+    return new QLearn(*this);
+}
+
 void QLearn::UpdateTraces(State& from_state, int action)
 {
     int amax = argmaxQ(from_state);
@@ -297,11 +662,16 @@ SARSA::SARSA(std::unique_ptr<Policy> policy, Config& c):
     Agent(std::move(policy), c)
 {}
 
+Agent* SARSA::Clone() const
+{
+    return new SARSA(*this);
+}
+
 double SARSA::UpdateWeights(State& from_state, int action, double reward,
                             State& to_state)
 {
     double Q1 = getQ(from_state, action),
-          Q2 = getQ(to_state, this->action(to_state)),
+          Q2 = getQ(to_state, bootstrapAction(to_state)),
           F = gamma*to_state.getPotential() - from_state.getPotential(),
           delta = reward + F + gamma*Q2 - Q1;
 
@@ -316,6 +686,11 @@ DoubleQLearn::DoubleQLearn(std::unique_ptr<Policy> policy, Config& c):
     DoubleAgent(std::move(policy), c)
 {}
 
+Agent* DoubleQLearn::Clone() const
+{
+    return new DoubleQLearn(*this);
+}
+
 void DoubleQLearn::UpdateTraces(State& from_state, int action)
 {
     int amax = argmaxQ(from_state);
@@ -360,6 +735,11 @@ RLearn::RLearn(std::unique_ptr<Policy> policy, Config& c):
     beta(c["learning"]["beta"].as<double>())
 {}
 
+Agent* RLearn::Clone() const
+{
+    return new RLearn(*this);
+}
+
 void RLearn::UpdateTraces(State& from_state, int action)
 {
     int amax = argmaxQ(from_state);
@@ -395,11 +775,16 @@ OnlineRLearn::OnlineRLearn(std::unique_ptr<Policy> policy, Config& c):
     beta(c["learning"]["beta"].as<double>())
 {}
 
+Agent* OnlineRLearn::Clone() const
+{
+    return new OnlineRLearn(*this);
+}
+
 double OnlineRLearn::UpdateWeights(State& from_state, int action, double reward,
                                    State& to_state)
 {
     double Q = getQ(from_state, action),
-          gQ = getQ(to_state, this->action(to_state)),
+          gQ = getQ(to_state, bootstrapAction(to_state)),
           delta = reward - rho + gQ - Q,
           update = alpha*delta;
 
@@ -419,6 +804,11 @@ DoubleRLearn::DoubleRLearn(std::unique_ptr<Policy> policy, Config& c):
     beta(c["learning"]["beta"].as<double>())
 {}
 
+Agent* DoubleRLearn::Clone() const
+{
+    return new DoubleRLearn(*this);
+}
+
 void DoubleRLearn::UpdateTraces(State& from_state, int action)
 {
     int amax = argmaxQ(from_state);
@@ -451,9 +841,12 @@ double DoubleRLearn::UpdateWeights(State& from_state, int action, double reward,
 
     }
 
+    const double *qa, *qb;
+    allQab(from_state, qa, qb);
+
     mQ = -DBL_MAX;
     for (int i = 0; i < N_ACTIONS; i++) {
-        double val = (getQ(from_state, i) + getQb(from_state, i)) / 2.0;
+        double val = (qa[i] + qb[i]) / 2.0;
 
         if (val > mQ)
             mQ = val;
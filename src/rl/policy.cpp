@@ -46,7 +46,7 @@ unsigned int Greedy::Sample(std::vector<double> &qs)
         } else if (qs[a] >= qs[argmax]) {
             n_ties++;
 
-            if (0 == rand() % n_ties)
+            if (0 == gen() % n_ties)
                 argmax = a;
         }
     }
@@ -1,41 +1,97 @@
 #include "rl/state.h"
 
-#include "rl/tiles.h"
+#include "rl/tile_coder.h"
 
+#include <climits>
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 
 using namespace rl;
 
-State::State(long memory_size, int n_actions, int n_tilings):
+static bool fast_hashing(Config &c)
+{
+    std::string scheme = c["learning"]["tile_hashing"].as<std::string>("compatible");
+
+    if (scheme != "compatible" and scheme != "fast")
+        throw std::runtime_error("[State] Unknown tile hashing: " + scheme);
+
+    return scheme == "fast";
+}
+
+static bool action_major(Config &c)
+{
+    std::string layout = c["learning"]["weight_layout"].as<std::string>("hashed");
+
+    if (layout != "hashed" and layout != "action_major")
+        throw std::runtime_error("[State] Unknown weight layout: " + layout);
+
+    return layout == "action_major";
+}
+
+State::State(long memory_size, int n_actions, int n_tilings,
+             bool fast_hashing, bool action_major):
     MEMORY_SIZE(memory_size),
     N_TILINGS(n_tilings),
     N_ACTIONS(n_actions),
+    FAST_HASHING(fast_hashing),
+    ACTION_MAJOR(action_major),
 
     state_vars(),
-    features(n_actions, std::vector<int>(3*n_tilings, 0)),
+    features(n_actions * 3*n_tilings, 0),
 
-    potential(0.0)
-{}
+    qstate(),
+    sums(3*n_tilings, 0),
+
+    potential(0.0),
+
+    q_memo{std::vector<double>(n_actions, 0.0),
+           std::vector<double>(n_actions, 0.0)},
+    q_version{0, 0},
+
+    chosen_action(-1)
+{
+    if (n_tilings > tile_coder::MAX_NUM_TILINGS)
+        throw std::runtime_error("[State] Too many tilings: " +
+                                 std::to_string(n_tilings));
+
+    // Features are ints (and the tile coder's reductions 32-bit):
+    if (memory_size > INT_MAX)
+        throw std::runtime_error("[State] memory_size is above INT_MAX: " +
+                                 std::to_string(memory_size));
+
+    if (action_major and memory_size < n_actions)
+        throw std::runtime_error("[State] Memory too small for the actions.");
+}
 
 State::State(Config &c):
     State(c["learning"]["memory_size"].as<long>(),
           c["learning"]["n_actions"].as<int>(),
-          c["learning"]["n_tilings"].as<int>())
+          c["learning"]["n_tilings"].as<int>(),
+          fast_hashing(c),
+          action_major(c))
 {}
 
 void State::initialise()
 {
     state_vars.clear();
 
-    for (int a = 0; a < N_ACTIONS; a++)
-        features[a].clear();
+    std::fill(features.begin(), features.end(), 0);
+
+    forget();
+}
+
+void State::forget()
+{
+    q_version[0] = q_version[1] = 0;
+    chosen_action = -1;
 }
 
 void State::newState(environment::Base& env)
 {
-    state_vars.clear();
-    env.getState(state_vars);
+    // Sized once, then overwritten in place on every step:
+    state_vars.resize(env.getStateSize());
+    env.getState(state_vars.data());
 
     populateFeatures();
 
@@ -52,21 +108,97 @@ void State::newState(vector<float>& _vars, double _potential)
 
 void State::populateFeatures()
 {
-    for (int a = 0; a < N_ACTIONS; a++) {
-        ::tiles(&features[a][0], N_TILINGS, MEMORY_SIZE,
-                &state_vars[0], 3, a);
+    forget();
+
+    int n = state_vars.size();
+
+    // The groups are the first three variables, the rest, and all of them;
+    // each is quantised and hashed in every tiling once, then the actions
+    // either add their own hashing int or share the tile:
+    qstate.resize(n);
+    tile_coder::quantise(qstate.data(), state_vars.data(), n, N_TILINGS);
 
-        ::tiles(&features[a][N_TILINGS], N_TILINGS, MEMORY_SIZE,
-                &state_vars[3], state_vars.size()-3, N_ACTIONS + a);
+    const int group_floats[3] = {3, n-3, n};
+    const int group_start[3] = {0, 3, 0};
 
-        ::tiles(&features[a][2*N_TILINGS], N_TILINGS, MEMORY_SIZE,
-                &state_vars[0], state_vars.size(), (2*N_ACTIONS) + a);
+    for (int g = 0; g < 3; g++)
+        tile_coder::hash_tilings(&sums[g*N_TILINGS], N_TILINGS,
+                                 &qstate[group_start[g]], group_floats[g]);
+
+    if (ACTION_MAJOR) {
+        long n_tiles = MEMORY_SIZE / N_ACTIONS;
+
+        for (int g = 0; g < 3; g++) {
+            int h = g*N_ACTIONS;
+            long key = tile_coder::hash_ints(&h, 1, group_floats[g]);
+
+            const long* s = &sums[g*N_TILINGS];
+            for (int j = 0; j < N_TILINGS; j++) {
+                long tile = FAST_HASHING ?
+                    tile_coder::reduce_fast(s[j] + key, n_tiles) :
+                    (s[j] + key) % n_tiles;
+
+                int* f = &features[g*N_TILINGS + j];
+                for (int a = 0; a < N_ACTIONS; a++)
+                    f[a * 3*N_TILINGS] = tile*N_ACTIONS + a;
+            }
+        }
+
+        return;
     }
+
+    for (int a = 0; a < N_ACTIONS; a++) {
+        int* f = &features[a * 3*N_TILINGS];
+
+        for (int g = 0; g < 3; g++) {
+            int h = g*N_ACTIONS + a;
+            long key = tile_coder::hash_ints(&h, 1, group_floats[g]);
+
+            const long* s = &sums[g*N_TILINGS];
+            if (FAST_HASHING)
+                for (int j = 0; j < N_TILINGS; j++)
+                    f[g*N_TILINGS + j] =
+                        tile_coder::reduce_fast(s[j] + key, MEMORY_SIZE);
+            else
+                for (int j = 0; j < N_TILINGS; j++)
+                    f[g*N_TILINGS + j] = (int) ((s[j] + key) % MEMORY_SIZE);
+        }
+    }
+}
+
+const int* State::getFeatures(int action) const
+{
+    return &features[action * 3*N_TILINGS];
 }
 
-std::vector<int>& State::getFeatures(int action)
+int State::nFeatures() const
 {
-    return features[action];
+    return 3*N_TILINGS;
+}
+
+const double* State::memoQ(int weights, unsigned long version) const
+{
+    return (q_version[weights] == version) ? q_memo[weights].data() : nullptr;
+}
+
+double* State::memoiseQ(int weights, unsigned long version)
+{
+    q_version[weights] = version;
+
+    return q_memo[weights].data();
+}
+
+void State::chooseAction(int action)
+{
+    chosen_action = action;
+}
+
+int State::takeChosenAction()
+{
+    int action = chosen_action;
+    chosen_action = -1;
+
+    return action;
 }
 
 double State::getPotential()
@@ -0,0 +1,256 @@
+#include "rl/tile_coder.h"
+
+#include "rl/tiles.h"
+
+#include <cmath>
+#include <string>
+#include <stdexcept>
+
+#if defined(__x86_64__) or defined(__i386__)
+#define RL_TILE_CODER_X86
+#include <immintrin.h>
+
+// The intrinsics headers leave some lanes deliberately undefined:
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+using namespace rl;
+
+// As in ::tiles():
+static const int INCREMENT = 449;
+static const int TABLE_MASK = 2047;
+
+// The coordinate of dimension i in tiling j, where q is the quantised
+// variable. Tiling j is displaced by j*(1 + 2i) in dimension i, and the
+// coordinate is q less (q - displacement) modulo num_tilings, rounded
+// towards minus infinity:
+static inline int coordinate(int q, int i, int j, int num_tilings)
+{
+    int base = j * (1 + 2*i);
+
+    if (q >= base)
+        return q - ((q - base) % num_tilings);
+    else
+        return q+1 + ((base - q - 1) % num_tilings) - num_tilings;
+}
+
+static void sums_scalar(long the_sums[], int num_tilings,
+                        const int qstate[], int num_floats)
+{
+    const unsigned int* table = hash_UNH_table();
+
+    for (int j = 0; j < num_tilings; j++) {
+        long sum = 0;
+
+        for (int i = 0; i < num_floats; i++) {
+            int c = coordinate(qstate[i], i, j, num_tilings);
+            sum += table[(c + INCREMENT*i) & TABLE_MASK];
+        }
+
+        the_sums[j] = sum + table[(j + INCREMENT*num_floats) & TABLE_MASK];
+    }
+}
+
+#ifdef RL_TILE_CODER_X86
+// With num_tilings a power of two, the rounding in coordinate() is the
+// two's complement mask of (q - displacement), with no branch:
+__attribute__((target("avx2")))
+static void sums_avx2(long the_sums[], int num_tilings,
+                      const int qstate[], int num_floats)
+{
+    const int* table = (const int*) hash_UNH_table();
+
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                  mask = _mm256_set1_epi32(num_tilings - 1),
+                  wrap = _mm256_set1_epi32(TABLE_MASK);
+
+    for (int j = 0; j < num_tilings; j += 8) {
+        __m256i tiling = _mm256_add_epi32(_mm256_set1_epi32(j), lanes);
+
+        // The sums of tilings j..j+3 and j+4..j+7:
+        __m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+
+        for (int i = 0; i <= num_floats; i++) {
+            __m256i c = tiling;
+
+            if (i < num_floats) {
+                __m256i q = _mm256_set1_epi32(qstate[i]),
+                        base = _mm256_mullo_epi32(
+                            tiling, _mm256_set1_epi32(1 + 2*i));
+
+                c = _mm256_sub_epi32(
+                    q, _mm256_and_si256(_mm256_sub_epi32(q, base), mask));
+            }
+
+            __m256i index = _mm256_and_si256(
+                _mm256_add_epi32(c, _mm256_set1_epi32(INCREMENT*i)), wrap);
+            __m256i h = _mm256_i32gather_epi32(table, index, 4);
+
+            lo = _mm256_add_epi64(
+                lo, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(h)));
+            hi = _mm256_add_epi64(
+                hi, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(h, 1)));
+        }
+
+        _mm256_storeu_si256((__m256i*) (the_sums + j), lo);
+        _mm256_storeu_si256((__m256i*) (the_sums + j + 4), hi);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void sums_avx512(long the_sums[], int num_tilings,
+                        const int qstate[], int num_floats)
+{
+    const int* table = (const int*) hash_UNH_table();
+
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                            8, 9, 10, 11, 12, 13, 14, 15),
+                  mask = _mm512_set1_epi32(num_tilings - 1),
+                  wrap = _mm512_set1_epi32(TABLE_MASK);
+
+    for (int j = 0; j < num_tilings; j += 16) {
+        __m512i tiling = _mm512_add_epi32(_mm512_set1_epi32(j), lanes);
+
+        __m512i lo = _mm512_setzero_si512(), hi = _mm512_setzero_si512();
+
+        for (int i = 0; i <= num_floats; i++) {
+            __m512i c = tiling;
+
+            if (i < num_floats) {
+                __m512i q = _mm512_set1_epi32(qstate[i]),
+                        base = _mm512_mullo_epi32(
+                            tiling, _mm512_set1_epi32(1 + 2*i));
+
+                c = _mm512_sub_epi32(
+                    q, _mm512_and_si512(_mm512_sub_epi32(q, base), mask));
+            }
+
+            __m512i index = _mm512_and_si512(
+                _mm512_add_epi32(c, _mm512_set1_epi32(INCREMENT*i)), wrap);
+            __m512i h = _mm512_i32gather_epi32(index, table, 4);
+
+            lo = _mm512_add_epi64(
+                lo, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(h)));
+            hi = _mm512_add_epi64(
+                hi, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(h, 1)));
+        }
+
+        _mm512_storeu_si512((__m512i*) (the_sums + j), lo);
+        _mm512_storeu_si512((__m512i*) (the_sums + j + 8), hi);
+    }
+}
+#endif
+
+// ------------------------------------------------------------------
+bool tile_coder::supported(ISA isa)
+{
+    switch (isa) {
+        case ISA::SCALAR:
+            return true;
+
+#ifdef RL_TILE_CODER_X86
+        case ISA::AVX2:
+            return __builtin_cpu_supports("avx2");
+
+        case ISA::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+
+        default:
+            return false;
+    }
+}
+
+tile_coder::ISA tile_coder::best()
+{
+    static const ISA isa = supported(ISA::AVX512) ? ISA::AVX512 :
+                           supported(ISA::AVX2) ? ISA::AVX2 : ISA::SCALAR;
+
+    return isa;
+}
+
+const char* tile_coder::name(ISA isa)
+{
+    switch (isa) {
+        case ISA::AVX2: return "avx2";
+        case ISA::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+void tile_coder::quantise(int qstate[], const float floats[],
+                          int num_floats, int num_tilings)
+{
+    // As in ::tiles() (tile widths == num_tilings):
+    for (int i = 0; i < num_floats; i++)
+        qstate[i] = (int) floor(floats[i] * num_tilings);
+}
+
+void tile_coder::hash_tilings(ISA isa, long the_sums[], int num_tilings,
+                              const int qstate[], int num_floats)
+{
+#ifdef RL_TILE_CODER_X86
+    bool power_of_two = (num_tilings & (num_tilings - 1)) == 0;
+
+    if (isa == ISA::AVX512 and power_of_two and num_tilings >= 16)
+        return sums_avx512(the_sums, num_tilings, qstate, num_floats);
+
+    if (isa != ISA::SCALAR and power_of_two and num_tilings >= 8)
+        return sums_avx2(the_sums, num_tilings, qstate, num_floats);
+#else
+    (void) isa;
+#endif
+
+    sums_scalar(the_sums, num_tilings, qstate, num_floats);
+}
+
+void tile_coder::hash_tilings(long the_sums[], int num_tilings,
+                              const int qstate[], int num_floats)
+{
+    hash_tilings(best(), the_sums, num_tilings, qstate, num_floats);
+}
+
+long tile_coder::hash_ints(const int ints[], int num_ints, int num_floats)
+{
+    const unsigned int* table = hash_UNH_table();
+
+    // The ints follow the floats and the tiling in the hashed coordinates:
+    long sum = 0;
+    for (int k = 0; k < num_ints; k++) {
+        int i = num_floats + 1 + k;
+        sum += table[((long) ints[k] + INCREMENT*i) & TABLE_MASK];
+    }
+
+    return sum;
+}
+
+void tile_coder::tiles(int the_tiles[], int num_tilings, int memory_size,
+                       const float floats[], int num_floats,
+                       const int ints[], int num_ints)
+{
+    tiles(best(), the_tiles, num_tilings, memory_size,
+          floats, num_floats, ints, num_ints);
+}
+
+void tile_coder::tiles(ISA isa, int the_tiles[], int num_tilings,
+                       int memory_size, const float floats[], int num_floats,
+                       const int ints[], int num_ints)
+{
+    if (num_floats > MAX_NUM_VARS)
+        throw std::runtime_error("[TileCoder] Too many variables: " +
+                                 std::to_string(num_floats));
+
+    if (num_tilings > MAX_NUM_TILINGS)
+        throw std::runtime_error("[TileCoder] Too many tilings: " +
+                                 std::to_string(num_tilings));
+
+    int qstate[MAX_NUM_VARS];
+    quantise(qstate, floats, num_floats, num_tilings);
+
+    long sums[MAX_NUM_TILINGS];
+    hash_tilings(isa, sums, num_tilings, qstate, num_floats);
+
+    long fixed = hash_ints(ints, num_ints, num_floats);
+    for (int j = 0; j < num_tilings; j++)
+        the_tiles[j] = (int) ((sums[j] + fixed) % memory_size);
+}
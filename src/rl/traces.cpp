@@ -1,102 +1,187 @@
 #include "rl/traces.h"
 
-#include <iostream>
-#include <iterator>
+#include <cstdint>
 
 using namespace rl;
 
-Traces::Traces(long memory_size, int n_tilings, int n_actions):
-    MEMORY_SIZE(memory_size),
+// Below this, the scale is folded into the values before they overflow:
+static const double MIN_SCALE = 1e-100;
+
+static const int MIN_SLOTS = 1 << 12;
+
+Traces::Traces(int n_tilings, int n_actions):
     N_TILINGS(n_tilings),
     N_ACTIONS(n_actions),
 
     tolerance(0.01),
-    n_nonzero_traces(0)
+    scale(1.0),
+
+    slots(MIN_SLOTS, -1),
+    shift(32 - 12)
+{
+    features.reserve(MIN_SLOTS / 2);
+    values.reserve(MIN_SLOTS / 2);
+}
+
+int Traces::home(int feature) const
+{
+    return (int) (((uint32_t) feature * 2654435769u) >> shift);
+}
+
+int Traces::find(int feature) const
+{
+    const int mask = slots.size() - 1;
+
+    for (int s = home(feature); slots[s] >= 0; s = (s + 1) & mask)
+        if (features[slots[s]] == feature)
+            return s;
+
+    return -1;
+}
+
+void Traces::grow()
 {
-    eligibility = new float[MEMORY_SIZE];
-    nonzero_traces_inverse = new int[MEMORY_SIZE];
-    for (long i = 0; i < MEMORY_SIZE; i++) {
-        eligibility[i] = 0.0;
-        nonzero_traces_inverse[i] = 0;
+    shift--;
+    slots.assign(2 * slots.size(), -1);
+
+    const int mask = slots.size() - 1;
+    for (size_t k = 0; k < features.size(); k++) {
+        int s = home(features[k]);
+        while (slots[s] >= 0) s = (s + 1) & mask;
+
+        slots[s] = k;
     }
 }
 
-Traces::~Traces()
+void Traces::remove(int slot)
 {
-    delete [] eligibility;
-    delete [] nonzero_traces_inverse;
+    const int mask = slots.size() - 1;
+    int k = slots[slot];
+
+    // Close the gap, moving back any entry that would no longer be found:
+    for (int s = (slot + 1) & mask; slots[s] >= 0; s = (s + 1) & mask) {
+        int h = home(features[slots[s]]);
+
+        if ((s > slot and (h <= slot or h > s)) or
+            (s < slot and (h <= slot and h > s))) {
+            slots[slot] = slots[s];
+            slot = s;
+        }
+    }
+    slots[slot] = -1;
+
+    // The last trace takes the place of the one removed:
+    int last = features.size() - 1;
+    if (k != last) {
+        slots[find(features[last])] = k;
+
+        features[k] = features[last];
+        values[k] = values[last];
+    }
+
+    features.pop_back();
+    values.pop_back();
 }
 
 void Traces::decay(float rate)
 {
-    for (int loc = n_nonzero_traces-1; loc >= 0; loc--) {
-        int f = nonzero_traces[loc];
-        eligibility[f] *= rate;
+    if (rate == 0.0f) {
+        // Only the slots of live traces are emptied. Each is still on the
+        // probe path of its feature, past any emptied before it:
+        const int mask = slots.size() - 1;
+        for (size_t k = 0; k < features.size(); k++) {
+            int s = home(features[k]);
+            while (slots[s] != (int) k) s = (s + 1) & mask;
+
+            slots[s] = -1;
+        }
+
+        features.clear();
+        values.clear();
+
+        scale = 1.0;
+
+        return;
+    }
+
+    scale *= rate;
 
-        if (eligibility[f] < tolerance) clearExisting(f, loc);
+    if (scale < MIN_SCALE) {
+        for (auto& v : values) v *= scale;
+        scale = 1.0;
     }
 }
 
 void Traces::update(State& state, int action)
 {
     for (int a = 0; a < N_ACTIONS; a++) {
-        auto features = state.getFeatures(a);
+        const int* f = state.getFeatures(a);
 
         if (a != action)
-            for (int t = 0; t < N_TILINGS; t++) clear(features[t]);
+            for (int t = 0; t < N_TILINGS; t++) clear(f[t]);
         else
-            for (int t = 0; t < N_TILINGS; t++) set(features[t], 1.0);
+            for (int t = 0; t < N_TILINGS; t++) set(f[t], 1.0);
     }
 }
 
-int* Traces::begin()
+void Traces::prune()
 {
-    return nonzero_traces;
+    // Backwards, so that the traces moved into the gaps have been seen:
+    const double min_value = tolerance / scale;
+
+    for (int k = values.size() - 1; k >= 0; k--)
+        if (values[k] < min_value)
+            remove(find(features[k]));
 }
 
-int* Traces::end()
+int Traces::size() const
 {
-    return &nonzero_traces[n_nonzero_traces];
+    return features.size();
 }
 
-float Traces::get(int feature)
+const int* Traces::getFeatures() const
 {
-    return eligibility[feature];
+    return features.data();
 }
 
-void Traces::set(int feature, float value)
+const double* Traces::getValues() const
 {
-    if (eligibility[feature] >= tolerance) eligibility[feature] = value;
-    else {
-        while (n_nonzero_traces >= MAX_NONZERO_TRACES) increaseTolerance();
-
-        eligibility[feature] = value;
-        nonzero_traces[n_nonzero_traces] = feature;
-        nonzero_traces_inverse[feature] = n_nonzero_traces;
-        n_nonzero_traces++;
-    }
+    return values.data();
 }
 
-void Traces::clear(int feature)
+double Traces::getScale() const
 {
-    if (eligibility[feature] != 0.0)
-        clearExisting(feature, nonzero_traces_inverse[feature]);
+    return scale;
 }
 
-void Traces::clearExisting(int feature, int loc)
+float Traces::get(int feature) const
 {
-    eligibility[feature] = 0.0;
-    n_nonzero_traces--;
-    nonzero_traces[loc] = nonzero_traces[n_nonzero_traces];
-    nonzero_traces_inverse[nonzero_traces[loc]] = loc;
+    int s = find(feature);
+
+    return (s < 0) ? 0.0f : values[slots[s]] * scale;
 }
 
-void Traces::increaseTolerance()
+void Traces::set(int feature, float value)
 {
-    tolerance *= 1.1;
-    for (int loc = n_nonzero_traces-1; loc >= 0; loc--) {
-        int f = nonzero_traces[loc];
+    int s = find(feature);
+    if (s >= 0) {
+        values[slots[s]] = value / scale;
 
-        if (eligibility[f] < tolerance) clearExisting(f, loc);
+        return;
     }
+
+    if (2 * (features.size() + 1) > slots.size()) grow();
+
+    const int mask = slots.size() - 1;
+    for (s = home(feature); slots[s] >= 0; s = (s + 1) & mask);
+
+    slots[s] = features.size();
+    features.push_back(feature);
+    values.push_back(value / scale);
+}
+
+void Traces::clear(int feature)
+{
+    int s = find(feature);
+    if (s >= 0) remove(s);
 }
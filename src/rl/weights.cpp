@@ -0,0 +1,314 @@
+#include "rl/weights.h"
+#include "utilities/serialise.h"
+
+#include <climits>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace rl;
+
+static size_t type_size(Weights::Type type)
+{
+    switch (type) {
+        case Weights::Type::FLOAT: return sizeof(float);
+        case Weights::Type::BF16: return sizeof(bf16);
+        default: return sizeof(double);
+    }
+}
+
+// A sparse file starts with this (where the raw doubles would be),
+// followed by the number of tiles and a key and weight for each:
+static const uint64_t SPARSE_MAGIC = 0x4553524150534C52ULL;
+
+static uint64_t mix(uint64_t x)
+{
+    // splitmix64's finaliser:
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+    return x ^ (x >> 31);
+}
+
+template<class T>
+static void copy_out(const T* w, long stride, long n, double out[])
+{
+    for (long i = 0; i < n; i++)
+        out[i] = (double) w[stride*i];
+}
+
+template<class T>
+static void copy_in(T* w, T* residuals, long stride, long n,
+                    const double in[])
+{
+    for (long i = 0; i < n; i++) {
+        w[stride*i] = (T) in[i];
+        if (residuals != nullptr) residuals[stride*i] = (T) 0.0f;
+    }
+}
+
+// ------------------------------------------------------------------
+SparseWeights::SparseWeights(int n_sets):
+    n_sets_(n_sets),
+    width_(1 + n_sets),
+    seeds_(n_sets, 0),
+
+    shift_(64 - 16),
+    mask_((1L << 16) - 1),
+    count_(0)
+{
+    slots_.resize((mask_ + 1) * width_);
+    for (long s = 0; s <= mask_; s++)
+        slots_[s * width_].key = EMPTY;
+}
+
+void SparseWeights::randomise(int set, uint64_t seed)
+{
+    // Nonzero, as 0 stands for no random weights:
+    seeds_[set] = seed | 1;
+}
+
+double SparseWeights::initial(int set, long key) const
+{
+    if (seeds_[set] == 0)
+        return 0.0;
+
+    uint64_t h = mix(seeds_[set] ^ mix((uint64_t) key));
+
+    // The top 53 bits, as a double in [0, 1):
+    return 2.0*((h >> 11) / 9007199254740992.0) - 1.0;
+}
+
+double* SparseWeights::insert(long key)
+{
+    long s = home(key);
+    for (; slots_[s * width_].key != EMPTY; s = (s + 1) & mask_)
+        if (slots_[s * width_].key == key)
+            return &slots_[s*width_ + 1].w;
+
+    // Kept at most half full, so that probes stay short:
+    if (2*(count_ + 1) > mask_ + 1) {
+        grow();
+
+        for (s = home(key); slots_[s * width_].key != EMPTY;
+             s = (s + 1) & mask_);
+    }
+
+    slots_[s * width_].key = key;
+    for (int k = 0; k < n_sets_; k++)
+        slots_[s*width_ + 1 + k].w = initial(k, key);
+
+    count_++;
+
+    return &slots_[s*width_ + 1].w;
+}
+
+void SparseWeights::grow()
+{
+    vector<Word> old;
+    old.swap(slots_);
+
+    shift_--;
+    mask_ = 2*mask_ + 1;
+
+    slots_.resize((mask_ + 1) * width_);
+    for (long s = 0; s <= mask_; s++)
+        slots_[s * width_].key = EMPTY;
+
+    for (size_t o = 0; o < old.size(); o += width_) {
+        if (old[o].key == EMPTY)
+            continue;
+
+        long s = home(old[o].key);
+        while (slots_[s * width_].key != EMPTY)
+            s = (s + 1) & mask_;
+
+        copy(&old[o], &old[o] + width_, &slots_[s * width_]);
+    }
+}
+
+// ------------------------------------------------------------------
+Weights::Type Weights::parse(const string& name)
+{
+    if (name == "double") return Type::DOUBLE;
+    if (name == "float") return Type::FLOAT;
+    if (name == "bf16") return Type::BF16;
+
+    throw runtime_error("[Weights] Unknown weight type: " + name);
+}
+
+Weights::Weights(Type type, long size, int n_sets, bool interleave,
+                 bool compensated, bool sparse):
+    type_(type),
+    size_(size),
+    n_sets_(n_sets),
+    interleaved_(interleave and n_sets > 1)
+{
+    // Indexed by the features of a State, which are ints:
+    if (size > INT_MAX)
+        throw runtime_error("[Weights] Size is above INT_MAX: " +
+                            to_string(size));
+
+    if (sparse) {
+        if (type != Type::DOUBLE)
+            throw runtime_error("[Weights] Sparse weights are doubles.");
+
+        sparse_.reset(new SparseWeights(n_sets));
+
+        return;
+    }
+
+    data_.reset(new char[type_size(type) * size * n_sets]);
+
+    // Doubles are exact enough as they are:
+    if (compensated and type != Type::DOUBLE) {
+        size_t n = type_size(type) * size * n_sets;
+
+        residuals_.reset(new char[n]);
+        memset(residuals_.get(), 0, n);
+    }
+}
+
+size_t Weights::offset(int set) const
+{
+    return type_size(type_) * (interleaved_ ? set : set * size_);
+}
+
+double Weights::get(int set, long i) const
+{
+    if (sparse_)
+        return sparse_->get(set, i);
+
+    long j = stride() * i;
+
+    switch (type_) {
+        case Type::FLOAT: return data<float>(set)[j];
+        case Type::BF16: return data<bf16>(set)[j];
+        default: return data<double>(set)[j];
+    }
+}
+
+void Weights::set(int set, long i, double w)
+{
+    if (sparse_)
+        return sparse_->set(set, i, w);
+
+    long j = stride() * i;
+
+    switch (type_) {
+        case Type::FLOAT:
+            data<float>(set)[j] = (float) w;
+            if (residuals_) residuals<float>(set)[j] = 0.0f;
+            break;
+
+        case Type::BF16:
+            data<bf16>(set)[j] = (float) w;
+            if (residuals_) residuals<bf16>(set)[j] = 0.0f;
+            break;
+
+        default:
+            data<double>(set)[j] = w;
+    }
+}
+
+void Weights::initialise(int set, bool random, mt19937_64& gen)
+{
+    if (sparse_) {
+        if (random) sparse_->randomise(set, gen());
+
+        return;
+    }
+
+    uniform_real_distribution<double> unif(0.0, 1.0);
+    for (long i = 0; i < size_; i++)
+        this->set(set, i, random ? 2.0*unif(gen)-1.0 : 0.0);
+}
+
+void Weights::save(int set, ostream& os) const
+{
+    if (sparse_) {
+        serialise::write(os, SPARSE_MAGIC);
+        serialise::write(os, (uint64_t) sparse_->size());
+
+        sparse_->for_each([&](long key, const double* w) {
+            serialise::write(os, (int64_t) key);
+            serialise::write(os, w[set]);
+        });
+
+        return;
+    }
+
+    vector<double> w(size_);
+    switch (type_) {
+        case Type::FLOAT:
+            copy_out(data<float>(set), stride(), size_, w.data()); break;
+        case Type::BF16:
+            copy_out(data<bf16>(set), stride(), size_, w.data()); break;
+        default:
+            copy_out(data<double>(set), stride(), size_, w.data());
+    }
+
+    os.write((const char*) w.data(), size_ * sizeof(double));
+}
+
+bool Weights::load(int set, istream& is)
+{
+    uint64_t magic = 0;
+    is.read((char*) &magic, sizeof magic);
+
+    if (is.gcount() == sizeof magic and magic == SPARSE_MAGIC) {
+        try {
+            uint64_t n;
+            serialise::read(is, n);
+
+            for (uint64_t k = 0; k < n; k++) {
+                int64_t key;
+                double w;
+                serialise::read(is, key);
+                serialise::read(is, w);
+
+                if (key < 0 or key >= size_)
+                    return false;
+
+                this->set(set, key, w);
+            }
+        } catch (runtime_error& e) {
+            return false;
+        }
+
+        return true;
+    }
+
+    is.clear();
+    is.seekg(0);
+
+    vector<double> w(size_);
+    is.read((char*) w.data(), size_ * sizeof(double));
+    if (is.gcount() != (streamsize) (size_ * sizeof(double)))
+        return false;
+
+    if (sparse_) {
+        // Only what differs from the weights it would have anyway:
+        for (long i = 0; i < size_; i++)
+            if (w[i] != sparse_->initial(set, i))
+                sparse_->set(set, i, w[i]);
+
+        return true;
+    }
+
+    switch (type_) {
+        case Type::FLOAT:
+            copy_in(data<float>(set), residuals<float>(set),
+                    stride(), size_, w.data());
+            break;
+        case Type::BF16:
+            copy_in(data<bf16>(set), residuals<bf16>(set),
+                    stride(), size_, w.data());
+            break;
+        default:
+            copy_in(data<double>(set), (double*) nullptr,
+                    stride(), size_, w.data());
+    }
+
+    return true;
+}
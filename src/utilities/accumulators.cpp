@@ -1,4 +1,5 @@
 #include "utilities/accumulators.h"
+#include "utilities/serialise.h"
 
 #include <math.h>
 #include <numeric>
@@ -61,6 +62,8 @@ template <typename T>
 void Accumulator<T>::clear()
 {
     window.clear();
+
+    _sum = T(0);
 }
 
 template <typename T>
@@ -75,6 +78,28 @@ size_t Accumulator<T>::size()
     return window.size();
 }
 
+template <typename T>
+void Accumulator<T>::save(std::ostream& os)
+{
+    serialise::write(os, (uint64_t) window_size);
+    serialise::write(os, window);
+    serialise::write(os, _sum);
+}
+
+template <typename T>
+void Accumulator<T>::load(std::istream& is)
+{
+    uint64_t ws;
+    serialise::read(is, ws);
+
+    if (ws != window_size)
+        throw runtime_error("Attempting to load an accumulator with a "
+                            "different window size...");
+
+    serialise::read(is, window);
+    serialise::read(is, _sum);
+}
+
 // ------------ Rolling Mean --------------------
 
 template <typename T>
@@ -108,6 +133,15 @@ void RollingMean<T>::push(T val)
     }
 }
 
+template <typename T>
+void RollingMean<T>::clear()
+{
+    Accumulator<T>::clear();
+
+    _mean = T(0);
+    _s = T(0);
+}
+
 template <typename T>
 T RollingMean<T>::mean()
 {
@@ -143,6 +177,24 @@ T RollingMean<T>::last_zscore()
     return zscore(this->window.front());
 }
 
+template <typename T>
+void RollingMean<T>::save(std::ostream& os)
+{
+    Accumulator<T>::save(os);
+
+    serialise::write(os, _mean);
+    serialise::write(os, _s);
+}
+
+template <typename T>
+void RollingMean<T>::load(std::istream& is)
+{
+    Accumulator<T>::load(is);
+
+    serialise::read(is, _mean);
+    serialise::read(is, _s);
+}
+
 // ------------ EWMA --------------------
 
 template <typename T>
@@ -162,17 +214,43 @@ void EWMA<T>::push(T val)
     this->_mean = (this->_alpha * val) + ((1 - this->_alpha) * this->_mean);
 }
 
+template <typename T>
+void EWMA<T>::clear()
+{
+    Accumulator<T>::clear();
+
+    _mean = T(0);
+}
+
 template <typename T>
 T EWMA<T>::mean()
 {
     return _mean;
 }
 
+template <typename T>
+void EWMA<T>::save(std::ostream& os)
+{
+    Accumulator<T>::save(os);
+
+    serialise::write(os, _mean);
+}
+
+template <typename T>
+void EWMA<T>::load(std::istream& is)
+{
+    Accumulator<T>::load(is);
+
+    serialise::read(is, _mean);
+}
+
 // ----------- Rolling Median -------------------
 
 template <typename T>
 RollingMedian<T>::RollingMedian(size_t window_size):
-    Accumulator<T>(window_size)
+    Accumulator<T>(window_size),
+
+    sorted_(window_size)
 {}
 
 template <typename T>
@@ -184,42 +262,38 @@ void RollingMedian<T>::push(T val)
 
         this->_sum -= old;
 
-        if (min_heap.size() and old <= *(--min_heap.end()))
-            min_heap.erase(min_heap.find(old));
-        else if (max_heap.size() and old >= *max_heap.begin())
-            max_heap.erase(max_heap.find(old));
+        sorted_.remove(old);
     }
 
     this->_sum += val;
     this->window.push_front(val);
 
-    if (max_heap.size() and val >= *max_heap.begin())
-        max_heap.insert(val);
-    else
-        min_heap.insert(val);
+    sorted_.insert(val);
+}
 
-    while (min_heap.size() > max_heap.size()) {
-        max_heap.insert(*(--min_heap.end()));
-        min_heap.erase(--min_heap.end());
-    }
+template <typename T>
+void RollingMedian<T>::clear()
+{
+    Accumulator<T>::clear();
 
-    while (max_heap.size() > min_heap.size()) {
-        min_heap.insert(*max_heap.begin());
-        max_heap.erase(max_heap.begin());
-    }
+    sorted_.clear();
 }
 
 template <typename T>
 T RollingMedian<T>::median()
 {
-    T median;
+    size_t n = sorted_.size();
 
-    if (min_heap.size() == max_heap.size())
-        median = ((*(--min_heap.end()) + *max_heap.begin()) / 2.0f);
+    if (n % 2 == 0)
+        return ((sorted_.at(n/2 - 1) + sorted_.at(n/2)) / 2.0f);
     else
-        median = *(--min_heap.end());
+        return sorted_.at(n/2);
+}
 
-    return median;
+template <typename T>
+T RollingMedian<T>::quantile(double q)
+{
+    return sorted_.quantile(q);
 }
 
 template <typename T>
@@ -227,23 +301,7 @@ T RollingMedian<T>::quartile(double q)
 {
     if (this->size() < 3) return median();
 
-    size_t loc;
-    typename multiset<T>::iterator it;
-
-    if (q <= 0.50) {
-        loc = q*min_heap.size();
-        it = min_heap.cbegin();
-    } else {
-        loc = q*max_heap.size()/2;
-        it = max_heap.cbegin();
-    }
-
-    advance(it, loc);
-
-    if (loc && loc % 2 == 0)
-        return T(*it + *(--it)) / 2.0f;
-    else
-        return *it;
+    return quantile(q);
 }
 
 template <typename T>
@@ -255,13 +313,13 @@ T RollingMedian<T>::iqr()
 template <typename T>
 T RollingMedian<T>::min()
 {
-    return *min_heap.begin();
+    return sorted_.at(0);
 }
 
 template <typename T>
 T RollingMedian<T>::max()
 {
-    return *(--max_heap.end());
+    return sorted_.at(sorted_.size() - 1);
 }
 
 template <typename T>
@@ -277,6 +335,17 @@ T RollingMedian<T>::last_zscore()
     return zscore(this->window.front());
 }
 
+template <typename T>
+void RollingMedian<T>::load(std::istream& is)
+{
+    Accumulator<T>::load(is);
+
+    // The order statistics are fully determined by the window contents:
+    sorted_.clear();
+    for (auto it = this->window.begin(); it != this->window.end(); ++it)
+        sorted_.insert(*it);
+}
+
 // Explicit implementations
 template class Accumulator<int>;
 template class Accumulator<float>;
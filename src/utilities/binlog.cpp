@@ -0,0 +1,360 @@
+#include "utilities/binlog.h"
+#include "utilities/serialise.h"
+
+#include <chrono>
+#include <algorithm>
+#include <spdlog/fmt/fmt.h>
+
+using namespace std;
+using namespace binlog;
+
+static const char MAGIC[8] = {'R', 'L', 'B', 'L', 'O', 'G', '0', '1'};
+
+// Rows per block before the writer flushes to disk:
+static const size_t BLOCK_ROWS = 1 << 14;
+
+static atomic<uint64_t> next_log_id{1};
+
+size_t binlog::width(Type t)
+{
+    switch (t) {
+        case Type::i32: return 4;
+        case Type::chr: return 1;
+
+        default: return 8;
+    }
+}
+
+// ------------------------------------------------------------------
+Ring::Ring(size_t width, size_t capacity):
+    width_(width),
+    capacity_(max(capacity, (size_t) 1)),
+
+    data_(width_ * capacity_),
+
+    head_(0),
+    tail_(0)
+{}
+
+bool Ring::push(const Slot* record)
+{
+    size_t h = head_.load(memory_order_relaxed);
+    if (h - tail_.load(memory_order_acquire) == capacity_)
+        return false;
+
+    copy(record, record + width_, &data_[(h % capacity_) * width_]);
+    head_.store(h + 1, memory_order_release);
+
+    return true;
+}
+
+size_t Ring::drain(vector<vector<Slot>>& columns)
+{
+    size_t t = tail_.load(memory_order_relaxed),
+           h = head_.load(memory_order_acquire);
+
+    for (size_t i = t; i < h; i++) {
+        const Slot* record = &data_[(i % capacity_) * width_];
+
+        for (size_t c = 0; c < width_; c++)
+            columns[c].push_back(record[c]);
+    }
+
+    tail_.store(h, memory_order_release);
+
+    return h - t;
+}
+
+// ------------------------------------------------------------------
+mutex Log::registry_mutex_;
+map<string, shared_ptr<Log>> Log::registry_;
+
+Log::Log(const string& path, vector<Column> columns, size_t ring_capacity):
+    id_(next_log_id++),
+    columns_(std::move(columns)),
+    ring_capacity_(ring_capacity),
+
+    file_(path, ios::binary | ios::trunc),
+
+    rings_(),
+    block_(columns_.size()),
+
+    running_(true)
+{
+    if (columns_.empty())
+        throw invalid_argument("[binlog] A log needs at least one column.");
+
+    if (not file_.is_open())
+        throw runtime_error("[binlog] Failed to open log file: " + path);
+
+    file_.write(MAGIC, sizeof(MAGIC));
+
+    serialise::write(file_, (uint32_t) columns_.size());
+    for (auto& c : columns_) {
+        serialise::write(file_, c.name);
+        serialise::write(file_, (uint8_t) c.type);
+    }
+
+    for (auto& b : block_)
+        b.reserve(BLOCK_ROWS);
+
+    writer_ = thread(&Log::_run, this);
+}
+
+Log::~Log()
+{
+    running_ = false;
+    writer_.join();
+
+    _drain();
+    _flush();
+}
+
+const vector<Column>& Log::columns() const
+{
+    return columns_;
+}
+
+Ring& Log::_ring()
+{
+    // Each thread resolves its ring once per log; ids are never reused so
+    // stale entries of destroyed logs are simply never matched again.
+    thread_local vector<pair<uint64_t, Ring*>> cache;
+
+    for (auto& e : cache)
+        if (e.first == id_)
+            return *e.second;
+
+    lock_guard<mutex> lock(rings_mutex_);
+
+    rings_.emplace_back(new Ring(columns_.size(), ring_capacity_));
+    cache.emplace_back(id_, rings_.back().get());
+
+    return *rings_.back();
+}
+
+void Log::_push(const Slot* record)
+{
+    Ring& ring = _ring();
+
+    // Never drop records; wait for the writer if we get ahead of it:
+    while (not ring.push(record))
+        this_thread::yield();
+}
+
+bool Log::_drain()
+{
+    size_t n = 0;
+    {
+        lock_guard<mutex> lock(rings_mutex_);
+
+        for (auto& r : rings_)
+            n += r->drain(block_);
+    }
+
+    if (block_[0].size() >= BLOCK_ROWS)
+        _flush();
+
+    return n > 0;
+}
+
+void Log::_flush()
+{
+    uint32_t n_rows = (uint32_t) block_[0].size();
+    if (n_rows == 0)
+        return;
+
+    serialise::write(file_, n_rows);
+    for (size_t c = 0; c < columns_.size(); c++) {
+        vector<Slot>& b = block_[c];
+
+        switch (columns_[c].type) {
+            case Type::i32:
+                scratch_.resize(n_rows * 4);
+                for (size_t r = 0; r < n_rows; r++) {
+                    int32_t v = (int32_t) (int64_t) b[r];
+                    memcpy(&scratch_[r * 4], &v, 4);
+                }
+                file_.write(scratch_.data(), scratch_.size());
+
+                break;
+
+            case Type::chr:
+                scratch_.resize(n_rows);
+                for (size_t r = 0; r < n_rows; r++)
+                    scratch_[r] = (char) b[r];
+                file_.write(scratch_.data(), scratch_.size());
+
+                break;
+
+            default:
+                file_.write(reinterpret_cast<const char*>(b.data()),
+                            n_rows * sizeof(Slot));
+        }
+
+        b.clear();
+    }
+
+    file_.flush();
+}
+
+void Log::_run()
+{
+    while (running_) {
+        if (not _drain()) {
+            // Idle: make what we have visible and back off.
+            _flush();
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+}
+
+shared_ptr<Log> Log::Register(const string& name, const string& path,
+                              vector<Column> columns)
+{
+    lock_guard<mutex> lock(registry_mutex_);
+
+    auto it = registry_.find(name);
+    if (it != registry_.end())
+        return it->second;
+
+    auto log = make_shared<Log>(path, std::move(columns));
+    registry_[name] = log;
+
+    return log;
+}
+
+shared_ptr<Log> Log::Get(const string& name)
+{
+    lock_guard<mutex> lock(registry_mutex_);
+
+    auto it = registry_.find(name);
+    if (it == registry_.end())
+        return nullptr;
+
+    return it->second;
+}
+
+void Log::DropAll()
+{
+    map<string, shared_ptr<Log>> logs;
+    {
+        lock_guard<mutex> lock(registry_mutex_);
+        logs.swap(registry_);
+    }
+}
+
+// ------------------------------------------------------------------
+Reader::Reader(const string& path):
+    file_(path, ios::binary)
+{
+    if (not file_.is_open())
+        throw runtime_error("[binlog] Failed to open log file: " + path);
+
+    char magic[sizeof(MAGIC)];
+    if (not file_.read(magic, sizeof(magic)) or
+        not equal(magic, magic + sizeof(magic), MAGIC))
+        throw runtime_error("[binlog] Not a binary log: " + path);
+
+    uint32_t n_cols;
+    serialise::read(file_, n_cols);
+
+    columns_.resize(n_cols);
+    for (auto& c : columns_) {
+        uint8_t type;
+
+        serialise::read(file_, c.name);
+        serialise::read(file_, type);
+
+        c.type = (Type) type;
+    }
+}
+
+const vector<Column>& Reader::columns() const
+{
+    return columns_;
+}
+
+bool Reader::next(vector<vector<Slot>>& block)
+{
+    uint32_t n_rows;
+    if (not file_.read(reinterpret_cast<char*>(&n_rows), sizeof(n_rows)))
+        return false;
+
+    block.resize(columns_.size());
+    for (size_t c = 0; c < columns_.size(); c++) {
+        vector<Slot>& b = block[c];
+        Type t = columns_[c].type;
+
+        b.resize(n_rows);
+        scratch_.resize(n_rows * width(t));
+
+        if (not file_.read(scratch_.data(), scratch_.size()))
+            throw runtime_error("[binlog] Truncated block.");
+
+        for (size_t r = 0; r < n_rows; r++) {
+            if (t == Type::i32) {
+                int32_t v;
+                memcpy(&v, &scratch_[r * 4], 4);
+
+                b[r] = (Slot) (int64_t) v;
+
+            } else if (t == Type::chr)
+                b[r] = (Slot) scratch_[r];
+
+            else
+                memcpy(&b[r], &scratch_[r * 8], 8);
+        }
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------------
+static string format_slot(Slot s, Type t)
+{
+    switch (t) {
+        case Type::i32:
+        case Type::i64:
+            return fmt::format("{}", (int64_t) s);
+
+        case Type::f64: {
+            double v;
+            memcpy(&v, &s, sizeof(v));
+
+            return fmt::format("{}", v);
+        }
+
+        case Type::chr:
+            return string(1, (char) s);
+    }
+
+    return "";
+}
+
+void binlog::ExportCSV(const string& bin_path, const string& csv_path)
+{
+    Reader reader(bin_path);
+    const vector<Column>& columns = reader.columns();
+
+    ofstream ofs(csv_path);
+    if (not ofs.is_open())
+        throw runtime_error("[binlog] Failed to open csv file: " + csv_path);
+
+    for (size_t c = 0; c < columns.size(); c++)
+        ofs << (c > 0 ? "," : "") << columns[c].name;
+    ofs << "\n";
+
+    vector<vector<Slot>> block;
+    while (reader.next(block)) {
+        size_t n_rows = block[0].size();
+
+        for (size_t r = 0; r < n_rows; r++) {
+            for (size_t c = 0; c < columns.size(); c++)
+                ofs << (c > 0 ? "," : "")
+                    << format_slot(block[c][r], columns[c].type);
+
+            ofs << "\n";
+        }
+    }
+}
@@ -71,3 +71,14 @@ void CSV::skip(int n_lines)
         if (not hasData()) return;
     }
 }
+
+long CSV::tell()
+{
+    return fs.tellg();
+}
+
+void CSV::seek(long pos)
+{
+    fs.clear();
+    fs.seekg(pos);
+}
@@ -0,0 +1,77 @@
+#include "utilities/mapped_file.h"
+
+#include <utility>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile(const std::string& file_path)
+{
+    openFile(file_path);
+}
+
+MappedFile::~MappedFile()
+{
+    closeFile();
+}
+
+void MappedFile::openFile(const std::string& file_path)
+{
+    closeFile();
+
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("[MappedFile] Failed to open file: " + file_path);
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+
+        throw std::runtime_error("[MappedFile] Failed to stat file: " + file_path);
+    }
+
+    size_ = info.st_size;
+
+    // Empty files can't be mapped, but are valid (and empty):
+    if (size_ > 0) {
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+
+            throw std::runtime_error("[MappedFile] Failed to map file: " + file_path);
+        }
+
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+
+    close(fd);
+
+    open_ = true;
+}
+
+void MappedFile::closeFile()
+{
+    if (data_ != nullptr)
+        munmap(const_cast<char*>(data_), size_);
+
+    data_ = nullptr;
+    size_ = 0;
+
+    open_ = false;
+}
+
+bool MappedFile::isOpen() const { return open_; }
+
+const char* MappedFile::data() const { return data_; }
+size_t MappedFile::size() const { return size_; }
+
+void MappedFile::swap(MappedFile& other)
+{
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(open_, other.open_);
+}
@@ -0,0 +1,208 @@
+#include "utilities/skiplist.h"
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+template <typename T>
+IndexableSkiplist<T>::IndexableSkiplist(size_t capacity):
+    capacity_(max(capacity, (size_t) 1)),
+    max_levels_(1 + (int) floor(log2((double) capacity_))),
+
+    size_(0),
+
+    values_(capacity_ + 1),
+    levels_(capacity_ + 1, 0),
+    next_((capacity_ + 1) * max_levels_, NIL),
+    width_((capacity_ + 1) * max_levels_, 1),
+
+    free_(),
+
+    chain_(max_levels_, HEAD),
+    steps_(max_levels_, 0),
+
+    rng_state_(0x9E3779B97F4A7C15ULL)
+{
+    free_.reserve(capacity_);
+
+    clear();
+}
+
+template <typename T>
+int& IndexableSkiplist<T>::next(int node, int level)
+{
+    return next_[node*max_levels_ + level];
+}
+
+template <typename T>
+size_t& IndexableSkiplist<T>::width(int node, int level)
+{
+    return width_[node*max_levels_ + level];
+}
+
+template <typename T>
+int IndexableSkiplist<T>::random_level()
+{
+    // xorshift64: we only need a cheap, reproducible source of coin flips.
+    rng_state_ ^= rng_state_ << 13;
+    rng_state_ ^= rng_state_ >> 7;
+    rng_state_ ^= rng_state_ << 17;
+
+    uint64_t r = rng_state_;
+
+    int d = 1;
+    while (d < max_levels_ and (r & 1)) {
+        d++;
+        r >>= 1;
+    }
+
+    return d;
+}
+
+template <typename T>
+void IndexableSkiplist<T>::insert(T val)
+{
+    if (size_ == capacity_)
+        throw runtime_error("[IndexableSkiplist] Capacity exceeded.");
+
+    int node = HEAD;
+    for (int l = max_levels_-1; l >= 0; l--) {
+        steps_[l] = 0;
+
+        while (next(node, l) != NIL and values_[next(node, l)] <= val) {
+            steps_[l] += width(node, l);
+            node = next(node, l);
+        }
+
+        chain_[l] = node;
+    }
+
+    int new_node = free_.back();
+    free_.pop_back();
+
+    int d = random_level();
+
+    values_[new_node] = val;
+    levels_[new_node] = d;
+
+    size_t steps = 0;
+    for (int l = 0; l < d; l++) {
+        int prev_node = chain_[l];
+
+        next(new_node, l) = next(prev_node, l);
+        next(prev_node, l) = new_node;
+
+        width(new_node, l) = width(prev_node, l) - steps;
+        width(prev_node, l) = steps + 1;
+
+        steps += steps_[l];
+    }
+
+    for (int l = d; l < max_levels_; l++)
+        width(chain_[l], l) += 1;
+
+    size_++;
+}
+
+template <typename T>
+bool IndexableSkiplist<T>::remove(T val)
+{
+    int node = HEAD;
+    for (int l = max_levels_-1; l >= 0; l--) {
+        while (next(node, l) != NIL and values_[next(node, l)] < val)
+            node = next(node, l);
+
+        chain_[l] = node;
+    }
+
+    int target = next(chain_[0], 0);
+    if (target == NIL or values_[target] != val)
+        return false;
+
+    int d = levels_[target];
+    for (int l = 0; l < d; l++) {
+        int prev_node = chain_[l];
+
+        width(prev_node, l) += width(target, l) - 1;
+        next(prev_node, l) = next(target, l);
+    }
+
+    for (int l = d; l < max_levels_; l++)
+        width(chain_[l], l) -= 1;
+
+    free_.push_back(target);
+    size_--;
+
+    return true;
+}
+
+template <typename T>
+T IndexableSkiplist<T>::at(size_t i)
+{
+    if (i >= size_)
+        throw out_of_range("[IndexableSkiplist] Index out of range.");
+
+    int node = HEAD;
+    i += 1;
+
+    for (int l = max_levels_-1; l >= 0; l--) {
+        while (next(node, l) != NIL and width(node, l) <= i) {
+            i -= width(node, l);
+            node = next(node, l);
+        }
+    }
+
+    return values_[node];
+}
+
+template <typename T>
+T IndexableSkiplist<T>::quantile(double q)
+{
+    if (size_ == 0)
+        throw runtime_error("[IndexableSkiplist] Quantile of an empty list.");
+
+    double pos = min(max(q, 0.0), 1.0) * (size_ - 1);
+    size_t lo = (size_t) floor(pos);
+    double frac = pos - lo;
+
+    if (frac == 0.0 or lo + 1 >= size_)
+        return at(lo);
+
+    double a = at(lo),
+           b = at(lo + 1);
+
+    return T(a + frac*(b - a));
+}
+
+template <typename T>
+void IndexableSkiplist<T>::clear()
+{
+    size_ = 0;
+
+    fill(next_.begin(), next_.end(), NIL);
+    fill(width_.begin(), width_.end(), 1);
+
+    levels_[HEAD] = max_levels_;
+
+    free_.clear();
+    for (size_t n = capacity_; n >= 1; n--)
+        free_.push_back((int) n);
+}
+
+template <typename T>
+bool IndexableSkiplist<T>::empty()
+{
+    return size_ == 0;
+}
+
+template <typename T>
+size_t IndexableSkiplist<T>::size()
+{
+    return size_;
+}
+
+// Explicit implementations
+template class IndexableSkiplist<int>;
+template class IndexableSkiplist<float>;
+template class IndexableSkiplist<double>;
@@ -0,0 +1,95 @@
+#ifndef TEST_SAMPLE_DAY_H
+#define TEST_SAMPLE_DAY_H
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <fstream>
+
+// Synthetic HSBA.L data for a day (04/01/2017 by default) between two times
+// of day (ms), by default half an hour from just before the simulated open,
+// with long runs of unchanged book snapshots and trades in between them.
+// Returns the number of depth rows:
+inline long write_day(const std::string& md_path, const std::string& tas_path,
+                      long from = 30540000, long to = 32400000,
+                      const std::string& date = "20170104")
+{
+    using namespace std;
+
+    default_random_engine eng(7);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    uniform_int_distribution<long> vol(100, 2000), size(10, 300);
+
+    const long gaps[] = {0, 1, 5, 20, 50, 120, 300};
+
+    ofstream md(md_path), tas(tas_path);
+
+    md << "date,time,ap1,ap2,ap3,ap4,ap5,av1,av2,av3,av4,av5,"
+       << "bp1,bp2,bp3,bp4,bp5,bv1,bv2,bv3,bv4,bv5" << endl;
+    tas << "date,time,price,size" << endl;
+
+    long mid = 6000, spd = 1, n_rows = 0;
+    long av[5] = {900, 900, 900, 900, 900}, bv[5] = {900, 900, 900, 900, 900};
+
+    char buf[64];
+    for (long t = from; t < to; t += gaps[eng() % 7]) {
+        snprintf(buf, sizeof(buf), "%s,%02ld:%02ld:%02ld.%03ld", date.c_str(),
+                 t / 3600000, (t / 60000) % 60, (t / 1000) % 60, t % 1000);
+        string stamp(buf);
+
+        // Most rows repeat the last snapshot exactly:
+        if (u(eng) < 0.6) {
+            if (u(eng) < 0.3) mid += (u(eng) < 0.5) ? 1 : -1;
+            spd = (u(eng) < 0.75) ? 1 : 2;
+
+            if (u(eng) < 0.5) av[eng() % 5] = vol(eng);
+            if (u(eng) < 0.5) bv[eng() % 5] = vol(eng);
+        }
+
+        long ask = mid + (spd + 1) / 2, bid = ask - spd;
+
+        md << stamp;
+        for (int i = 0; i < 5; i++) md << "," << (ask + i) / 10 << "." << (ask + i) % 10;
+        for (int i = 0; i < 5; i++) md << "," << av[i];
+        for (int i = 0; i < 5; i++) md << "," << (bid - i) / 10 << "." << (bid - i) % 10;
+        for (int i = 0; i < 5; i++) md << "," << bv[i];
+        md << endl;
+
+        n_rows++;
+
+        if (u(eng) < 0.2) {
+            long price = (u(eng) < 0.5) ? ask + eng() % 3 : bid - eng() % 3;
+
+            tas << stamp << "," << price / 10 << "." << price % 10
+                << "," << size(eng) << endl;
+        }
+    }
+
+    return n_rows;
+}
+
+
+// An environment config for the sample day, with the given data options:
+inline void write_config(const std::string& path, const std::string& data,
+                         const std::string& target_price = "midprice")
+{
+    using namespace std;
+
+    ofstream ofs(path);
+
+    ofs << "debug: {random_seed: 1}" << endl
+        << "policy: {spread_lookback: 45}" << endl
+        << "reward: {measure: pnl_damped, damping_factor: 0.15}" << endl
+        << "state:" << endl
+        << "    variables: [pos, spd, mpm, imb, vol]" << endl
+        << "    lookback: {mpm: 15, vlt: 60, svl: 60}" << endl
+        << "data: {" << data << "}" << endl
+        << "market:" << endl
+        << "    pos_lb: -50" << endl
+        << "    pos_ub: 50" << endl
+        << "    order_size: 10" << endl
+        << "    target_price: {type: " << target_price << ", lookback: 1}" << endl
+        << "    latency: {type: fixed}" << endl;
+}
+
+#endif
@@ -1,6 +1,10 @@
 #include "catch.hpp"
 #include "utilities/accumulators.h"
 
+#include <deque>
+#include <vector>
+#include <algorithm>
+
 using namespace std;
 
 SCENARIO("a sequence of values 1:1:5", "[Accumulator][RollingMedian]") {
@@ -68,3 +72,82 @@ SCENARIO("a sequence of values 10.5, 11.5, 11.5, 11.5, 12.5", "[Accumulator][Rol
         }
     }
 }
+
+SCENARIO("a long pseudo-random sequence with repeated values", "[Accumulator][RollingMedian]") {
+
+    GIVEN("a rolling median with window size 1000") {
+        const size_t W = 1000;
+
+        RollingMedian<double> rm(W);
+        deque<double> window;
+
+        unsigned int seed = 42;
+        for (int i = 0; i < 5000; i++) {
+            seed = 1103515245*seed + 12345;
+            double val = (double) ((seed >> 16) % 200) / 4.0;
+
+            rm.push(val);
+
+            window.push_front(val);
+            if (window.size() > W) window.pop_back();
+        }
+
+        vector<double> sorted(window.begin(), window.end());
+        sort(sorted.begin(), sorted.end());
+
+        THEN("the order statistics should match a full sort") {
+            REQUIRE(rm.size() == W);
+            REQUIRE(rm.min() == Approx(sorted.front()));
+            REQUIRE(rm.max() == Approx(sorted.back()));
+            REQUIRE(rm.median() ==
+                    Approx((sorted[W/2 - 1] + sorted[W/2]) / 2.0));
+
+            double pos = 0.25 * (W - 1);
+            size_t lo = (size_t) pos;
+            double q1 = sorted[lo] + (pos - lo)*(sorted[lo+1] - sorted[lo]);
+
+            pos = 0.75 * (W - 1);
+            lo = (size_t) pos;
+            double q3 = sorted[lo] + (pos - lo)*(sorted[lo+1] - sorted[lo]);
+
+            REQUIRE(rm.quartile(0.25) == Approx(q1));
+            REQUIRE(rm.quartile(0.75) == Approx(q3));
+            REQUIRE(rm.iqr() == Approx(q3 - q1));
+        }
+
+        WHEN("the window is cleared") {
+            rm.clear();
+            rm.push(7.0);
+
+            THEN("only the new value remains") {
+                REQUIRE(rm.size() == 1);
+                REQUIRE(rm.median() == Approx(7.0));
+            }
+        }
+    }
+}
+
+SCENARIO("clearing an accumulator resets its running statistics", "[Accumulator][RollingMean]") {
+
+    GIVEN("a rolling mean that has seen some values") {
+        RollingMean<double> rm(3);
+
+        rm.push(10.0);
+        rm.push(20.0);
+        rm.push(30.0);
+
+        WHEN("it is cleared and refilled") {
+            rm.clear();
+
+            rm.push(1.0);
+            rm.push(2.0);
+            rm.push(3.0);
+
+            THEN("no state from before the clear remains") {
+                REQUIRE(rm.sum() == Approx(6.0));
+                REQUIRE(rm.mean() == Approx(2.0));
+                REQUIRE(rm.var() == Approx(1.0));
+            }
+        }
+    }
+}
@@ -0,0 +1,538 @@
+#include "catch.hpp"
+#include "rl/agent.h"
+#include "utilities/turnstile.h"
+
+#include <set>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <functional>
+
+using namespace std;
+using namespace rl;
+
+// With further learning options, as "key: value, ...":
+static Config config(long memory_size, const string& options,
+                     bool random_init = true)
+{
+    return Config(YAML::Load(
+        "learning: {memory_size: " + to_string(memory_size) + ", "
+        "n_tilings: 32, n_actions: 9, gamma: 0.97, lambda: 0.85, "
+        "alpha_start: 0.01, random_init: " +
+        (random_init ? "true, " : "false, ") + options + "}\n"
+        "debug: {random_seed: 1}\n"));
+}
+
+static unique_ptr<Policy> greedy()
+{
+    return unique_ptr<Policy>(new Greedy(9, 1));
+}
+
+// The states of one fixed transition, coded for the given config:
+struct Transition
+{
+    State from, to;
+
+    Transition(Config& c):
+        from(c), to(c)
+    {
+        vector<float> vars {0.3f, -1.7f, 2.25f, 5.1f, -0.05f, 7.0f, 0.5f, 1.5f},
+                      next {1.2f, 0.4f, -3.0f, 2.5f, 0.75f, 6.0f, -0.5f, 1.0f};
+
+        from.newState(vars);
+        to.newState(next, 0.0);
+    }
+};
+
+// Exposes the memoised Q of every action:
+class MemoQLearn: public QLearn
+{
+    public:
+        using QLearn::QLearn;
+        using Agent::allQ;
+};
+
+// Random actions, recording every one drawn:
+class Recording: public Random
+{
+    public:
+        vector<unsigned int> drawn;
+
+        Recording(): Random(9, 3) {}
+
+        unsigned int Sample(vector<double>& qs)
+        {
+            drawn.push_back(Random::Sample(qs));
+
+            return drawn.back();
+        }
+};
+
+SCENARIO("memoised Q values", "[Agent]") {
+
+    Config c = config(1000003, "weight_layout: action_major");
+
+    MemoQLearn agent(greedy(), c);
+    Transition t(c);
+
+    vector<double> before(agent.allQ(t.from), agent.allQ(t.from) + 9);
+
+    THEN("they are those of a fresh evaluation") {
+        Transition fresh(c);
+
+        for (int a = 0; a < 9; a++) {
+            REQUIRE(agent.getQ(t.from, a) == before[a]);
+            REQUIRE(agent.getQ(fresh.from, a) == Approx(before[a]));
+        }
+    }
+
+    THEN("they are recomputed once the weights are updated") {
+        agent.HandleTransition(t.from, 2, 1.0, t.to);
+
+        const double* q = agent.allQ(t.from);
+        REQUIRE(q[2] != before[2]);
+
+        Transition fresh(c);
+        for (int a = 0; a < 9; a++) {
+            REQUIRE(agent.getQ(t.from, a) == q[a]);
+            REQUIRE(agent.getQ(fresh.from, a) == Approx(q[a]));
+        }
+    }
+}
+
+SCENARIO("on-policy bootstrapping", "[Agent]") {
+
+    Config c = config(1000003, "beta: 0.01");
+
+    // The action bootstrapped from is the next one taken, and only that:
+    auto check = [&](Agent& agent, Recording& policy) {
+        Transition t(c);
+
+        agent.HandleTransition(t.from, 0, 0.5, t.to);
+        REQUIRE(policy.drawn.size() == 1);
+
+        REQUIRE(agent.action(t.to) == policy.drawn[0]);
+        REQUIRE(policy.drawn.size() == 1);
+
+        agent.action(t.to);
+        REQUIRE(policy.drawn.size() == 2);
+    };
+
+    THEN("SARSA takes the action it bootstrapped from") {
+        Recording* policy = new Recording();
+        SARSA agent(unique_ptr<Policy>(policy), c);
+
+        check(agent, *policy);
+    }
+
+    THEN("online R-learning takes the action it bootstrapped from") {
+        Recording* policy = new Recording();
+        OnlineRLearn agent(unique_ptr<Policy>(policy), c);
+
+        check(agent, *policy);
+    }
+}
+
+SCENARIO("greedy ties", "[Agent]") {
+
+    THEN("the policy breaks them from its own seed") {
+        vector<double> qs(9, 0.5);
+        Greedy a(9, 5), b(9, 5);
+
+        set<unsigned int> seen;
+        for (int i = 0; i < 200; i++) {
+            unsigned int action = a.Sample(qs);
+            seen.insert(action);
+
+            srand(i);
+            REQUIRE(b.Sample(qs) == action);
+        }
+
+        REQUIRE(seen.size() == 9);
+    }
+
+    THEN("the agent breaks them from its own seed") {
+        Config c = config(1000003, "", false);
+        Transition t(c);
+
+        QLearn a(greedy(), c), b(greedy(), c);
+
+        set<int> seen;
+        for (int i = 0; i < 200; i++) {
+            int action = a.argmaxQ(t.from);
+            seen.insert(action);
+
+            srand(i);
+            REQUIRE(b.argmaxQ(t.from) == action);
+        }
+
+        REQUIRE(seen.size() == 9);
+    }
+}
+
+SCENARIO("action-major weights", "[Agent]") {
+
+    Config ch = config(1000003, "weight_layout: hashed"),
+           cm = config(1000003, "weight_layout: action_major");
+
+    Transition th(ch), tm(cm);
+    State &hashed = th.from, &major = tm.from;
+
+    THEN("the weights of a tile are side by side for all actions") {
+        for (int i = 0; i < major.nFeatures(); i++) {
+            REQUIRE(major.getFeatures(0)[i] % 9 == 0);
+            REQUIRE(major.getFeatures(0)[i] < 1000003);
+
+            for (int a = 1; a < 9; a++)
+                REQUIRE(major.getFeatures(a)[i] ==
+                        major.getFeatures(0)[i] + a);
+        }
+    }
+
+    THEN("imported weights give the same values") {
+        QLearn from(greedy(), ch), to(greedy(), cm);
+
+        to.ImportWeights(major, from, hashed);
+
+        for (int a = 0; a < 9; a++)
+            REQUIRE(to.getQ(major, a) == Approx(from.getQ(hashed, a)));
+    }
+}
+
+SCENARIO("interleaved double weights", "[Agent]") {
+
+    Config cs = config(1000003, "interleave_weights: false"),
+           ci = config(1000003, "interleave_weights: true");
+
+    DoubleQLearn split(greedy(), cs), interleaved(greedy(), ci);
+
+    Transition ts(cs), ti(ci);
+
+    THEN("both layouts learn the same values") {
+        for (int n = 0; n < 10; n++) {
+            split.HandleTransition(ts.from, n % 9, 0.5, ts.to);
+            interleaved.HandleTransition(ti.from, n % 9, 0.5, ti.to);
+        }
+
+        for (int a = 0; a < 9; a++) {
+            REQUIRE(interleaved.getQ(ti.from, a) == split.getQ(ts.from, a));
+            REQUIRE(interleaved.getQb(ti.from, a) == split.getQb(ts.from, a));
+        }
+    }
+}
+
+SCENARIO("reduced-precision weights", "[Agent]") {
+
+    GIVEN("bf16 values") {
+        THEN("they are floats rounded to 8 bits, ties to even") {
+            REQUIRE((float) bf16(1.0f) == 1.0f);
+            REQUIRE((float) bf16(-0.5f) == -0.5f);
+            REQUIRE((float) bf16(1.00390625f) == 1.0f);
+            REQUIRE((float) bf16(1.01171875f) == 1.015625f);
+            REQUIRE((float) bf16(1.005f) == 1.0078125f);
+        }
+    }
+
+    // The same transition, many times over:
+    auto learn = [&](const string& options) {
+        Config c = config(1000003, options);
+        QLearn agent(greedy(), c);
+
+        Transition t(c);
+        for (int n = 0; n < 500; n++)
+            agent.HandleTransition(t.from, n % 9, 0.02, t.to);
+
+        vector<double> q;
+        for (int a = 0; a < 9; a++)
+            q.push_back(agent.getQ(t.from, a));
+
+        return q;
+    };
+
+    vector<double> exact = learn("weight_type: double");
+
+    THEN("float weights learn the values of doubles") {
+        vector<double> q = learn("weight_type: float");
+
+        for (int a = 0; a < 9; a++)
+            REQUIRE(q[a] == Approx(exact[a]).margin(1e-5));
+    }
+
+    THEN("compensation keeps the updates that bf16 would lose") {
+        vector<double> lossy = learn("weight_type: bf16"),
+                       compensated = learn("weight_type: bf16, "
+                                           "compensated_updates: true");
+
+        double e_lossy = 0.0, e_compensated = 0.0;
+        for (int a = 0; a < 9; a++) {
+            e_lossy += abs(lossy[a] - exact[a]);
+            e_compensated += abs(compensated[a] - exact[a]);
+        }
+
+        REQUIRE(e_compensated < e_lossy / 4);
+    }
+}
+
+SCENARIO("sparse weights", "[Agent]") {
+
+    Config cd = config(1000003, "weight_store: dense", false),
+           cs = config(1000003, "weight_store: sparse", false);
+
+    QLearn dense(greedy(), cd), sparse(greedy(), cs);
+
+    Transition td(cd), ts(cs);
+    for (int n = 0; n < 20; n++) {
+        dense.HandleTransition(td.from, n % 9, 0.5, td.to);
+        sparse.HandleTransition(ts.from, n % 9, 0.5, ts.to);
+    }
+
+    THEN("they learn the values of dense weights") {
+        for (int a = 0; a < 9; a++)
+            REQUIRE(sparse.getQ(ts.from, a) == dense.getQ(td.from, a));
+    }
+
+    THEN("they are saved as the weights of the tiles held") {
+        const string path = "/tmp/rl_markets_test_sparse.bin";
+        sparse.write_theta(path);
+
+        QLearn loaded(greedy(), cd);
+        loaded.read_theta(path);
+
+        for (int a = 0; a < 9; a++)
+            REQUIRE(loaded.getQ(td.from, a) == dense.getQ(td.from, a));
+
+        remove(path.c_str());
+    }
+
+    THEN("their hash space is limited to int features") {
+        Config cl = config(1L << 31, "weight_store: sparse", false);
+
+        REQUIRE_THROWS(State(cl));
+        REQUIRE_THROWS(QLearn(greedy(), cl));
+        REQUIRE_THROWS(Weights(Weights::Type::DOUBLE, 1L << 31, 1, false,
+                               false, true));
+    }
+
+    GIVEN("random initial weights") {
+        Config cr = config(1000003, "weight_store: sparse");
+        QLearn agent(greedy(), cr);
+
+        Transition t(cr);
+
+        THEN("untouched weights are fixed") {
+            double q = agent.getQ(t.from, 0);
+
+            REQUIRE(q != 0.0);
+            REQUIRE(abs(q) <= 1.0);
+            REQUIRE(agent.getQ(t.from, 0) == q);
+        }
+    }
+}
+
+SCENARIO("saved double weights", "[Agent]") {
+
+    Config c = config(1000003, "weight_layout: hashed");
+    Transition t(c);
+
+    DoubleQLearn agent(greedy(), c);
+    for (int n = 0; n < 20; n++)
+        agent.HandleTransition(t.from, n % 9, 0.5, t.to);
+
+    const string path = "/tmp/rl_markets_test_double.bin";
+    agent.write_theta(path);
+
+    Config cl = config(1000003, "weight_layout: hashed");
+    cl["debug"]["random_seed"] = 2;
+
+    DoubleQLearn loaded(greedy(), cl);
+
+    THEN("both sets are read back") {
+        // Memoised under the weights they start with:
+        for (int a = 0; a < 9; a++) loaded.getQb(t.from, a);
+
+        loaded.read_theta(path);
+
+        for (int a = 0; a < 9; a++) {
+            REQUIRE(loaded.getQ(t.from, a) == agent.getQ(t.from, a));
+            REQUIRE(loaded.getQb(t.from, a) == agent.getQb(t.from, a));
+        }
+    }
+
+    THEN("theta_b starts from theta without its own file") {
+        remove((path + ".b").c_str());
+        loaded.read_theta(path);
+
+        for (int a = 0; a < 9; a++)
+            REQUIRE(loaded.getQb(t.from, a) == agent.getQ(t.from, a));
+    }
+
+    remove(path.c_str());
+    remove((path + ".b").c_str());
+}
+
+// Learning steps from one state to the next of a cycle, each rewarded the
+// same, with a hook after each step:
+static void run_steps(Agent& agent, Config& c, vector<vector<float>>& states,
+                      int n_steps, double reward,
+                      const function<void()>& after_step = []() {})
+{
+    State s1(c), s2(c);
+    State *from = &s1, *to = &s2;
+    from->newState(states[0]);
+
+    for (int n = 1; n <= n_steps; n++) {
+        int a = agent.action(*from);
+
+        to->newState(states[n % states.size()], 0.0);
+        agent.HandleTransition(*from, a, reward, *to);
+
+        swap(from, to);
+
+        after_step();
+    }
+}
+
+static vector<vector<float>> random_states(unsigned seed, int n)
+{
+    mt19937 rng(seed);
+    normal_distribution<float> var(0.0f, 3.0f);
+
+    vector<vector<float>> states(n, vector<float>(8));
+    for (auto& s : states)
+        for (auto& v : s) v = var(rng);
+
+    return states;
+}
+
+// Learning steps of n forks of an agent at once, each on its own states;
+// with a turnstile, they take their steps in turn:
+static void learn_in_threads(Agent& agent, Config& c, int n_threads,
+                             int n_steps, Turnstile* turnstile = nullptr)
+{
+    vector<thread> threads;
+    for (int id = 0; id < n_threads; id++) {
+        threads.emplace_back([&, id]() {
+            unique_ptr<Agent> fork = agent.Fork(greedy(), id);
+            vector<vector<float>> states = random_states(id, 1000);
+
+            if (turnstile == nullptr) {
+                run_steps(*fork, c, states, n_steps, 0.01 * (id + 1));
+
+                return;
+            }
+
+            turnstile->Wait(id);
+            run_steps(*fork, c, states, n_steps, 0.01 * (id + 1),
+                      [&]() { turnstile->Next(id); });
+            turnstile->Leave(id);
+        });
+    }
+
+    for (auto& t : threads) t.join();
+}
+
+SCENARIO("forked learners", "[Agent]") {
+
+    Config c = config(1000003, "weight_layout: hashed");
+    Transition t(c);
+
+    THEN("forks update the weights of their agent") {
+        QLearn agent(greedy(), c);
+
+        double q = agent.getQ(t.from, 0);
+
+        unique_ptr<Agent> fork = agent.Fork(greedy(), 1);
+        fork->HandleTransition(t.from, 0, 1.0, t.to);
+
+        REQUIRE(agent.getQ(t.from, 0) != q);
+        REQUIRE(agent.getQ(t.from, 0) == fork->getQ(t.from, 0));
+    }
+
+    THEN("threads that take turns learn the same weights every time") {
+        vector<double> q[2];
+
+        for (int run = 0; run < 2; run++) {
+            DoubleQLearn agent(greedy(), c);
+
+            Turnstile turnstile(4);
+            learn_in_threads(agent, c, 4, 500, &turnstile);
+
+            for (int a = 0; a < 9; a++)
+                q[run].push_back(agent.getQ(t.from, a));
+        }
+
+        REQUIRE(q[0] == q[1]);
+    }
+
+    THEN("sparse weights cannot be forked") {
+        Config cs = config(1000003, "weight_store: sparse");
+        QLearn agent(greedy(), cs);
+
+        REQUIRE_THROWS(agent.Fork(greedy(), 1));
+    }
+}
+
+template<class T>
+static void time_steps(const string& name, Config& c,
+                       vector<vector<float>>& states)
+{
+    const int N = 100000;
+
+    T agent(greedy(), c);
+
+    auto start = chrono::steady_clock::now();
+    run_steps(agent, c, states, N, 0.01);
+    chrono::duration<double> dt = chrono::steady_clock::now() - start;
+
+    cout << name << ": " << N / dt.count() << " steps/s" << endl;
+}
+
+// Hidden; run with "[benchmark]":
+TEST_CASE("learning step throughput", "[.][benchmark][Agent]") {
+
+    vector<vector<float>> states = random_states(7, 1000);
+
+    for (string layout : {"hashed", "action_major"}) {
+        Config c = config(20000000, "weight_layout: " + layout);
+        time_steps<QLearn>(layout, c, states);
+    }
+
+    for (string interleave : {"false", "true"}) {
+        Config c = config(20000000, "interleave_weights: " + interleave);
+        time_steps<DoubleQLearn>(
+            "double_q_learn, interleaved: " + interleave, c, states);
+    }
+
+    Config cs = config(20000000, "weight_store: sparse");
+    time_steps<QLearn>("sparse weights", cs, states);
+
+    // Hogwild, on 1 to (at least) 2 threads:
+    int max_threads = max(2u, thread::hardware_concurrency());
+    for (int n = 1; n <= max_threads; n *= 2) {
+        Config c = config(20000000, "weight_layout: action_major");
+        QLearn agent(greedy(), c);
+
+        const int N = 50000;
+
+        auto start = chrono::steady_clock::now();
+        learn_in_threads(agent, c, n, N);
+        chrono::duration<double> dt = chrono::steady_clock::now() - start;
+
+        cout << n << " threads: " << n * N / dt.count() << " steps/s" << endl;
+    }
+
+    for (string type : {"double", "float", "bf16"}) {
+        for (string compensated : {"false", "true"}) {
+            if (type == "double" and compensated == "true") continue;
+
+            Config c = config(20000000, "weight_type: " + type + ", "
+                              "compensated_updates: " + compensated);
+            time_steps<QLearn>(
+                type + " weights, compensated: " + compensated, c, states);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#include "catch.hpp"
+#include "utilities/binlog.h"
+
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+SCENARIO("records appended from several threads", "[binlog]") {
+
+    const string path = "/tmp/rl_markets_test_binlog.bin";
+    const int n_threads = 4, n_records = 50000;
+
+    GIVEN("a log with one column of each type") {
+        {
+            binlog::Log log(path, {{"thread", binlog::Type::i32},
+                                   {"index", binlog::Type::i64},
+                                   {"value", binlog::Type::f64},
+                                   {"side", binlog::Type::chr}},
+                            256);
+
+            vector<thread> threads;
+            for (int t = 0; t < n_threads; t++)
+                threads.emplace_back([&log, t, n_records]() {
+                    for (long i = 0; i < n_records; i++)
+                        log.append(t, i, i / 4.0, (i % 2) ? 'a' : 'b');
+                });
+
+            for (auto& t : threads) t.join();
+
+            REQUIRE_THROWS(log.append(1, 2L));
+        }
+
+        THEN("the reader sees every record in per-thread order") {
+            binlog::Reader reader(path);
+
+            REQUIRE(reader.columns().size() == 4);
+            REQUIRE(reader.columns()[2].name == "value");
+
+            vector<long> next(n_threads, 0);
+            vector<vector<binlog::Slot>> block;
+
+            long n_mismatched = 0;
+            while (reader.next(block)) {
+                for (size_t r = 0; r < block[0].size(); r++) {
+                    int t = (int) (int64_t) block[0][r];
+                    long i = (long) (int64_t) block[1][r];
+
+                    double v;
+                    memcpy(&v, &block[2][r], sizeof(v));
+
+                    if (i != next[t]++ or v != i / 4.0 or
+                        (char) block[3][r] != ((i % 2) ? 'a' : 'b'))
+                        n_mismatched++;
+                }
+            }
+
+            REQUIRE(n_mismatched == 0);
+            for (int t = 0; t < n_threads; t++)
+                REQUIRE(next[t] == n_records);
+        }
+
+        THEN("it exports to csv") {
+            binlog::ExportCSV(path, path + ".csv");
+
+            ifstream ifs(path + ".csv");
+            string header, first;
+            getline(ifs, header);
+            getline(ifs, first);
+
+            REQUIRE(header == "thread,index,value,side");
+            REQUIRE(first.substr(first.find(',') + 1) == "0,0,b");
+
+            long n_lines = 2 + count(istreambuf_iterator<char>(ifs),
+                                     istreambuf_iterator<char>(), '\n');
+            REQUIRE(n_lines == n_threads * n_records + 1);
+
+            remove((path + ".csv").c_str());
+        }
+    }
+
+    remove(path.c_str());
+}
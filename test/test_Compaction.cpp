@@ -0,0 +1,177 @@
+#include "catch.hpp"
+#include "data/basic.h"
+#include "utilities/config.h"
+#include "environment/intraday.h"
+
+#include "sample_day.h"
+
+#include <tuple>
+#include <vector>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <fstream>
+#include <functional>
+#include <unistd.h>
+
+using namespace std;
+
+typedef tuple<double, double, int> Outcome;
+
+static Outcome run_episode(environment::Intraday<>& env,
+                           const function<int(int)>& policy)
+{
+    for (int i = 0; not env.isTerminal(); i++)
+        if (not env.performAction(policy(i)))
+            break;
+
+    return make_tuple(env.getEpisodePnL(), env.getEpisodeReward(),
+                      env.getTotalTransactions());
+}
+
+static Outcome run_day(const string& dir, bool compact,
+                       const string& md_path, const string& tas_path)
+{
+    string config_path = dir + "/config.yaml";
+    write_config(config_path,
+                 string("compact: ") + (compact ? "true" : "false"));
+
+    Config c(config_path);
+    environment::Intraday<> env(c, "HSBA.L", md_path, tas_path);
+
+    env.Initialise();
+
+    // A fixed action sequence that keeps quoting, crossing and flattening:
+    return run_episode(env, [](int i) { return (i * 5) % 9; });
+}
+
+// Tells whether an episode is jumping through a completed event index:
+class IndexedDay: public environment::Intraday<>
+{
+    public:
+        using environment::Intraday<>::Intraday;
+
+        bool jumping() const { return index_ != nullptr; }
+};
+
+// Repeated episodes over the same day; with the index on, the first builds
+// it and the rest jump through it:
+static vector<Outcome> run_episodes(const string& dir, bool indexed,
+                                    const string& md_path,
+                                    const string& tas_path,
+                                    int n_episodes)
+{
+    environment::EventIndexCache::Global().Clear();
+
+    string config_path = dir + "/config.yaml";
+    write_config(config_path,
+                 string("event_index: ") + (indexed ? "true" : "false"),
+                 "book");
+
+    Config c(config_path);
+    IndexedDay env(c, "HSBA.L", md_path, tas_path);
+
+    // Mostly quoting behind the visible book, where quotes are out of reach
+    // and the decision intervals can be skipped:
+    auto policy = [](int i) { return (i % 7 == 0) ? (i * 5) % 9 : 8; };
+
+    vector<Outcome> outcomes;
+    for (int e = 0; e < n_episodes; e++) {
+        if (e > 0) env.LoadData("HSBA.L", md_path, tas_path);
+
+        env.Initialise();
+        REQUIRE(env.jumping() == (indexed and e > 0));
+
+        outcomes.push_back(run_episode(env, policy));
+    }
+
+    return outcomes;
+}
+
+SCENARIO("a sample day replayed with no-op compaction", "[Compaction]") {
+
+    char tmpl[] = "/tmp/rl_compactionXXXXXX";
+    string dir(mkdtemp(tmpl));
+
+    string md_path = dir + "/md_20170104.csv",
+           tas_path = dir + "/tas_20170104.csv",
+           compact_path = dir + "/md_compact.csv";
+
+    long n_rows = write_day(md_path, tas_path);
+    long n_compact = data::basic::CompactCSV(md_path, compact_path);
+
+    GIVEN("the offline compacted depth file") {
+        THEN("it has fewer rows") {
+            REQUIRE(n_compact > 0);
+            REQUIRE(n_compact < n_rows * 3 / 4);
+        }
+
+        THEN("it streams the same records as the original") {
+            data::basic::MarketDepth a(md_path), b(compact_path);
+
+            long n = 0;
+            while (a.LoadNext()) {
+                REQUIRE(b.LoadNext());
+
+                REQUIRE(a.Record().time == b.Record().time);
+                REQUIRE(a.Record().ask_volumes == b.Record().ask_volumes);
+                REQUIRE(a.Record().bid_prices == b.Record().bid_prices);
+
+                n++;
+            }
+
+            REQUIRE(not b.LoadNext());
+            REQUIRE(n == n_rows - 1);
+        }
+    }
+
+    GIVEN("the same actions over the day") {
+        auto reference = run_day(dir, false, md_path, tas_path);
+
+        THEN("the agent trades") {
+            REQUIRE(get<2>(reference) > 0);
+        }
+
+        THEN("compaction leaves PnL and reward unchanged") {
+            REQUIRE(run_day(dir, true, md_path, tas_path) == reference);
+            REQUIRE(run_day(dir, true, compact_path, tas_path) == reference);
+            REQUIRE(run_day(dir, false, compact_path, tas_path) == reference);
+        }
+    }
+
+    remove(md_path.c_str());
+    remove(tas_path.c_str());
+    remove(compact_path.c_str());
+    remove((dir + "/config.yaml").c_str());
+    rmdir(dir.c_str());
+}
+
+SCENARIO("a sample day replayed through the event index", "[EventIndex]") {
+
+    char tmpl[] = "/tmp/rl_event_indexXXXXXX";
+    string dir(mkdtemp(tmpl));
+
+    string md_path = dir + "/md_20170104.csv",
+           tas_path = dir + "/tas_20170104.csv";
+
+    write_day(md_path, tas_path);
+
+    GIVEN("the same actions over three episodes of the day") {
+        auto reference = run_episodes(dir, false, md_path, tas_path, 3);
+
+        THEN("the agent trades") {
+            REQUIRE(get<2>(reference[0]) > 0);
+        }
+
+        THEN("jumping leaves PnL, reward and transactions unchanged") {
+            REQUIRE(run_episodes(dir, true, md_path, tas_path, 3) == reference);
+        }
+    }
+
+    environment::EventIndexCache::Global().Clear();
+
+    remove(md_path.c_str());
+    remove(tas_path.c_str());
+    remove((dir + "/config.yaml").c_str());
+    rmdir(dir.c_str());
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "data/basic.h"
+#include "data/downsampled.h"
+#include "utilities/time.h"
+
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+
+// A depth row whose best ask is the given price (in tenths), with the rest
+// of the book stacked a tick apart on either side of the spread:
+static void write_depth(ofstream& md, const string& time, long ask)
+{
+    md << "20170104," << time;
+    for (int i = 0; i < 5; i++) md << "," << (ask + i) / 10 << "." << (ask + i) % 10;
+    for (int i = 0; i < 5; i++) md << "," << 100 * (i + 1);
+    for (int i = 1; i < 6; i++) md << "," << (ask - i) / 10 << "." << (ask - i) % 10;
+    for (int i = 0; i < 5; i++) md << "," << 100 * (i + 1);
+    md << endl;
+}
+
+SCENARIO("a replay downsampled to one second buckets", "[Downsampled]") {
+
+    char tmpl[] = "/tmp/rl_downsampledXXXXXX";
+    string dir(mkdtemp(tmpl));
+
+    string md_path = dir + "/md_20170104.csv",
+           tas_path = dir + "/tas_20170104.csv";
+
+    {
+        ofstream md(md_path), tas(tas_path);
+
+        md << "date,time,ap1,ap2,ap3,ap4,ap5,av1,av2,av3,av4,av5,"
+           << "bp1,bp2,bp3,bp4,bp5,bv1,bv2,bv3,bv4,bv5" << endl;
+        write_depth(md, "08:00:00.100", 6001);
+        write_depth(md, "08:00:00.900", 6002);
+        write_depth(md, "08:00:01.500", 6003);
+        write_depth(md, "08:00:03.200", 6004);
+        write_depth(md, "08:00:03.999", 6005);
+
+        tas << "date,time,price,size" << endl
+            << "20170104,08:00:00.100,600.1,100" << endl
+            << "20170104,08:00:00.500,600.1,50" << endl
+            << "20170104,08:00:00.700,600.2,10" << endl
+            << "20170104,08:00:02.100,600.0,5" << endl
+            << "20170104,08:00:02.100,600.0,7" << endl;
+    }
+
+    GIVEN("the market depth") {
+        data::Downsampled<data::basic::MarketDepth> md(1000);
+        md.LoadCSV(md_path);
+
+        THEN("each bucket holds its last book, stamped with its end") {
+            REQUIRE(md.LoadNext());
+            REQUIRE(md.Record().time == string_to_time("08:00:01"));
+            REQUIRE(md.Record().ask_prices[0] == Approx(600.2));
+            REQUIRE(md.Record().bid_prices[0] == Approx(600.1));
+
+            REQUIRE(md.LoadNext());
+            REQUIRE(md.Record().time == string_to_time("08:00:02"));
+            REQUIRE(md.Record().ask_prices[0] == Approx(600.3));
+
+            // Buckets without any records are skipped:
+            REQUIRE(not md.LoadNext());
+            REQUIRE(md.Record().time == string_to_time("08:00:04"));
+            REQUIRE(md.Record().ask_prices[0] == Approx(600.5));
+            REQUIRE(md.Record().ask_volumes[4] == 500);
+        }
+    }
+
+    GIVEN("the time and sales") {
+        data::Downsampled<data::basic::TimeAndSales> tas(1000);
+        tas.LoadCSV(tas_path);
+
+        THEN("each bucket sums the volume traded at each price") {
+            REQUIRE(tas.LoadNext());
+            REQUIRE(tas.Record().time == string_to_time("08:00:01"));
+            REQUIRE(tas.Record().transactions.size() == 2);
+            REQUIRE(tas.Record().transactions.at(600.1) == 150);
+            REQUIRE(tas.Record().transactions.at(600.2) == 10);
+
+            REQUIRE(not tas.LoadNext());
+            REQUIRE(tas.Record().time == string_to_time("08:00:03"));
+            REQUIRE(tas.Record().transactions.size() == 1);
+            REQUIRE(tas.Record().transactions.at(600.0) == 12);
+        }
+    }
+
+    remove(md_path.c_str());
+    remove(tas_path.c_str());
+    rmdir(dir.c_str());
+}
@@ -0,0 +1,199 @@
+#include "catch.hpp"
+#include "data/itch.h"
+
+#include <cstdio>
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace data::itch;
+
+// Messages are timed in ms after 08:00, in ns since midnight:
+static const long T = 28800000;
+
+static long ns(long ms) { return (T + ms) * 1000000; }
+
+// Builds a message field by field, big-endian:
+struct Message
+{
+    string bytes;
+
+    Message(char type, uint16_t locate, long ms)
+    {
+        c(type).u(locate, 2).u(0, 2).u(ns(ms), 6);
+    }
+
+    Message& c(char v) { bytes += v; return *this; }
+    Message& u(uint64_t v, int n)
+    {
+        for (int i = n - 1; i >= 0; i--) bytes += (char) ((v >> (8 * i)) & 0xFF);
+        return *this;
+    }
+    Message& s(string v) { v.resize(8, ' '); bytes += v; return *this; }
+};
+
+static void write(ofstream& ofs, const Message& m)
+{
+    ofs.put((char) (m.bytes.size() >> 8)).put((char) (m.bytes.size() & 0xFF));
+    ofs << m.bytes;
+}
+
+static Message add(uint16_t locate, long ms, uint64_t ref, char side,
+                   uint32_t shares, string stock, uint32_t price)
+{
+    Message m('A', locate, ms);
+    m.u(ref, 8).c(side).u(shares, 4).s(stock).u(price, 4);
+
+    return m;
+}
+
+SCENARIO("binary market-by-order feeds", "[ITCH]") {
+
+    char tmpl[] = "/tmp/rl_itchXXXXXX";
+    string dir(mkdtemp(tmpl));
+    string path = dir + "/HSBA.L/md_20170103.itch";
+
+    mkdir((dir + "/HSBA.L").c_str(), 0755);
+
+    {
+        ofstream ofs(path, ios::binary);
+
+        Message r('R', 7, 0);
+        r.s("HSBA");
+        write(ofs, r);
+
+        // Another stock, which is never decoded:
+        write(ofs, add(9, 0, 100, 'B', 1000, "BARC", 2000000));
+
+        // Five levels on each side, one order per level:
+        for (int l = 0; l < 5; l++) {
+            write(ofs, add(7, l, 1 + l, 'B', 100 * (l + 1), "HSBA", 5999000 - 1000 * l));
+            write(ofs, add(7, l, 6 + l, 'S', 100 * (l + 1), "HSBA", 6001000 + 1000 * l));
+        }
+
+        // Beyond the visible levels:
+        write(ofs, add(7, 10, 11, 'B', 700, "HSBA", 5990000));
+
+        // Executions with the same time stamp; one at the order's price, one
+        // with an explicit (printable) price:
+        Message e('E', 7, 1000);
+        e.u(6, 8).u(40, 4).u(1, 8);
+        write(ofs, e);
+
+        Message c('C', 7, 1000);
+        c.u(1, 8).u(10, 4).u(2, 8).c('Y').u(5999000, 4);
+        write(ofs, c);
+
+        // An order of the other stock with the same reference:
+        Message other('E', 9, 1100);
+        other.u(1, 8).u(5, 4).u(3, 8);
+        write(ofs, other);
+
+        Message x('X', 7, 1200);
+        x.u(7, 8).u(50, 4);
+        write(ofs, x);
+
+        Message u('U', 7, 1300);
+        u.u(2, 8).u(12, 8).u(30, 4).u(5998500, 4);
+        write(ofs, u);
+
+        Message d('D', 7, 1400);
+        d.u(1, 8);
+        write(ofs, d);
+
+        // A hidden execution:
+        Message p('P', 7, 2000);
+        p.u(0, 8).c('B').u(15, 4).s("HSBA").u(6000000, 4).u(4, 8);
+        write(ofs, p);
+    }
+
+    GIVEN("a reader") {
+        Reader reader;
+        reader.Open(path, "HSBA.L");
+
+        THEN("only the messages of the symbol are decoded") {
+            OrderEvent ev;
+            int n = 0;
+
+            while (reader.Next(ev)) {
+                if (n == 0) {
+                    REQUIRE(ev.type == OrderEvent::ADD);
+                    REQUIRE(ev.ref == 1);
+                    REQUIRE(ev.side == 'B');
+                    REQUIRE(ev.shares == 100);
+                    REQUIRE(ev.price == 5999000);
+                    REQUIRE(ev.time == ns(0));
+                }
+
+                n++;
+            }
+
+            REQUIRE(n == 17);
+        }
+    }
+
+    GIVEN("a market depth streamer") {
+        MarketDepth md(path);
+
+        THEN("the book is streamed once complete, then on visible changes") {
+            REQUIRE(md.LoadNext());
+
+            auto& r = md.Record();
+            REQUIRE(r.date == 20170103);
+            REQUIRE(r.time == ns(4));
+            REQUIRE(r.ask_prices[0] == 600.1f);
+            REQUIRE(r.ask_prices[4] == 600.5f);
+            REQUIRE(r.bid_prices[4] == 599.5f);
+            REQUIRE(r.bid_volumes[2] == 300);
+
+            // The deep order is not visible; the executions are, as one
+            // update:
+            REQUIRE(md.NextTime() == ns(1000));
+
+            REQUIRE(md.LoadNext());
+            REQUIRE(md.Record().ask_volumes[0] == 60);
+            REQUIRE(md.Record().bid_volumes[0] == 90);
+
+            REQUIRE(md.LoadNext());
+            REQUIRE(md.Record().time == ns(1200));
+            REQUIRE(md.Record().ask_volumes[1] == 150);
+
+            REQUIRE(md.LoadNext());
+            REQUIRE(md.Record().bid_prices[1] == 599.85f);
+            REQUIRE(md.Record().bid_volumes[1] == 30);
+            REQUIRE(md.Record().bid_prices[4] == 599.5f);
+
+            // The deep order moves up once a level is removed:
+            REQUIRE(not md.LoadNext());
+            REQUIRE(md.Record().time == ns(1400));
+            REQUIRE(md.Record().bid_prices[0] == 599.85f);
+            REQUIRE(md.Record().bid_volumes[0] == 30);
+            REQUIRE(md.Record().bid_prices[4] == 599.0f);
+        }
+    }
+
+    GIVEN("a time and sales streamer") {
+        TimeAndSales tas(path);
+
+        THEN("fills with the same time stamp are aggregated") {
+            REQUIRE(tas.LoadNext());
+
+            auto& r = tas.Record();
+            REQUIRE(r.time == ns(1000));
+            REQUIRE(r.transactions.size() == 2);
+            REQUIRE(r.transactions.at(600.1f) == 40);
+            REQUIRE(r.transactions.at(599.9f) == 10);
+
+            REQUIRE(not tas.LoadNext());
+            REQUIRE(tas.Record().time == ns(2000));
+            REQUIRE(tas.Record().transactions.at(600.0f) == 15);
+        }
+    }
+
+    remove(path.c_str());
+    rmdir((dir + "/HSBA.L").c_str());
+    rmdir(dir.c_str());
+}
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "data/live.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace data::live;
+
+static const int D = 20170103;
+
+static data::MarketDepthRecord depth(long time)
+{
+    data::MarketDepthRecord r;
+    r.date = D;
+    r.time = time;
+
+    for (int l = 0; l < 5; l++) {
+        r.ask_prices[l] = 600.1 + 0.1 * l;
+        r.bid_prices[l] = 599.9 - 0.1 * l;
+        r.ask_volumes[l] = time / 1000 + l;
+        r.bid_volumes[l] = 100 * (l + 1);
+    }
+
+    return r;
+}
+
+static data::TimeAndSalesRecord trades(long time,
+                                      vector<pair<double, long>> tx)
+{
+    data::TimeAndSalesRecord r;
+    r.date = D;
+    r.time = time;
+    for (auto& t : tx)
+        r.transactions[t.first] += t.second;
+
+    return r;
+}
+
+SCENARIO("streaming from a live feed", "[Live]") {
+
+    char tmpl[] = "/tmp/rl_liveXXXXXX";
+    string dir(mkdtemp(tmpl));
+    string path = dir + "/feed";
+
+    mkfifo(path.c_str(), 0600);
+
+    // Opening either end of the FIFO waits for the other:
+    thread publisher([&]() {
+        Publisher p(path);
+
+        p.Send(depth(1000));
+        p.Send(trades(1500, {{600.1, 10}}));
+        p.Send(trades(2000, {{600.1, 5}, {599.9, 7}}));
+        p.Send(depth(2000));
+        p.Send(trades(2500, {{600.2, 1}}));
+        p.Send(depth(3000));
+        p.End();
+    });
+
+    MarketDepth md(path);
+    publisher.join();
+
+    TimeAndSales tas(path);
+
+    THEN("depth updates are streamed in order") {
+        REQUIRE(md.LoadNext());
+        REQUIRE(md.Record().date == D);
+        REQUIRE(md.Record().time == 1000);
+        REQUIRE(md.Record().ask_volumes[0] == 1);
+        REQUIRE(md.Record().bid_prices[4] == Approx(599.5));
+
+        REQUIRE(md.NextTime() == 2000);
+
+        REQUIRE(md.LoadNext());
+        REQUIRE(md.Record().ask_volumes[0] == 2);
+
+        REQUIRE(not md.LoadNext());
+        REQUIRE(md.Record().time == 3000);
+    }
+
+    THEN("trades up to a time are aggregated") {
+        REQUIRE(tas.NextTime() == 1500);
+
+        REQUIRE(tas.LoadUntil(D, 2000));
+
+        auto& r = tas.Record();
+        REQUIRE(r.time == 2000);
+        REQUIRE(r.transactions.size() == 2);
+        REQUIRE(r.transactions.at(600.1) == 15);
+        REQUIRE(r.transactions.at(599.9) == 7);
+
+        REQUIRE(tas.NextTime() == 2500);
+    }
+
+    THEN("the streamers share one connection") {
+        REQUIRE(Feed::Get(path)->Frames() == 6);
+    }
+
+    remove(path.c_str());
+    rmdir(dir.c_str());
+}
@@ -0,0 +1,125 @@
+#include "catch.hpp"
+#include "data/manifest.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace data;
+
+static const string MD_HEADER = "date,time,ap1,ap2,ap3,ap4,ap5,av1,av2,av3,av4,"
+                                "av5,bp1,bp2,bp3,bp4,bp5,bv1,bv2,bv3,bv4,bv5\n";
+static const string MD_ROW = ",600.2,600.3,600.4,600.5,600.6,1,1,1,1,1,"
+                             "600.1,600.0,599.9,599.8,599.7,1,1,1,1,1\n";
+
+static void write_day(const string& dir, const string& symbol, int date,
+                      const vector<string>& times)
+{
+    ofstream md(dir + "/md/" + symbol + "/md_" + to_string(date) + ".csv");
+    md << MD_HEADER;
+
+    for (auto& t : times)
+        md << date << "," << t << MD_ROW;
+
+    ofstream tas(dir + "/tas/" + symbol + "/tas_" + to_string(date) + ".csv");
+    tas << "date,time,price,size\n";
+    tas << date << "," << times.front() << ",600.1,10\n";
+}
+
+SCENARIO("indexing data files", "[Manifest]") {
+
+    char tmpl[] = "/tmp/rl_manifestXXXXXX";
+    string dir(mkdtemp(tmpl));
+
+    vector<string> symbols {"HSBA.L", "VOD.L"};
+    mkdir((dir + "/md").c_str(), 0755);
+    mkdir((dir + "/tas").c_str(), 0755);
+    for (auto& s : symbols) {
+        mkdir((dir + "/md/" + s).c_str(), 0755);
+        mkdir((dir + "/tas/" + s).c_str(), 0755);
+    }
+
+    write_day(dir, "HSBA.L", 20170103,
+              {"07:59:00.000", "08:00:00.000", "12:00:00.000", "16:30:00.000"});
+    write_day(dir, "HSBA.L", 20170104, {"08:00:00.000", "09:00:00.000"});
+    write_day(dir, "VOD.L", 20170103, {"08:00:00.000", "09:00:00.000",
+                                        "10:00:00.000", "11:00:00.000"});
+
+    Manifest manifest;
+    REQUIRE(manifest.Update(dir + "/md", dir + "/tas", symbols, "basic", 2) == 3);
+
+    GIVEN("a scanned universe") {
+        THEN("days are known with their sizes, rows and offsets") {
+            auto days = manifest.Select({"HSBA.L"});
+
+            REQUIRE(days.size() == 2);
+            REQUIRE(days[0].date == 20170103);
+            REQUIRE(days[0].md_rows == 4);
+            REQUIRE(days[0].tas_rows == 1);
+
+            // date,hh:mm:ss.mmm then the levels:
+            long header = MD_HEADER.size(), row = 21 + MD_ROW.size();
+            REQUIRE(days[0].md_bytes == header + 4 * row);
+            REQUIRE(days[0].open_offset == header + row);
+            REQUIRE(days[0].close_offset == header + 3 * row);
+
+            // Still open at the end of the file:
+            REQUIRE(days[1].close_offset == days[1].md_bytes);
+        }
+
+        THEN("only new files are scanned again") {
+            write_day(dir, "HSBA.L", 20170105, {"08:00:00.000"});
+
+            REQUIRE(manifest.Update(dir + "/md", dir + "/tas", {"HSBA.L"}, "basic") == 1);
+            REQUIRE(manifest.Select({"HSBA.L"}).size() == 3);
+            REQUIRE(manifest.Select({"VOD.L"}).size() == 1);
+
+            remove((dir + "/md/HSBA.L/md_20170105.csv").c_str());
+            remove((dir + "/tas/HSBA.L/tas_20170105.csv").c_str());
+        }
+
+        THEN("it is saved and loaded as it was") {
+            string path = dir + "/manifest";
+            manifest.Save(path);
+
+            Manifest loaded;
+            REQUIRE(loaded.Load(path));
+            REQUIRE(loaded.Entries().size() == 3);
+            REQUIRE(loaded.Entries()[2].md_path == manifest.Entries()[2].md_path);
+            REQUIRE(loaded.Entries()[2].open_offset == manifest.Entries()[2].open_offset);
+
+            remove(path.c_str());
+        }
+
+        THEN("held out days are balanced across symbols by rows") {
+            vector<ManifestEntry> train, test;
+            split_balanced(manifest.Select(symbols), 2, train, test);
+
+            // The latest day of each symbol:
+            REQUIRE(test.size() == 2);
+            REQUIRE(test[0].symbol == "HSBA.L");
+            REQUIRE(test[0].date == 20170104);
+            REQUIRE(test[1].symbol == "VOD.L");
+
+            REQUIRE(train.size() == 1);
+            REQUIRE(train[0].date == 20170103);
+        }
+    }
+
+    for (auto& s : symbols) {
+        for (auto& f : {"/md/" + s + "/md_2017010", "/tas/" + s + "/tas_2017010"})
+            for (int d = 3; d <= 4; d++)
+                remove((dir + f + to_string(d) + ".csv").c_str());
+
+        rmdir((dir + "/md/" + s).c_str());
+        rmdir((dir + "/tas/" + s).c_str());
+    }
+
+    rmdir((dir + "/md").c_str());
+    rmdir((dir + "/tas").c_str());
+    rmdir(dir.c_str());
+}
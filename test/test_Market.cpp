@@ -9,7 +9,7 @@ SCENARIO("AAL.L", "[Market]") {
 
     Market* m = Market::make_market("AAL", "L");
 
-    REQUIRE(m->open_time() == 28800000);
+    REQUIRE(m->open_time() == 28800000000000L);
 
     GIVEN("a negative price") {
         THEN("it should throw an exception") {
@@ -80,7 +80,7 @@ SCENARIO("CRDI.MI", "[Market]") {
 
     Market* m = Market::make_market("CRDI", "MI");
 
-    REQUIRE(m->open_time() == 32400000);
+    REQUIRE(m->open_time() == 32400000000000L);
 
     GIVEN("a negative price") {
         THEN("it should throw an exception") {
@@ -0,0 +1,138 @@
+#include "catch.hpp"
+#include "data/reuters.h"
+
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <unistd.h>
+
+using namespace std;
+using namespace data::reuters;
+
+static void write_header(ofstream& ofs)
+{
+    ofs << "#RIC,Date[L],Time[L],GMT Offset,Type,MsgClass/FID Number,"
+        << "UpdateType/Action,FID Name,FID Value,FID Enum String,PE Code,"
+        << "Template Number,Key/Msg Sequence Number,Sequence Number,"
+        << "RIC Source,Number of FIDs\r\n";
+}
+
+static void write_raw(ofstream& ofs, string time, int n_fids)
+{
+    ofs << "HSBA.L,03-JAN-2017," << time << ",+0,Raw,UPDATE,UNSPECIFIED,"
+        << ",,,5557,,,1,," << n_fids << "\r\n";
+}
+
+static void write_fid(ofstream& ofs, string name, string value)
+{
+    ofs << "HSBA.L,,,,FID,0,," << name << "," << value << ",,,,,,,\r\n";
+}
+
+SCENARIO("raw tick history exports", "[Reuters]") {
+
+    char tmpl[] = "/tmp/rl_reutersXXXXXX";
+    string path = string(mkdtemp(tmpl)) + "/raw.csv";
+
+    {
+        ofstream ofs(path);
+        write_header(ofs);
+
+        // Incomplete book: no record until every level is known
+        write_raw(ofs, "08:00:00.000123", 2);
+        write_fid(ofs, "BEST_ASK1", "600.1");
+        write_fid(ofs, "BEST_ASIZ1", "900");
+
+        // Refresh of the remaining levels, with an untracked FID:
+        write_raw(ofs, "08:00:01.500999", 19);
+        write_fid(ofs, "QUOTIM", "08:00:01");
+        for (int l = 2; l <= 5; l++) {
+            write_fid(ofs, "BEST_ASK" + to_string(l), "600." + to_string(l));
+            write_fid(ofs, "BEST_ASIZ" + to_string(l), to_string(100 * l));
+        }
+        for (int l = 1; l <= 5; l++) {
+            write_fid(ofs, "BEST_BID" + to_string(l), "599." + to_string(10 - l));
+            write_fid(ofs, "BEST_BSIZ" + to_string(l), to_string(10 * l));
+        }
+
+        // Two trades sharing a time stamp:
+        write_raw(ofs, "08:00:02.250", 2);
+        write_fid(ofs, "TRDPRC_1", "600.1");
+        write_fid(ofs, "TRDVOL_1", "20");
+        write_raw(ofs, "08:00:02.250", 2);
+        write_fid(ofs, "TRDPRC_1", "600.1");
+        write_fid(ofs, "TRDVOL_1", "5");
+
+        // Delta update of one level (the message claims more FIDs than
+        // it has):
+        write_raw(ofs, "08:00:03.000", 3);
+        write_fid(ofs, "BEST_BSIZ2", "75");
+
+        write_raw(ofs, "08:00:04.000", 2);
+        write_fid(ofs, "TRDPRC_1", "599.9");
+        write_fid(ofs, "TRDVOL_1", "7");
+    }
+
+    GIVEN("a market depth streamer") {
+        MarketDepth md(path);
+
+        THEN("books are streamed once complete, then on every update") {
+            REQUIRE(md.LoadNext());
+
+            auto& r1 = md.Record();
+            REQUIRE(r1.date == 20170103);
+            REQUIRE(r1.time == 28801500999000L);
+            REQUIRE(r1.ask_prices[0] == 600.1f);
+            REQUIRE(r1.ask_prices[4] == 600.5f);
+            REQUIRE(r1.ask_volumes[0] == 900);
+            REQUIRE(r1.bid_prices[0] == 599.9f);
+            REQUIRE(r1.bid_volumes[1] == 20);
+
+            // The last record; nothing follows it:
+            REQUIRE(md.NextTime() == 28803000000000L);
+            REQUIRE(not md.LoadNext());
+
+            auto& r2 = md.Record();
+            REQUIRE(r2.bid_volumes[1] == 75);
+            REQUIRE(r2.bid_volumes[0] == 10);
+            REQUIRE(r2.ask_prices[0] == 600.1f);
+        }
+    }
+
+    GIVEN("a time and sales streamer") {
+        TimeAndSales tas(path);
+
+        THEN("trades at the same time are aggregated") {
+            REQUIRE(tas.LoadNext());
+
+            auto& r1 = tas.Record();
+            REQUIRE(r1.time == 28802250000000L);
+            REQUIRE(r1.transactions.size() == 1);
+            REQUIRE(r1.transactions.at(600.1f) == 25);
+
+            REQUIRE(not tas.LoadNext());
+            REQUIRE(tas.Record().transactions.at(599.9f) == 7);
+        }
+
+        THEN("it can be replayed up to a time") {
+            REQUIRE(tas.LoadUntil(20170103, 28803500000000L));
+            REQUIRE(tas.Record().transactions.at(600.1f) == 25);
+        }
+    }
+
+    GIVEN("the FID table") {
+        THEN("tracked names resolve to their offsets") {
+            REQUIRE(fid_index("BEST_ASK3", 9) == ASK_PRICE + 2);
+            REQUIRE(fid_index("BEST_BSIZ5", 10) == BID_SIZE + 4);
+            REQUIRE(fid_index("TRDVOL_1", 8) == TRADE_VOLUME);
+        }
+
+        THEN("other names are ignored") {
+            REQUIRE(fid_index("BEST_ASK6", 9) == -1);
+            REQUIRE(fid_index("BEST_ASK", 8) == -1);
+            REQUIRE(fid_index("", 0) == -1);
+        }
+    }
+
+    remove(path.c_str());
+    rmdir(path.substr(0, path.rfind('/')).c_str());
+}
@@ -0,0 +1,87 @@
+#include "catch.hpp"
+#include "utilities/config.h"
+#include "environment/intraday.h"
+
+#include "sample_day.h"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+// Exposes the day being replayed and the fills counted so far:
+class SessionDay: public environment::Intraday<>
+{
+    public:
+        using environment::Intraday<>::Intraday;
+
+        int date() { return market->date(); }
+
+        int ask_transactions() const { return trade_stats.ask_transactions; }
+        int bid_transactions() const { return trade_stats.bid_transactions; }
+};
+
+SCENARIO("an episode over a two-day session", "[Sessions]") {
+
+    char tmpl[] = "/tmp/rl_sessionsXXXXXX";
+    string dir(mkdtemp(tmpl));
+
+    string md1_path = dir + "/md_20170104.csv",
+           tas1_path = dir + "/tas_20170104.csv",
+           md2_path = dir + "/md_20170105.csv",
+           tas2_path = dir + "/tas_20170105.csv",
+           config_path = dir + "/config.yaml";
+
+    write_day(md1_path, tas1_path);
+    write_day(md2_path, tas2_path, 30540000, 32400000, "20170105");
+    write_config(config_path, "compact: true");
+
+    Config c(config_path);
+    SessionDay env(c, "HSBA.L", md1_path, tas1_path);
+    env.QueueData(md2_path, tas2_path);
+
+    REQUIRE(env.Initialise());
+
+    int first_date = env.date();
+    int first_ask = 0, first_bid = 0;
+
+    // A fixed action sequence that keeps quoting, crossing and flattening:
+    bool monotone = true;
+    int ask = 0, bid = 0;
+    for (int i = 0; not env.isTerminal(); i++) {
+        if (env.date() == first_date) {
+            first_ask = env.ask_transactions();
+            first_bid = env.bid_transactions();
+        }
+
+        if (not env.performAction((i * 5) % 9))
+            break;
+
+        monotone = monotone and env.ask_transactions() >= ask and
+            env.bid_transactions() >= bid;
+
+        ask = env.ask_transactions();
+        bid = env.bid_transactions();
+    }
+
+    THEN("the second day is reached") {
+        REQUIRE(env.date() != first_date);
+        REQUIRE(first_ask > 0);
+        REQUIRE(first_bid > 0);
+    }
+
+    THEN("the fills of the first day still count on the second") {
+        REQUIRE(monotone);
+
+        REQUIRE(env.ask_transactions() > first_ask);
+        REQUIRE(env.bid_transactions() > first_bid);
+    }
+
+    remove(md1_path.c_str());
+    remove(tas1_path.c_str());
+    remove(md2_path.c_str());
+    remove(tas2_path.c_str());
+    remove(config_path.c_str());
+    rmdir(dir.c_str());
+}
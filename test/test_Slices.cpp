@@ -0,0 +1,87 @@
+#include "catch.hpp"
+#include "utilities/time.h"
+#include "utilities/config.h"
+#include "environment/intraday.h"
+
+#include "sample_day.h"
+
+#include <set>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+// Exposes the slice an episode was given:
+class SlicedDay: public environment::Intraday<>
+{
+    public:
+        using environment::Intraday<>::Intraday;
+
+        long start() const { return slice_start_; }
+        long end() const { return slice_end_; }
+
+        long now() { return market->time(); }
+        long open() { return market->open_time(); }
+        long close() { return market->close_time(); }
+};
+
+SCENARIO("episodes over random slices of a day", "[Slices]") {
+
+    char tmpl[] = "/tmp/rl_slicesXXXXXX";
+    string dir(mkdtemp(tmpl));
+
+    string md_path = dir + "/md_20170104.csv",
+           tas_path = dir + "/tas_20170104.csv",
+           config_path = dir + "/config.yaml";
+
+    // From just before the open until 09:30:
+    write_day(md_path, tas_path, 28740000, 34200000);
+    write_config(config_path, "slice: {minutes: 5}");
+
+    const long length = add_minutes(5, 0),
+               last = add_millis(34200000, 0);
+
+    Config c(config_path);
+    SlicedDay env(c, "HSBA.L", md_path, tas_path);
+
+    set<long> starts;
+    for (int e = 0; e < 5; e++) {
+        if (e > 0) env.LoadData("HSBA.L", md_path, tas_path);
+
+        REQUIRE(env.Initialise());
+
+        long start = env.start();
+        starts.insert(start);
+
+        // On a second, leaving room for the whole slice in trading hours:
+        REQUIRE(start % NS_PER_S == 0);
+
+        REQUIRE(start >= add_minutes(30, env.open()));
+        REQUIRE(start <= add_minutes(-30, env.close()) - length);
+        REQUIRE(start <= last - length);
+
+        REQUIRE(env.end() >= start + length);
+
+        // A fixed action sequence until the episode ends:
+        bool before_end = true;
+        for (int i = 0; not env.isTerminal(); i++) {
+            before_end = before_end and env.now() < env.end();
+
+            if (not env.performAction((i * 5) % 9))
+                break;
+        }
+
+        // Decisions are taken until the end of the slice, and no further:
+        REQUIRE(before_end);
+        REQUIRE(env.now() >= env.end());
+    }
+
+    // Slices are drawn at random:
+    REQUIRE(starts.size() > 1);
+
+    remove(md_path.c_str());
+    remove(tas_path.c_str());
+    remove(config_path.c_str());
+    rmdir(dir.c_str());
+}
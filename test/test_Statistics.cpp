@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include "environment/statistics.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace environment;
+
+SCENARIO("per-step samples split across two accumulators", "[Statistics]") {
+
+    default_random_engine eng(42);
+    normal_distribution<double> dist(0.5, 3.0);
+
+    vector<double> xs(20000);
+    for (auto& x : xs) x = dist(eng);
+
+    // Exact zeros exercise the sketch's zero bucket:
+    for (size_t i = 0; i < xs.size(); i += 10) xs[i] = 0.0;
+
+    Distribution all, a, b;
+    for (size_t i = 0; i < xs.size(); i++) {
+        all.push(xs[i]);
+        (i % 3 ? a : b).push(xs[i]);
+    }
+
+    a.merge(b);
+
+    GIVEN("the merged accumulator") {
+        THEN("its moments match a single pass") {
+            REQUIRE(a.moments.n == all.moments.n);
+            REQUIRE(a.moments.mean == Approx(all.moments.mean));
+            REQUIRE(a.moments.variance() == Approx(all.moments.variance()));
+            REQUIRE(a.moments.min == all.moments.min);
+            REQUIRE(a.moments.max == all.moments.max);
+        }
+
+        THEN("its quantiles match a single pass") {
+            for (double q : {0.01, 0.25, 0.5, 0.75, 0.99})
+                REQUIRE(a.sketch.quantile(q) == all.sketch.quantile(q));
+        }
+    }
+
+    GIVEN("the exact quantiles") {
+        sort(xs.begin(), xs.end());
+
+        THEN("the sketch is within its relative error bound") {
+            double bound = 1.0 / (2 * QuantileSketch::SUB_BUCKETS);
+
+            for (double q : {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99}) {
+                double exact = xs[(size_t) (q * (xs.size() - 1))];
+
+                REQUIRE(abs(all.sketch.quantile(q) - exact) <=
+                        bound * abs(exact) + 1e-12);
+            }
+        }
+    }
+}
+
+SCENARIO("episode statistics merged into an experiment", "[Statistics]") {
+
+    Statistics experiment, episode;
+
+    episode.episodes = 1;
+    episode.totals.pnl = 2.5;
+    episode.trades.ask_transactions = 3;
+    episode.ticks.total_ticks = 10;
+    episode.steps.inventory.push(1.0);
+
+    experiment.merge(episode);
+    experiment.merge(episode);
+
+    REQUIRE(experiment.episodes == 2);
+    REQUIRE(experiment.totals.pnl == Approx(5.0));
+    REQUIRE(experiment.trades.ask_transactions == 6);
+    REQUIRE(experiment.ticks.total_ticks == 20);
+    REQUIRE(experiment.steps.inventory.moments.n == 2);
+    REQUIRE(experiment.steps.inventory.sketch.count() == 2);
+}
@@ -0,0 +1,155 @@
+#include "catch.hpp"
+#include "rl/state.h"
+#include "rl/tiles.h"
+#include "rl/tile_coder.h"
+
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace rl;
+
+static const tile_coder::ISA ISAS[] = {
+    tile_coder::ISA::SCALAR, tile_coder::ISA::AVX2, tile_coder::ISA::AVX512
+};
+
+SCENARIO("vectorised tile coding", "[TileCoder]") {
+
+    mt19937 rng(7);
+    uniform_real_distribution<float> var(-50.0f, 50.0f);
+    uniform_int_distribution<int> h(-100000, 100000);
+
+    vector<float> floats(10);
+    vector<int> ints(3);
+    vector<int> expected(64), actual(64);
+
+    for (auto isa : ISAS) {
+        if (not tile_coder::supported(isa))
+            continue;
+
+        GIVEN(string("the ") + tile_coder::name(isa) + " coder") {
+            THEN("the indices are those of ::tiles()") {
+                for (int nt : {1, 4, 8, 12, 16, 32, 64}) {
+                    for (int nf = 0; nf <= 10; nf++) {
+                        for (int ni = 0; ni <= 3; ni++) {
+                            for (int trial = 0; trial < 20; trial++) {
+                                for (auto& f : floats) f = var(rng);
+                                for (auto& i : ints) i = h(rng);
+
+                                // Small enough to wrap, or not at all:
+                                int m = (trial % 2 == 0) ? 1000003 : 1 << 30;
+
+                                ::tiles(expected.data(), nt, m, floats.data(),
+                                        nf, ints.data(), ni);
+                                tile_coder::tiles(isa, actual.data(), nt, m,
+                                                  floats.data(), nf,
+                                                  ints.data(), ni);
+
+                                for (int j = 0; j < nt; j++)
+                                    REQUIRE(actual[j] == expected[j]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("state features for every action", "[TileCoder][State]") {
+
+    const int M = 1000003, NT = 16, NA = 9;
+
+    vector<float> vars {0.3f, -1.7f, 2.25f, 5.1f, -0.05f, 7.0f};
+
+    GIVEN("compatible hashing") {
+        State s(M, NA, NT);
+        s.newState(vars);
+
+        THEN("the features are those of ::tiles() for each group") {
+            vector<int> expected(NT);
+
+            for (int a = 0; a < NA; a++) {
+                REQUIRE(s.nFeatures() == 3*NT);
+                vector<int> f(s.getFeatures(a), s.getFeatures(a) + 3*NT);
+
+                ::tiles(expected.data(), NT, M, &vars[0], 3, a);
+                REQUIRE(vector<int>(f.begin(), f.begin() + NT) == expected);
+
+                ::tiles(expected.data(), NT, M, &vars[3], 3, NA + a);
+                REQUIRE(vector<int>(f.begin() + NT, f.begin() + 2*NT) ==
+                        expected);
+
+                ::tiles(expected.data(), NT, M, &vars[0], 6, 2*NA + a);
+                REQUIRE(vector<int>(f.begin() + 2*NT, f.end()) == expected);
+            }
+        }
+    }
+
+    GIVEN("fast hashing") {
+        State s(M, NA, NT, true);
+        s.newState(vars);
+
+        THEN("the features are in memory and differ between actions") {
+            for (int a = 0; a < NA; a++)
+                for (int i = 0; i < 3*NT; i++)
+                    REQUIRE((s.getFeatures(a)[i] >= 0 and
+                             s.getFeatures(a)[i] < M));
+
+            REQUIRE(not equal(s.getFeatures(0), s.getFeatures(0) + 3*NT,
+                              s.getFeatures(1)));
+        }
+    }
+}
+
+// Hidden; run with "[benchmark]":
+TEST_CASE("tile coding throughput", "[.][benchmark][TileCoder]") {
+
+    const int N = 200000, NT = 32, M = 1 << 20;
+
+    mt19937 rng(7);
+    uniform_real_distribution<float> var(-5.0f, 5.0f);
+
+    vector<float> states(N * 8);
+    for (auto& f : states) f = var(rng);
+
+    vector<int> out(NT);
+    int a = 1;
+
+    auto rate = [&](function<void(const float*)> f) {
+        auto start = chrono::steady_clock::now();
+        for (int n = 0; n < N; n++)
+            f(&states[n * 8]);
+        chrono::duration<double> dt = chrono::steady_clock::now() - start;
+
+        return (double) N * NT / dt.count();
+    };
+
+    cout << "::tiles: " << rate([&](const float* s) {
+        ::tiles(out.data(), NT, M, (float*) s, 8, &a, 1);
+    }) << " tiles/s" << endl;
+
+    for (auto isa : ISAS) {
+        if (not tile_coder::supported(isa))
+            continue;
+
+        cout << tile_coder::name(isa) << ": " << rate([&](const float* s) {
+            tile_coder::tiles(isa, out.data(), NT, M, s, 8, &a, 1);
+        }) << " tiles/s" << endl;
+    }
+
+    // Nine actions in three groups, coded once per state:
+    for (bool fast : {false, true}) {
+        State state(M, 9, NT, fast);
+        vector<float> vars(8);
+
+        cout << (fast ? "state (fast): " : "state: ") << rate([&](const float* s) {
+            vars.assign(s, s + 8);
+            state.newState(vars);
+        }) * 27 << " tiles/s" << endl;
+    }
+}
@@ -0,0 +1,90 @@
+#include "catch.hpp"
+#include "rl/traces.h"
+
+#include <map>
+#include <cmath>
+#include <random>
+
+using namespace std;
+using namespace rl;
+
+SCENARIO("lazily decayed traces", "[Traces]") {
+
+    mt19937 rng(11);
+    uniform_int_distribution<int> feature(0, 5000), op(0, 9);
+    uniform_real_distribution<float> rate(0.5f, 0.99f);
+
+    Traces traces(32, 9);
+
+    // The traces, decayed eagerly:
+    map<int, double> expected;
+
+    GIVEN("sets, clears and decays") {
+        for (int step = 0; step < 20000; step++) {
+            int f = feature(rng);
+
+            switch (op(rng)) {
+                case 0:
+                    traces.clear(f);
+                    expected.erase(f);
+                    break;
+
+                case 1: {
+                    float r = rate(rng);
+
+                    traces.decay(r);
+                    for (auto& e : expected) e.second *= r;
+                    break;
+                }
+
+                case 2:
+                    if (step % 1000 == 0) {
+                        traces.decay(0.0f);
+                        expected.clear();
+                    }
+                    break;
+
+                default:
+                    traces.set(f, 1.0f);
+                    expected[f] = 1.0;
+            }
+        }
+
+        THEN("each trace has its decayed value") {
+            for (int f = 0; f <= 5000; f++) {
+                auto it = expected.find(f);
+                double e = (it == expected.end()) ? 0.0 : it->second;
+
+                REQUIRE(traces.get(f) ==
+                        Approx(e).epsilon(1e-5).margin(1e-9));
+            }
+        }
+
+        THEN("a reset leaves no trace behind") {
+            traces.decay(0.0f);
+            REQUIRE(traces.size() == 0);
+
+            for (int f = 0; f <= 5000; f += 3) traces.set(f, 0.5f);
+
+            for (int f = 0; f <= 5000; f++)
+                REQUIRE(traces.get(f) == (f % 3 == 0 ? 0.5f : 0.0f));
+        }
+
+        THEN("pruning leaves those above tolerance") {
+            traces.prune();
+
+            int n = 0;
+            for (auto& e : expected) n += (e.second >= 0.01);
+
+            REQUIRE(traces.size() == n);
+
+            for (int k = 0; k < traces.size(); k++) {
+                int f = traces.getFeatures()[k];
+                double v = traces.getValues()[k] * traces.getScale();
+
+                REQUIRE(expected.count(f) == 1);
+                REQUIRE(v == Approx(expected[f]).epsilon(1e-5));
+            }
+        }
+    }
+}